@@ -0,0 +1,236 @@
+global avx512
+section .text
+avx512:
+        ; Same waves as avx.asm on 16-float zmm vectors. Needs a, b and c
+        ; 64-byte aligned. zmm16-zmm31 and k1-k7 are caller-saved in the
+        ; SysV ABI, so nothing needs saving beyond the frame.
+        push rbp
+        mov rbp, rsp
+
+        ; Initialize all 32 ZMM registers with different patterns to prevent optimization
+        vmovaps zmm0, [rdi]
+        vmovaps zmm1, [rsi]
+        vmovaps zmm2, [rdx]
+
+        vbroadcastss zmm3, dword [rdi]
+        vbroadcastss zmm4, dword [rsi+4]
+        vbroadcastss zmm5, dword [rdx+8]
+        vbroadcastss zmm6, dword [rdi+12]
+        vbroadcastss zmm7, dword [rsi+16]
+        vbroadcastss zmm8, dword [rdx+20]
+        vbroadcastss zmm9, dword [rdi+24]
+        vbroadcastss zmm10, dword [rsi+28]
+        vbroadcastss zmm11, dword [rdx+32]
+        vbroadcastss zmm12, dword [rdi+36]
+        vbroadcastss zmm13, dword [rsi+40]
+        vbroadcastss zmm14, dword [rdx+44]
+        vbroadcastss zmm15, dword [rdi+48]
+
+        ; Upper bank: the extra 16 registers EVEX encodes
+        vbroadcastss zmm16, dword [rsi+52]
+        vbroadcastss zmm17, dword [rdx+56]
+        vbroadcastss zmm18, dword [rdi+60]
+        vbroadcastss zmm19, dword [rsi]
+        vbroadcastss zmm20, dword [rdx+4]
+        vbroadcastss zmm21, dword [rdi+8]
+        vbroadcastss zmm22, dword [rsi+12]
+        vbroadcastss zmm23, dword [rdx+16]
+        vmovaps zmm24, zmm0
+        vmovaps zmm25, zmm1
+        vmovaps zmm26, zmm2
+        vmovaps zmm27, zmm3
+        vmovaps zmm28, zmm4
+        vmovaps zmm29, zmm5
+        vmovaps zmm30, zmm6
+        vmovaps zmm31, zmm7
+
+        ; Opmasks for the masked waves: odd lanes, even lanes, low half
+        mov ecx, 0xAAAA
+        kmovw k1, ecx
+        mov ecx, 0x5555
+        kmovw k2, ecx
+        mov ecx, 0x00FF
+        kmovw k3, ecx
+
+        mov rax, 128
+
+loop:
+        ; === WAVE 1: Maximum FMA dependency hell ===
+        vfmadd132ps zmm0, zmm15, zmm14
+        vfmadd132ps zmm1, zmm0, zmm13
+        vfmadd132ps zmm2, zmm1, zmm12
+        vfmadd132ps zmm3, zmm2, zmm11
+        vfmadd132ps zmm4, zmm3, zmm10
+        vfmadd132ps zmm5, zmm4, zmm9
+        vfmadd132ps zmm6, zmm5, zmm8
+        vfmadd132ps zmm7, zmm6, zmm7
+
+        ; === WAVE 2: Lane shuffles + FMA ===
+        vshuff32x4 zmm8, zmm0, zmm1, 0x44
+        vshuff32x4 zmm9, zmm2, zmm3, 0xEE
+        vshuff32x4 zmm10, zmm4, zmm5, 0x4E
+        vshuff32x4 zmm11, zmm6, zmm7, 0xB1
+        vshufps zmm12, zmm8, zmm9, 0x88
+        vshufps zmm13, zmm10, zmm11, 0xDD
+        vfmadd231ps zmm14, zmm12, zmm13
+        vfmsub231ps zmm15, zmm8, zmm9
+
+        ; === WAVE 3: Transcendental function torture ===
+        ; 14-bit estimates, the EVEX forms of rcpps/rsqrtps
+        vrcp14ps zmm0, zmm14
+        vrcp14ps zmm1, zmm15
+        vrcp14ps zmm2, zmm0
+        vrcp14ps zmm3, zmm1
+
+        vrsqrt14ps zmm4, zmm2
+        vrsqrt14ps zmm5, zmm3
+        vrsqrt14ps zmm6, zmm4
+        vrsqrt14ps zmm7, zmm5
+
+        ; Newton-Raphson refinement
+        vmulps zmm8, zmm0, zmm0
+        vmulps zmm9, zmm8, zmm14
+        vsubps zmm10, zmm9, zmm1
+        vmulps zmm11, zmm10, zmm0
+
+        ; === WAVE 4: Division hell ===
+        vdivps zmm12, zmm11, zmm6
+        vdivps zmm13, zmm7, zmm12
+        vdivps zmm14, zmm4, zmm13
+        vdivps zmm15, zmm5, zmm14
+        vdivps zmm0, zmm15, zmm8
+        vdivps zmm1, zmm0, zmm9
+        vdivps zmm2, zmm1, zmm10
+        vdivps zmm3, zmm2, zmm11
+
+        ; === WAVE 5: Mixed precision torture ===
+        vcvtps2pd zmm4, ymm3
+        vcvtpd2ps ymm5, zmm4
+        vinsertf64x4 zmm6, zmm6, ymm5, 1
+
+        ; === WAVE 6: Index patterns ===
+        vpternlogd zmm7, zmm7, zmm7, 0xFF   ; All 1s
+        vpsrld zmm8, zmm7, 25
+        vpslld zmm9, zmm8, 2
+
+        ; === WAVE 7: Blend torture with opmasks ===
+        vblendmps zmm10{k1}, zmm0, zmm1
+        vblendmps zmm11{k2}, zmm2, zmm3
+        vblendmps zmm12{k3}, zmm4, zmm6
+        kxorw k4, k1, k3
+        vblendmps zmm13{k4}, zmm10, zmm11
+        vblendmps zmm14{k1}, zmm12, zmm13
+        vblendmps zmm15{k2}, zmm14, zmm0
+
+        ; === WAVE 8: Maximum FMA saturation, half of it masked ===
+        vfmadd132ps zmm0, zmm15, zmm14
+        vfmadd213ps zmm1{k1}, zmm0, zmm13
+        vfmadd231ps zmm2, zmm1, zmm12
+        vfmsub132ps zmm3{k2}, zmm2, zmm11
+        vfmsub213ps zmm4, zmm3, zmm10
+        vfmsub231ps zmm5{k3}, zmm4, zmm9
+        vfnmadd132ps zmm6, zmm5, zmm8
+        vfnmadd213ps zmm7{k1}{z}, zmm6, zmm7
+        vfnmadd231ps zmm8, zmm7, zmm6
+        vfnmsub132ps zmm9{k2}{z}, zmm8, zmm5
+        vfnmsub213ps zmm10, zmm9, zmm4
+        vfnmsub231ps zmm11{k3}, zmm10, zmm3
+
+        ; === WAVE 9: Alternating add/sub ===
+        vfmaddsub132ps zmm12, zmm11, zmm2
+        vfmsubadd132ps zmm13, zmm12, zmm1
+        vfmaddsub213ps zmm14, zmm13, zmm0
+        vfmsubadd213ps zmm15, zmm14, zmm15
+
+        ; === WAVE 10: Comparison hell, into opmask registers ===
+        vcmpps k4, zmm12, zmm13, 0x01   ; LT
+        vcmpps k5, zmm14, zmm15, 0x02   ; LE
+        vcmpps k6{k4}, zmm0, zmm1, 0x04 ; NE, only where LT held
+        vcmpps k7, zmm2, zmm12, 0x05    ; NLT
+
+        vblendmps zmm4{k4}, zmm13, zmm14
+        vblendmps zmm5{k5}, zmm15, zmm12
+        vblendmps zmm6{k6}, zmm4, zmm5
+        vblendmps zmm7{k7}, zmm6, zmm3
+
+        ; === WAVE 11: Exponential computation approximation ===
+        vmovaps zmm8, zmm7
+        vmulps zmm9, zmm8, zmm8
+        vmulps zmm10, zmm9, zmm8
+        vmulps zmm11, zmm10, zmm8
+        vmulps zmm12, zmm11, zmm8
+
+        vfmadd231ps zmm13, zmm8, [rdi]
+        vfmadd231ps zmm13, zmm9, [rsi]
+        vfmadd231ps zmm13, zmm10, [rdx]
+        vfmadd231ps zmm13, zmm11, [rdi]
+        vfmadd231ps zmm13, zmm12, [rsi]
+
+        ; Scale the polynomial by 2^floor(x), as an exp() reduction would
+        vscalefps zmm13, zmm13, zmm8
+        vscalefps zmm12{k1}, zmm12, zmm9
+
+        ; === WAVE 12: Final torture with maximum register pressure ===
+        vfmadd132ps zmm14, zmm13, zmm12
+        vfmsub132ps zmm15, zmm14, zmm11
+        vfnmadd132ps zmm0, zmm15, zmm10
+        vfnmsub132ps zmm1, zmm0, zmm9
+        vmulps zmm2, zmm1, zmm8
+        vdivps zmm3, zmm2, zmm7
+        vrcp14ps zmm4, zmm3
+        vsqrtps zmm5, zmm4
+
+        vaddps zmm6, zmm5, zmm0
+        vmulps zmm7, zmm6, zmm1
+        vsubps zmm8, zmm7, zmm2
+        vdivps zmm9, zmm8, zmm3
+
+        vmovaps zmm10, zmm9
+        vaddps zmm11, zmm10, zmm4
+        vmulps zmm12, zmm11, zmm5
+
+        ; === WAVE 13: Upper bank, 16 independent masked FMA chains ===
+        ; Keeps both FMA ports busy while the waves above stall on divides
+        vfmadd231ps zmm16{k1}, zmm24, zmm12
+        vfmadd231ps zmm17{k2}, zmm25, zmm11
+        vfmadd231ps zmm18{k3}, zmm26, zmm10
+        vfmadd231ps zmm19, zmm27, zmm9
+        vfmadd231ps zmm20{k1}, zmm28, zmm8
+        vfmadd231ps zmm21{k2}, zmm29, zmm7
+        vfmadd231ps zmm22{k3}, zmm30, zmm6
+        vfmadd231ps zmm23, zmm31, zmm5
+        vfnmadd231ps zmm24{k1}, zmm16, zmm20
+        vfnmadd231ps zmm25{k2}, zmm17, zmm21
+        vfnmadd231ps zmm26{k3}, zmm18, zmm22
+        vfnmadd231ps zmm27, zmm19, zmm23
+        vfmsub231ps zmm28{k1}, zmm20, zmm16
+        vfmsub231ps zmm29{k2}, zmm21, zmm17
+        vfmsub231ps zmm30{k3}, zmm22, zmm18
+        vfmsub231ps zmm31, zmm23, zmm19
+
+        ; Rescale by 2^floor(x), then pull the chains back into [1, 2) so
+        ; they neither overflow nor flush to zero
+        vscalefps zmm16, zmm16, zmm25
+        vscalefps zmm20, zmm20, zmm29
+        vgetmantps zmm16, zmm16, 0x00
+        vgetmantps zmm20, zmm20, 0x00
+        vgetmantps zmm24, zmm24, 0x00
+        vgetmantps zmm28, zmm28, 0x00
+        vgetmantps zmm27, zmm27, 0x00
+        vgetmantps zmm31, zmm31, 0x00
+
+        dec rax
+        jnz loop
+
+        ; Prevent compiler optimization by using results
+        vaddps zmm0, zmm12, zmm0
+        vaddps zmm16, zmm16, zmm24
+        vaddps zmm20, zmm20, zmm28
+        vaddps zmm0, zmm0, zmm16
+        vaddps zmm0, zmm0, zmm20
+        vmovaps [rdi], zmm0
+
+        ; Leave no dirty upper state behind for SSE code in the caller
+        vzeroupper
+        pop rbp
+        ret
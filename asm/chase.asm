@@ -0,0 +1,34 @@
+section .text
+global pointerChase
+
+; Load-to-use latency: follows a chain of pointers, each load's address being
+; the value the previous load returned, so no two loads overlap and each one
+; pays the full latency of wherever its line is (L1, L2, L3 or DRAM). The
+; caller builds the chain; the pointer it ends on is returned so the next
+; call carries on from there.
+;
+;   void* pointerChase(void* node, unsigned long steps)
+;
+; 16 loads per step, steps > 0.
+pointerChase:
+        mov rax, rdi
+.loop:
+        mov rax, [rax]
+        mov rax, [rax]
+        mov rax, [rax]
+        mov rax, [rax]
+        mov rax, [rax]
+        mov rax, [rax]
+        mov rax, [rax]
+        mov rax, [rax]
+        mov rax, [rax]
+        mov rax, [rax]
+        mov rax, [rax]
+        mov rax, [rax]
+        mov rax, [rax]
+        mov rax, [rax]
+        mov rax, [rax]
+        mov rax, [rax]
+        dec rsi
+        jnz .loop
+        ret
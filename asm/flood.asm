@@ -3,6 +3,8 @@ global floodL1L2, floodMemory, rowhammerAttack, floodNt
 
 ; Intensive L1/L2 cache flooding with multiple access patterns
 floodL1L2:
+    push r12                ; callee-saved, clobbered below
+    push r13
     mov rcx, [rsi]            ; iterations count (second argument)
     mov r8, rdi             ; save original buffer pointer
     lea r9, [rdi + rdx]     ; end pointer
@@ -56,10 +58,14 @@ floodL1L2:
     dec rcx
     jnz .cacheLoop
 
+    pop r13
+    pop r12
     ret
 
 ; Intensive memory flooding with multiple access patterns
 floodMemory:
+    push r12                ; callee-saved, clobbered below
+    push r13
     mov rcx, [rsi]            ; iterations count
     mov r8, rdi             ; save original pointer
     lea r9, [rdi + rdx]     ; end pointer
@@ -115,10 +121,13 @@ floodMemory:
     dec rcx
     jnz .memoryLoop
 
+    pop r13
+    pop r12
     ret
 
 ; Aggressive rowhammer with multiple targets and patterns
 rowhammerAttack:
+    push r12                ; callee-saved, clobbered below
     mov rcx, [rsi]            ; iterations count
     mov r8, rdx             ; buffer_size
     shr r8, 2               ; Quarter buffer for multiple targets
@@ -170,10 +179,13 @@ rowhammerAttack:
     dec rcx
     jnz .rhLoop
 
+    pop r12
     ret
 
 ; Intensive non-temporal flooding with streaming patterns
 floodNt:
+    push r12                ; callee-saved, clobbered below
+    push r13
     mov rcx, [rsi]            ; iterations count
     mov r8, rdi             ; save original pointer
     lea r9, [rdi + rdx]     ; end pointer
@@ -231,4 +243,6 @@ floodNt:
     dec rcx
     jnz .ntLoop
 
+    pop r13
+    pop r12
     ret
\ No newline at end of file
@@ -0,0 +1,290 @@
+section .text
+global flopsFma256Ps, flopsFma256Pd, flopsFma512Ps, flopsFma512Pd
+
+; Peak FLOPS kernels: acc = acc * m + a on independent accumulators, so
+; nothing waits on a result and both FMA pipes issue every cycle. With
+; 0 < m < 1 every accumulator converges to a / (1 - m), so the values stay
+; normal however long it runs.
+;
+;   void flopsFma<bits><Ps|Pd>(void* acc, const void* coef, unsigned long steps)
+;
+; acc holds the accumulators (12 ymm or 24 zmm, aligned to the vector),
+; loaded once and stored back at the end; coef is {m, a} as two floats or
+; doubles. FMA latency is 4-5 cycles, so 2 pipes need 8-10 chains in
+; flight: 12 with 16 ymm registers, 24 with the 32 zmm registers.
+
+; 12 x 8 floats, 192 FLOPs per step
+flopsFma256Ps:
+    vbroadcastss ymm12, dword [rsi]    ; m
+    vbroadcastss ymm13, dword [rsi + 4]    ; a
+    vmovaps ymm0, [rdi + 0]
+    vmovaps ymm1, [rdi + 32]
+    vmovaps ymm2, [rdi + 64]
+    vmovaps ymm3, [rdi + 96]
+    vmovaps ymm4, [rdi + 128]
+    vmovaps ymm5, [rdi + 160]
+    vmovaps ymm6, [rdi + 192]
+    vmovaps ymm7, [rdi + 224]
+    vmovaps ymm8, [rdi + 256]
+    vmovaps ymm9, [rdi + 288]
+    vmovaps ymm10, [rdi + 320]
+    vmovaps ymm11, [rdi + 352]
+    test rdx, rdx
+    jz .store
+
+.loop:
+    vfmadd213ps ymm0, ymm12, ymm13
+    vfmadd213ps ymm1, ymm12, ymm13
+    vfmadd213ps ymm2, ymm12, ymm13
+    vfmadd213ps ymm3, ymm12, ymm13
+    vfmadd213ps ymm4, ymm12, ymm13
+    vfmadd213ps ymm5, ymm12, ymm13
+    vfmadd213ps ymm6, ymm12, ymm13
+    vfmadd213ps ymm7, ymm12, ymm13
+    vfmadd213ps ymm8, ymm12, ymm13
+    vfmadd213ps ymm9, ymm12, ymm13
+    vfmadd213ps ymm10, ymm12, ymm13
+    vfmadd213ps ymm11, ymm12, ymm13
+    dec rdx
+    jnz .loop
+
+.store:
+    vmovaps [rdi + 0], ymm0
+    vmovaps [rdi + 32], ymm1
+    vmovaps [rdi + 64], ymm2
+    vmovaps [rdi + 96], ymm3
+    vmovaps [rdi + 128], ymm4
+    vmovaps [rdi + 160], ymm5
+    vmovaps [rdi + 192], ymm6
+    vmovaps [rdi + 224], ymm7
+    vmovaps [rdi + 256], ymm8
+    vmovaps [rdi + 288], ymm9
+    vmovaps [rdi + 320], ymm10
+    vmovaps [rdi + 352], ymm11
+    vzeroupper
+    ret
+
+; 12 x 4 doubles, 96 FLOPs per step
+flopsFma256Pd:
+    vbroadcastsd ymm12, qword [rsi]    ; m
+    vbroadcastsd ymm13, qword [rsi + 8]    ; a
+    vmovapd ymm0, [rdi + 0]
+    vmovapd ymm1, [rdi + 32]
+    vmovapd ymm2, [rdi + 64]
+    vmovapd ymm3, [rdi + 96]
+    vmovapd ymm4, [rdi + 128]
+    vmovapd ymm5, [rdi + 160]
+    vmovapd ymm6, [rdi + 192]
+    vmovapd ymm7, [rdi + 224]
+    vmovapd ymm8, [rdi + 256]
+    vmovapd ymm9, [rdi + 288]
+    vmovapd ymm10, [rdi + 320]
+    vmovapd ymm11, [rdi + 352]
+    test rdx, rdx
+    jz .store
+
+.loop:
+    vfmadd213pd ymm0, ymm12, ymm13
+    vfmadd213pd ymm1, ymm12, ymm13
+    vfmadd213pd ymm2, ymm12, ymm13
+    vfmadd213pd ymm3, ymm12, ymm13
+    vfmadd213pd ymm4, ymm12, ymm13
+    vfmadd213pd ymm5, ymm12, ymm13
+    vfmadd213pd ymm6, ymm12, ymm13
+    vfmadd213pd ymm7, ymm12, ymm13
+    vfmadd213pd ymm8, ymm12, ymm13
+    vfmadd213pd ymm9, ymm12, ymm13
+    vfmadd213pd ymm10, ymm12, ymm13
+    vfmadd213pd ymm11, ymm12, ymm13
+    dec rdx
+    jnz .loop
+
+.store:
+    vmovapd [rdi + 0], ymm0
+    vmovapd [rdi + 32], ymm1
+    vmovapd [rdi + 64], ymm2
+    vmovapd [rdi + 96], ymm3
+    vmovapd [rdi + 128], ymm4
+    vmovapd [rdi + 160], ymm5
+    vmovapd [rdi + 192], ymm6
+    vmovapd [rdi + 224], ymm7
+    vmovapd [rdi + 256], ymm8
+    vmovapd [rdi + 288], ymm9
+    vmovapd [rdi + 320], ymm10
+    vmovapd [rdi + 352], ymm11
+    vzeroupper
+    ret
+
+; 24 x 16 floats, 768 FLOPs per step
+flopsFma512Ps:
+    vbroadcastss zmm24, dword [rsi]    ; m
+    vbroadcastss zmm25, dword [rsi + 4]    ; a
+    vmovaps zmm0, [rdi + 0]
+    vmovaps zmm1, [rdi + 64]
+    vmovaps zmm2, [rdi + 128]
+    vmovaps zmm3, [rdi + 192]
+    vmovaps zmm4, [rdi + 256]
+    vmovaps zmm5, [rdi + 320]
+    vmovaps zmm6, [rdi + 384]
+    vmovaps zmm7, [rdi + 448]
+    vmovaps zmm8, [rdi + 512]
+    vmovaps zmm9, [rdi + 576]
+    vmovaps zmm10, [rdi + 640]
+    vmovaps zmm11, [rdi + 704]
+    vmovaps zmm12, [rdi + 768]
+    vmovaps zmm13, [rdi + 832]
+    vmovaps zmm14, [rdi + 896]
+    vmovaps zmm15, [rdi + 960]
+    vmovaps zmm16, [rdi + 1024]
+    vmovaps zmm17, [rdi + 1088]
+    vmovaps zmm18, [rdi + 1152]
+    vmovaps zmm19, [rdi + 1216]
+    vmovaps zmm20, [rdi + 1280]
+    vmovaps zmm21, [rdi + 1344]
+    vmovaps zmm22, [rdi + 1408]
+    vmovaps zmm23, [rdi + 1472]
+    test rdx, rdx
+    jz .store
+
+.loop:
+    vfmadd213ps zmm0, zmm24, zmm25
+    vfmadd213ps zmm1, zmm24, zmm25
+    vfmadd213ps zmm2, zmm24, zmm25
+    vfmadd213ps zmm3, zmm24, zmm25
+    vfmadd213ps zmm4, zmm24, zmm25
+    vfmadd213ps zmm5, zmm24, zmm25
+    vfmadd213ps zmm6, zmm24, zmm25
+    vfmadd213ps zmm7, zmm24, zmm25
+    vfmadd213ps zmm8, zmm24, zmm25
+    vfmadd213ps zmm9, zmm24, zmm25
+    vfmadd213ps zmm10, zmm24, zmm25
+    vfmadd213ps zmm11, zmm24, zmm25
+    vfmadd213ps zmm12, zmm24, zmm25
+    vfmadd213ps zmm13, zmm24, zmm25
+    vfmadd213ps zmm14, zmm24, zmm25
+    vfmadd213ps zmm15, zmm24, zmm25
+    vfmadd213ps zmm16, zmm24, zmm25
+    vfmadd213ps zmm17, zmm24, zmm25
+    vfmadd213ps zmm18, zmm24, zmm25
+    vfmadd213ps zmm19, zmm24, zmm25
+    vfmadd213ps zmm20, zmm24, zmm25
+    vfmadd213ps zmm21, zmm24, zmm25
+    vfmadd213ps zmm22, zmm24, zmm25
+    vfmadd213ps zmm23, zmm24, zmm25
+    dec rdx
+    jnz .loop
+
+.store:
+    vmovaps [rdi + 0], zmm0
+    vmovaps [rdi + 64], zmm1
+    vmovaps [rdi + 128], zmm2
+    vmovaps [rdi + 192], zmm3
+    vmovaps [rdi + 256], zmm4
+    vmovaps [rdi + 320], zmm5
+    vmovaps [rdi + 384], zmm6
+    vmovaps [rdi + 448], zmm7
+    vmovaps [rdi + 512], zmm8
+    vmovaps [rdi + 576], zmm9
+    vmovaps [rdi + 640], zmm10
+    vmovaps [rdi + 704], zmm11
+    vmovaps [rdi + 768], zmm12
+    vmovaps [rdi + 832], zmm13
+    vmovaps [rdi + 896], zmm14
+    vmovaps [rdi + 960], zmm15
+    vmovaps [rdi + 1024], zmm16
+    vmovaps [rdi + 1088], zmm17
+    vmovaps [rdi + 1152], zmm18
+    vmovaps [rdi + 1216], zmm19
+    vmovaps [rdi + 1280], zmm20
+    vmovaps [rdi + 1344], zmm21
+    vmovaps [rdi + 1408], zmm22
+    vmovaps [rdi + 1472], zmm23
+    vzeroupper
+    ret
+
+; 24 x 8 doubles, 384 FLOPs per step
+flopsFma512Pd:
+    vbroadcastsd zmm24, qword [rsi]    ; m
+    vbroadcastsd zmm25, qword [rsi + 8]    ; a
+    vmovapd zmm0, [rdi + 0]
+    vmovapd zmm1, [rdi + 64]
+    vmovapd zmm2, [rdi + 128]
+    vmovapd zmm3, [rdi + 192]
+    vmovapd zmm4, [rdi + 256]
+    vmovapd zmm5, [rdi + 320]
+    vmovapd zmm6, [rdi + 384]
+    vmovapd zmm7, [rdi + 448]
+    vmovapd zmm8, [rdi + 512]
+    vmovapd zmm9, [rdi + 576]
+    vmovapd zmm10, [rdi + 640]
+    vmovapd zmm11, [rdi + 704]
+    vmovapd zmm12, [rdi + 768]
+    vmovapd zmm13, [rdi + 832]
+    vmovapd zmm14, [rdi + 896]
+    vmovapd zmm15, [rdi + 960]
+    vmovapd zmm16, [rdi + 1024]
+    vmovapd zmm17, [rdi + 1088]
+    vmovapd zmm18, [rdi + 1152]
+    vmovapd zmm19, [rdi + 1216]
+    vmovapd zmm20, [rdi + 1280]
+    vmovapd zmm21, [rdi + 1344]
+    vmovapd zmm22, [rdi + 1408]
+    vmovapd zmm23, [rdi + 1472]
+    test rdx, rdx
+    jz .store
+
+.loop:
+    vfmadd213pd zmm0, zmm24, zmm25
+    vfmadd213pd zmm1, zmm24, zmm25
+    vfmadd213pd zmm2, zmm24, zmm25
+    vfmadd213pd zmm3, zmm24, zmm25
+    vfmadd213pd zmm4, zmm24, zmm25
+    vfmadd213pd zmm5, zmm24, zmm25
+    vfmadd213pd zmm6, zmm24, zmm25
+    vfmadd213pd zmm7, zmm24, zmm25
+    vfmadd213pd zmm8, zmm24, zmm25
+    vfmadd213pd zmm9, zmm24, zmm25
+    vfmadd213pd zmm10, zmm24, zmm25
+    vfmadd213pd zmm11, zmm24, zmm25
+    vfmadd213pd zmm12, zmm24, zmm25
+    vfmadd213pd zmm13, zmm24, zmm25
+    vfmadd213pd zmm14, zmm24, zmm25
+    vfmadd213pd zmm15, zmm24, zmm25
+    vfmadd213pd zmm16, zmm24, zmm25
+    vfmadd213pd zmm17, zmm24, zmm25
+    vfmadd213pd zmm18, zmm24, zmm25
+    vfmadd213pd zmm19, zmm24, zmm25
+    vfmadd213pd zmm20, zmm24, zmm25
+    vfmadd213pd zmm21, zmm24, zmm25
+    vfmadd213pd zmm22, zmm24, zmm25
+    vfmadd213pd zmm23, zmm24, zmm25
+    dec rdx
+    jnz .loop
+
+.store:
+    vmovapd [rdi + 0], zmm0
+    vmovapd [rdi + 64], zmm1
+    vmovapd [rdi + 128], zmm2
+    vmovapd [rdi + 192], zmm3
+    vmovapd [rdi + 256], zmm4
+    vmovapd [rdi + 320], zmm5
+    vmovapd [rdi + 384], zmm6
+    vmovapd [rdi + 448], zmm7
+    vmovapd [rdi + 512], zmm8
+    vmovapd [rdi + 576], zmm9
+    vmovapd [rdi + 640], zmm10
+    vmovapd [rdi + 704], zmm11
+    vmovapd [rdi + 768], zmm12
+    vmovapd [rdi + 832], zmm13
+    vmovapd [rdi + 896], zmm14
+    vmovapd [rdi + 960], zmm15
+    vmovapd [rdi + 1024], zmm16
+    vmovapd [rdi + 1088], zmm17
+    vmovapd [rdi + 1152], zmm18
+    vmovapd [rdi + 1216], zmm19
+    vmovapd [rdi + 1280], zmm20
+    vmovapd [rdi + 1344], zmm21
+    vmovapd [rdi + 1408], zmm22
+    vmovapd [rdi + 1472], zmm23
+    vzeroupper
+    ret
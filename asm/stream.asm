@@ -0,0 +1,169 @@
+section .text
+global streamRead256, streamWrite256, streamWrite256Nt, streamCopy256, streamCopy256Nt
+global streamScale256, streamScale256Nt, streamAdd256, streamAdd256Nt, streamTriad256, streamTriad256Nt
+global streamRead512, streamWrite512, streamWrite512Nt, streamCopy512, streamCopy512Nt
+global streamScale512, streamScale512Nt, streamAdd512, streamAdd512Nt, streamTriad512, streamTriad512Nt
+
+; STREAM-style bandwidth kernels on doubles, 256-bit (AVX) and 512-bit
+; (AVX-512F) wide:
+;
+;   void stream<Op><bits>[Nt](double* dst, const double* x, const double* y,
+;                             double s, unsigned long bytes)
+;
+;   Read   dst[0..lanes) = sum of x   (dst is a 64-byte sink)
+;   Write  dst = s
+;   Copy   dst = x
+;   Scale  dst = s * x
+;   Add    dst = x + y
+;   Triad  dst = x + s * y
+;
+; bytes is each array's length, a multiple of four vectors; every array is
+; aligned to 64 bytes. Each step moves four vectors per array. The Nt forms
+; store with vmovntpd, which bypasses the caches and skips the read the
+; write-allocate of a plain store costs, and fence before returning so the
+; stores are globally visible when the caller stops its clock.
+
+; Epilogue; %1 is the store instruction the kernel used
+%macro STREAM_DONE 1
+%ifidn %1, vmovntpd
+        sfence
+%endif
+        vzeroupper
+        ret
+%endmacro
+
+; %1 register bank (ymm, zmm), %2 vector bytes
+%macro STREAM_READ 2
+        vxorpd xmm1, xmm1, xmm1         ; VEX zeroing clears the whole zmm
+        vxorpd xmm2, xmm2, xmm2
+        vxorpd xmm3, xmm3, xmm3
+        vxorpd xmm4, xmm4, xmm4
+        xor rax, rax
+%%loop:
+        ; four sums, so the adds' latency doesn't bound the loads
+        vaddpd %{1}1, %{1}1, [rsi + rax]
+        vaddpd %{1}2, %{1}2, [rsi + rax + %2]
+        vaddpd %{1}3, %{1}3, [rsi + rax + 2*%2]
+        vaddpd %{1}4, %{1}4, [rsi + rax + 3*%2]
+        add rax, 4*%2
+        cmp rax, rcx
+        jb %%loop
+        vaddpd %{1}1, %{1}1, %{1}2
+        vaddpd %{1}3, %{1}3, %{1}4
+        vaddpd %{1}1, %{1}1, %{1}3
+        vmovapd [rdi], %{1}1
+        vzeroupper
+        ret
+%endmacro
+
+; s from xmm0 into every lane of %1 0. vbroadcastsd from a register needs
+; AVX2 at 256 bits, from memory only AVX, so it goes through the red zone.
+%macro STREAM_SCALAR 1
+        vmovsd [rsp - 8], xmm0
+        vbroadcastsd %{1}0, [rsp - 8]
+%endmacro
+
+; %1 register bank, %2 vector bytes, %3 store (vmovapd, vmovntpd)
+%macro STREAM_WRITE 3
+        STREAM_SCALAR %1
+        xor rax, rax
+%%loop:
+        %3 [rdi + rax], %{1}0
+        %3 [rdi + rax + %2], %{1}0
+        %3 [rdi + rax + 2*%2], %{1}0
+        %3 [rdi + rax + 3*%2], %{1}0
+        add rax, 4*%2
+        cmp rax, rcx
+        jb %%loop
+        STREAM_DONE %3
+%endmacro
+
+; %1 register bank, %2 vector bytes, %3 store, %4 copy, scale, add or triad
+%macro STREAM_MOVE 4
+%ifidn %4, scale
+        STREAM_SCALAR %1
+%elifidn %4, triad
+        STREAM_SCALAR %1
+%endif
+        xor rax, rax
+%%loop:
+        vmovapd %{1}1, [rsi + rax]
+        vmovapd %{1}2, [rsi + rax + %2]
+        vmovapd %{1}3, [rsi + rax + 2*%2]
+        vmovapd %{1}4, [rsi + rax + 3*%2]
+%ifidn %4, scale
+        vmulpd %{1}1, %{1}1, %{1}0
+        vmulpd %{1}2, %{1}2, %{1}0
+        vmulpd %{1}3, %{1}3, %{1}0
+        vmulpd %{1}4, %{1}4, %{1}0
+%elifidn %4, add
+        vaddpd %{1}1, %{1}1, [rdx + rax]
+        vaddpd %{1}2, %{1}2, [rdx + rax + %2]
+        vaddpd %{1}3, %{1}3, [rdx + rax + 2*%2]
+        vaddpd %{1}4, %{1}4, [rdx + rax + 3*%2]
+%elifidn %4, triad
+        ; multiply and add rather than FMA, as STREAM's compiled C does
+        vmulpd %{1}5, %{1}0, [rdx + rax]
+        vmulpd %{1}6, %{1}0, [rdx + rax + %2]
+        vmulpd %{1}7, %{1}0, [rdx + rax + 2*%2]
+        vmulpd %{1}8, %{1}0, [rdx + rax + 3*%2]
+        vaddpd %{1}1, %{1}1, %{1}5
+        vaddpd %{1}2, %{1}2, %{1}6
+        vaddpd %{1}3, %{1}3, %{1}7
+        vaddpd %{1}4, %{1}4, %{1}8
+%endif
+        %3 [rdi + rax], %{1}1
+        %3 [rdi + rax + %2], %{1}2
+        %3 [rdi + rax + 2*%2], %{1}3
+        %3 [rdi + rax + 3*%2], %{1}4
+        add rax, 4*%2
+        cmp rax, rcx
+        jb %%loop
+        STREAM_DONE %3
+%endmacro
+
+streamRead256:
+        STREAM_READ ymm, 32
+streamWrite256:
+        STREAM_WRITE ymm, 32, vmovapd
+streamWrite256Nt:
+        STREAM_WRITE ymm, 32, vmovntpd
+streamCopy256:
+        STREAM_MOVE ymm, 32, vmovapd, copy
+streamCopy256Nt:
+        STREAM_MOVE ymm, 32, vmovntpd, copy
+streamScale256:
+        STREAM_MOVE ymm, 32, vmovapd, scale
+streamScale256Nt:
+        STREAM_MOVE ymm, 32, vmovntpd, scale
+streamAdd256:
+        STREAM_MOVE ymm, 32, vmovapd, add
+streamAdd256Nt:
+        STREAM_MOVE ymm, 32, vmovntpd, add
+streamTriad256:
+        STREAM_MOVE ymm, 32, vmovapd, triad
+streamTriad256Nt:
+        STREAM_MOVE ymm, 32, vmovntpd, triad
+
+streamRead512:
+        STREAM_READ zmm, 64
+streamWrite512:
+        STREAM_WRITE zmm, 64, vmovapd
+streamWrite512Nt:
+        STREAM_WRITE zmm, 64, vmovntpd
+streamCopy512:
+        STREAM_MOVE zmm, 64, vmovapd, copy
+streamCopy512Nt:
+        STREAM_MOVE zmm, 64, vmovntpd, copy
+streamScale512:
+        STREAM_MOVE zmm, 64, vmovapd, scale
+streamScale512Nt:
+        STREAM_MOVE zmm, 64, vmovntpd, scale
+streamAdd512:
+        STREAM_MOVE zmm, 64, vmovapd, add
+streamAdd512Nt:
+        STREAM_MOVE zmm, 64, vmovntpd, add
+streamTriad512:
+        STREAM_MOVE zmm, 64, vmovapd, triad
+streamTriad512Nt:
+        STREAM_MOVE zmm, 64, vmovntpd, triad
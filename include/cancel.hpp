@@ -0,0 +1,66 @@
+#ifndef CANCEL_HPP
+#define CANCEL_HPP
+
+#include <atomic>
+#include <csignal>
+
+// Process-wide stop request. SIGINT and SIGTERM set it while a Scope is open;
+// workers check it at chunk boundaries, trial and preset loops stop handing
+// out new work, and whatever finished is reported as truncated. A second
+// signal while a stop is pending, or any signal outside a Scope, gets the
+// default action, so a stuck run can still be killed.
+class Cancellation {
+public:
+    // Open while stopping cleanly is possible; scopes nest
+    class Scope {
+    public:
+        Scope() { armed_.fetch_add(1, std::memory_order_relaxed); }
+        ~Scope() { armed_.fetch_sub(1, std::memory_order_relaxed); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // SA_RESTART so prompts and disk writes carry on; workers poll instead
+    static void install() {
+        struct sigaction sa = {};
+        sa.sa_handler = handler;
+        sigemptyset(&sa.sa_mask);
+        sa.sa_flags = SA_RESTART;
+        sigaction(SIGINT, &sa, nullptr);
+        sigaction(SIGTERM, &sa, nullptr);
+    }
+
+    static bool requested() { return requested_.load(std::memory_order_relaxed); }
+    // Signal that asked for the stop, 0 for none
+    static int signal() { return signal_.load(std::memory_order_relaxed); }
+
+    static void request(int sig = SIGINT) {
+        signal_.store(sig, std::memory_order_relaxed);
+        requested_.store(true, std::memory_order_relaxed);
+    }
+
+    // Back to the interactive menu: the next test runs normally
+    static void reset() {
+        requested_.store(false, std::memory_order_relaxed);
+        signal_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static_assert(std::atomic<bool>::is_always_lock_free && std::atomic<int>::is_always_lock_free,
+                  "signal handler needs lock-free atomics");
+
+    static void handler(int sig) {
+        if (requested() || armed_.load(std::memory_order_relaxed) == 0) {
+            std::signal(sig, SIG_DFL);
+            std::raise(sig);
+            return;
+        }
+        request(sig);
+    }
+
+    inline static std::atomic<bool> requested_{false};
+    inline static std::atomic<int> signal_{0};
+    inline static std::atomic<int> armed_{0};
+};
+
+#endif // CANCEL_HPP
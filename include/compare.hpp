@@ -0,0 +1,161 @@
+#ifndef COMPARE_HPP
+#define COMPARE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "json.hpp"
+#include "results.hpp"
+#include "stats.hpp"
+
+// Test records from an earlier results.jsonl, pooled by test identity. A
+// record matches when test name, parameters (trial counts aside), thread
+// count, CPU model and kernel variant are equal; records written before
+// variants were recorded match any. Records from the current host are preferred;
+// other hosts with the same CPU are used only when the host has none, so a
+// fleet-wide file works as a baseline too.
+class Baseline {
+public:
+    struct Settings {
+        double alpha = 0.05;      // significance level of the per-test comparison
+        double min_change = 0.01; // smaller median shifts are never flagged
+    };
+
+    bool load(const std::string& path, std::string& error) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            error = "cannot open " + path;
+            return false;
+        }
+        std::string line;
+        size_t line_no = 0;
+        while (std::getline(file, line)) {
+            ++line_no;
+            if (line.empty()) continue;
+            const auto record = JsonValue::parse(line);
+            if (!record) {
+                error = path + ":" + std::to_string(line_no) + ": not valid JSON";
+                return false;
+            }
+            if (record->str("record") != "test") continue;
+            // An interrupted run measured less than it claims to have, and
+            // one with wrong results measured something else
+            if (const JsonValue* t = record->find("truncated"); t && t->boolean) continue;
+            if (record->num("errors") > 0) continue;
+
+            ResultStore::Params params;
+            if (const JsonValue* p = record->find("params")) {
+                for (const auto& [name, value] : p->object) params.emplace_back(name, value.string);
+            }
+            const std::string test = record->str("test");
+            const unsigned threads = static_cast<unsigned>(record->num("threads"));
+            if (tests_.insert(test).second) order_.push_back({test, params});
+
+            Samples& s = entries_[key(test, params, threads, record->str("cpu"), record->str("variant"))][record->str("host")];
+            if (const JsonValue* stats = record->find("stats")) {
+                for (double t : stats->numbers("trials")) s.trials.push_back(t);
+            }
+            if (const JsonValue* per_thread = record->find("thread_trials")) {
+                s.threads.resize(std::max(s.threads.size(), per_thread->array.size()));
+                for (size_t i = 0; i < per_thread->array.size(); ++i) {
+                    for (const auto& t : per_thread->array[i].array) {
+                        if (t.type == JsonValue::Type::Number) s.threads[i].push_back(t.number);
+                    }
+                }
+            }
+            ++records_;
+        }
+        return true;
+    }
+
+    size_t records() const { return records_; }
+
+    // Distinct tests in file order with the parameters of their first record
+    const std::vector<std::pair<std::string, ResultStore::Params>>& tests() const { return order_; }
+
+    // Empty when the baseline has nothing for this record. Per-thread checks
+    // use a Bonferroni-corrected alpha so many threads don't add false alarms.
+    std::vector<Comparison> compare(const TestRecord& r, const std::string& cpu, const std::string& host,
+                                    const Settings& settings) const {
+        const unsigned threads = static_cast<unsigned>(r.scores.size());
+        auto it = entries_.find(key(r.test, r.params, threads, cpu, r.variant));
+        if (it == entries_.end()) it = entries_.find(key(r.test, r.params, threads, cpu, "")); // baseline without variants
+        if (it == entries_.end()) return {};
+        const auto& by_host = it->second;
+        Samples pooled;
+        if (const auto own = by_host.find(host); own != by_host.end()) {
+            pooled = own->second;
+        } else {
+            for (const auto& [h, s] : by_host) {
+                pooled.trials.insert(pooled.trials.end(), s.trials.begin(), s.trials.end());
+                pooled.threads.resize(std::max(pooled.threads.size(), s.threads.size()));
+                for (size_t i = 0; i < s.threads.size(); ++i) {
+                    pooled.threads[i].insert(pooled.threads[i].end(), s.threads[i].begin(), s.threads[i].end());
+                }
+            }
+        }
+
+        std::vector<Comparison> out;
+        out.push_back(judge("test", pooled.trials, r.stats.trials, settings.alpha, settings.min_change));
+        const double thread_alpha = settings.alpha / static_cast<double>(std::max<size_t>(1, r.thread_trials.size()));
+        for (size_t i = 0; i < r.thread_trials.size() && i < pooled.threads.size(); ++i) {
+            out.push_back(judge("thread " + std::to_string(i), pooled.threads[i], r.thread_trials[i],
+                                thread_alpha, settings.min_change));
+        }
+        return out;
+    }
+
+private:
+    struct Samples {
+        std::vector<double> trials;               // per-trial test scores
+        std::vector<std::vector<double>> threads; // per-thread, per-trial scores
+    };
+
+    // Trial counts only change how many samples there are, not what is measured;
+    // a different kernel variant measures something else
+    static std::string key(const std::string& test, ResultStore::Params params, unsigned threads, const std::string& cpu,
+                           const std::string& variant) {
+        std::erase_if(params, [](const auto& p) { return p.first == "trials" || p.first == "warmup_trials"; });
+        std::ranges::sort(params);
+        std::string k = test + "|" + std::to_string(threads) + "|" + cpu;
+        for (const auto& [name, value] : params) k += "|" + name + "=" + value;
+        if (!variant.empty()) k += "|variant=" + variant;
+        return k;
+    }
+
+    static Comparison judge(const std::string& scope, const std::vector<double>& baseline,
+                            const std::vector<double>& current, double alpha, double min_change) {
+        Comparison c;
+        c.scope = scope;
+        c.baseline_n = baseline.size();
+        c.current_n = current.size();
+        c.baseline_median = median(baseline);
+        c.current_median = median(current);
+        c.change = c.baseline_median > 0 ? c.current_median / c.baseline_median - 1 : 0.0;
+        c.test = mannWhitney(current, baseline);
+        // With too few trials even complete separation can't reach alpha:
+        // the smallest two-sided p-value is 2 / C(n1 + n2, n1)
+        double arrangements = 1;
+        for (size_t k = 1; k <= current.size(); ++k) {
+            arrangements = arrangements * static_cast<double>(baseline.size() + k) / static_cast<double>(k);
+        }
+        if (baseline.empty() || current.empty() || 2 / arrangements >= alpha) return c;
+        if (c.test.p >= alpha || std::fabs(c.change) < min_change) {
+            c.verdict = Comparison::Verdict::Unchanged;
+        } else {
+            c.verdict = c.change < 0 ? Comparison::Verdict::Regressed : Comparison::Verdict::Improved;
+        }
+        return c;
+    }
+
+    std::map<std::string, std::map<std::string, Samples>> entries_; // key -> host -> samples
+    std::set<std::string> tests_;
+    std::vector<std::pair<std::string, ResultStore::Params>> order_;
+    size_t records_ = 0;
+};
+
+#endif // COMPARE_HPP
@@ -1,44 +1,280 @@
 #ifndef CONFIG_HPP
 #define CONFIG_HPP
 
+#include "registry.hpp"
+#include "topology.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <optional>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <fstream>
 #include <sstream>
 #include <vector>
 
-class ConfigParser {
+// What a preset may say. Global keys set up the whole run; a test section
+// ([avx], or [avx.light] for a second avx entry) takes that test's parameters
+// and the entry keys, which override the global ones for that entry alone.
+// Flat parameter keys (avx_iterations) are the spelling from before sections
+// and still work. Sections are stored as "<section>.<key>", which is also
+// what "--set avx.iterations=5" writes.
+class PresetSchema {
 public:
-    static bool loadConfig(const std::string& filename, std::unordered_map<std::string, std::string>& config) {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            return false;
+    // Per-entry overrides of run settings, also valid as global keys
+    static constexpr const char* ENTRY_KEYS[] = {"threads", "placement", "duration", "repeat", "trials",
+                                                 "warmup_trials", "variant"};
+
+    // Error for a bad key or value, nothing when it is fine
+    static std::optional<std::string> check(const std::string& key, const std::string& value) {
+        if (const auto dot = key.rfind('.'); dot != std::string::npos) {
+            return checkEntry(key.substr(0, dot), key.substr(dot + 1), value);
         }
-        
-        std::string line;
-        while (std::getline(file, line)) {
-            // Skip empty lines and comments
-            if (line.empty() || line[0] == '#') continue;
-            
-            // Find = separator
-            size_t pos = line.find('=');
-            if (pos == std::string::npos) continue;
-            
-            std::string key = line.substr(0, pos);
-            std::string value = line.substr(pos + 1);
-            
-            // Trim whitespace
-            key.erase(0, key.find_first_not_of(" \t"));
-            key.erase(key.find_last_not_of(" \t") + 1);
-            value.erase(0, value.find_first_not_of(" \t"));
-            value.erase(value.find_last_not_of(" \t") + 1);
-            
-            config[key] = value;
+        for (const Key& k : globalKeys()) {
+            if (key == k.name) return checkValue(key, value, k.kind, k.choices);
+        }
+        for (const TestDescriptor& test : TestRegistry::getInstance().all()) {
+            for (const TestParam& p : test.params) {
+                if (key == p.key) return checkParam(key, value, p);
+            }
+            if (key == test.hazard) return checkValue(key, value, Kind::Choice, "ask|allow");
+        }
+        return "unknown key '" + key + "'" + suggestion(key, globalNames());
+    }
+
+    // Every test named in test_order or a scenario has to exist
+    static std::optional<std::string> checkTest(const std::string& entry) {
+        if (TestRegistry::getInstance().find(testOf(entry))) return std::nullopt;
+        std::vector<std::string> names;
+        for (const TestDescriptor& test : TestRegistry::getInstance().all()) names.push_back(test.name);
+        return "unknown test '" + testOf(entry) + "'" + suggestion(testOf(entry), names);
+    }
+
+    // "branch.gaming" -> "branch"
+    static std::string testOf(const std::string& entry) { return entry.substr(0, entry.find('.')); }
+
+    // "1, 2, 4" or "1..4": every value of a swept parameter; anything else is one value
+    static std::vector<std::string> values(const std::string& value) {
+        std::vector<std::string> out;
+        if (const auto dots = value.find(".."); dots != std::string::npos) {
+            char* end = nullptr;
+            const long first = std::strtol(value.c_str(), &end, 10);
+            const long last = std::strtol(value.c_str() + dots + 2, nullptr, 10);
+            for (long v = first; v <= last && out.size() < 4096; ++v) out.push_back(std::to_string(v));
+            return out;
+        }
+        std::stringstream ss(value);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            item.erase(0, item.find_first_not_of(" \t"));
+            item.erase(item.find_last_not_of(" \t") + 1);
+            if (!item.empty()) out.push_back(item);
+        }
+        return out;
+    }
+
+private:
+    enum class Kind { Number, Count, Integer, Text, Choice, Placement, Tests, Isa, Variant };
+
+    struct Key {
+        const char* name;
+        Kind kind;
+        const char* choices = "";
+    };
+
+    static std::span<const Key> globalKeys() {
+        static constexpr Key keys[] = {
+            {"test_order", Kind::Tests},
+            {"duration", Kind::Number},
+            {"trials", Kind::Count},
+            {"warmup_trials", Kind::Count},
+            {"repeat", Kind::Count},
+            {"loop", Kind::Count},
+            {"max_cv", Kind::Number},
+            {"monitor", Kind::Choice, "gui|quiet|off"},
+            {"telemetry_hz", Kind::Number},
+            {"telemetry_cpu", Kind::Integer},
+            {"placement", Kind::Placement},
+            {"threads", Kind::Count},
+            {"results", Kind::Text},
+            {"results_csv", Kind::Text},
+            {"timeseries", Kind::Choice, "on|off"},
+            {"max_temp", Kind::Number},
+            {"compare", Kind::Text},
+            {"compare_alpha", Kind::Number},
+            {"compare_min_change", Kind::Number},
+            {"scenario", Kind::Text},
+            {"scenario_duration", Kind::Number},
+            {"sweep", Kind::Choice, "off|on|pow2|all"},
+            {"disable_isa", Kind::Isa},
+            {"variant", Kind::Variant},
+        };
+        return keys;
+    }
+
+    static std::optional<std::string> checkEntry(const std::string& section, const std::string& key,
+                                                 const std::string& value) {
+        const TestDescriptor* test = TestRegistry::getInstance().find(testOf(section));
+        if (!test) return checkTest(section);
+        if (const TestParam* p = test->param(key)) return checkParam(section + "." + key, value, *p);
+        if (key == "variant") return checkVariant(section + "." + key, value, {test});
+        for (const char* entry_key : ENTRY_KEYS) {
+            if (key != entry_key) continue;
+            for (const Key& k : globalKeys()) {
+                if (key == k.name) return checkValue(section + "." + key, value, k.kind, k.choices);
+            }
+        }
+        std::vector<std::string> names(std::begin(ENTRY_KEYS), std::end(ENTRY_KEYS));
+        for (const TestParam& p : test->params) names.push_back(p.name);
+        return "unknown key '" + key + "' for " + test->name + suggestion(key, names);
+    }
+
+    // A parameter may list several values to sweep over
+    static std::optional<std::string> checkParam(const std::string& key, const std::string& value, const TestParam& p) {
+        const auto items = values(value);
+        if (items.empty()) return key + ": no value";
+        for (const std::string& item : items) {
+            char* end = nullptr;
+            const double v = std::strtod(item.c_str(), &end);
+            if (*end != '\0') return key + ": '" + item + "' is not a number";
+            if (p.integer && v != static_cast<double>(static_cast<long long>(v))) {
+                return key + ": '" + item + "' is not a whole number";
+            }
+            if (v < p.min || v > p.max) {
+                return key + ": " + item + " is outside " + TestValues::text(p.min) + ".." + TestValues::text(p.max);
+            }
+        }
+        return std::nullopt;
+    }
+
+    static std::optional<std::string> checkValue(const std::string& key, const std::string& value, Kind kind,
+                                                 const std::string& choices) {
+        char* end = nullptr;
+        switch (kind) {
+        case Kind::Number: {
+            // Durations, rates, temperatures and thresholds: none can be negative
+            const double v = std::strtod(value.c_str(), &end);
+            if (value.empty() || *end != '\0') return key + ": '" + value + "' is not a number";
+            if (!std::isfinite(v) || v < 0) return key + ": '" + value + "' is not a finite number >= 0";
+            break;
+        }
+        case Kind::Count:
+        case Kind::Integer: {
+            const long v = std::strtol(value.c_str(), &end, 10);
+            if (value.empty() || *end != '\0' || (kind == Kind::Count && v < 0)) {
+                return key + ": '" + value + "' is not a " + (kind == Kind::Count ? "count" : "whole number");
+            }
+            break;
+        }
+        case Kind::Choice:
+            if (!("|" + choices + "|").contains("|" + value + "|")) {
+                return key + ": '" + value + "' is not one of " + choices;
+            }
+            break;
+        case Kind::Placement:
+            if (!parsePlacement(value)) {
+                return key + ": unknown placement '" + value + "' (linear, physical, smt, spread-l3, pack-ccx, pack-node)";
+            }
+            break;
+        case Kind::Tests: {
+            std::stringstream ss(value);
+            std::string entry;
+            while (std::getline(ss, entry, ',')) {
+                std::erase_if(entry, ::isspace);
+                if (entry.empty()) continue;
+                if (auto error = checkTest(entry)) return key + ": " + *error;
+            }
+            break;
+        }
+        case Kind::Isa:
+            if (!parseIsa(value)) {
+                std::string names;
+                for (const IsaName& n : ISA_NAMES) names += (names.empty() ? "" : ", ") + std::string(n.key);
+                return key + ": unknown instruction set in '" + value + "' (" + names + ")";
+            }
+            break;
+        case Kind::Variant: {
+            std::vector<const TestDescriptor*> tests;
+            for (const TestDescriptor& test : TestRegistry::getInstance().all()) tests.push_back(&test);
+            return checkVariant(key, value, tests);
+        }
+        case Kind::Text:
+            break;
+        }
+        return std::nullopt;
+    }
+
+    // "all", "best" or kernel variant names of the given tests
+    static std::optional<std::string> checkVariant(const std::string& key, const std::string& value,
+                                                   const std::vector<const TestDescriptor*>& tests) {
+        std::vector<std::string> names = {"all", "best"};
+        for (const TestDescriptor* test : tests) {
+            for (const KernelVariant& v : test->variants) names.push_back(v.name);
+        }
+        const auto items = values(value);
+        if (items.empty()) return key + ": no value";
+        for (const std::string& item : items) {
+            if (std::ranges::find(names, item) == names.end()) {
+                return key + ": unknown kernel variant '" + item + "'" + suggestion(item, names);
+            }
+        }
+        return std::nullopt;
+    }
+
+    static std::vector<std::string> globalNames() {
+        std::vector<std::string> names;
+        for (const Key& k : globalKeys()) names.emplace_back(k.name);
+        for (const TestDescriptor& test : TestRegistry::getInstance().all()) {
+            for (const TestParam& p : test.params) names.push_back(p.key);
+        }
+        return names;
+    }
+
+    // " (did you mean 'avx_iterations'?)" for a name within two edits of a known one
+    static std::string suggestion(const std::string& name, const std::vector<std::string>& known) {
+        std::string best;
+        size_t best_distance = 3;
+        for (const std::string& candidate : known) {
+            std::vector<size_t> row(candidate.size() + 1);
+            for (size_t j = 0; j < row.size(); ++j) row[j] = j;
+            for (size_t i = 1; i <= name.size(); ++i) {
+                size_t diagonal = row[0];
+                row[0] = i;
+                for (size_t j = 1; j <= candidate.size(); ++j) {
+                    const size_t above = row[j];
+                    row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (name[i - 1] != candidate[j - 1])});
+                    diagonal = above;
+                }
+            }
+            if (row.back() < best_distance) {
+                best_distance = row.back();
+                best = candidate;
+            }
+        }
+        return best.empty() ? "" : " (did you mean '" + best + "'?)";
+    }
+};
+
+class ConfigParser {
+public:
+    // Reads a preset into `config`, checking every key against PresetSchema.
+    // "include = other.cfg" (relative to the including file) is read in place
+    // and later keys win. Without a test_order the sections run in file order.
+    // Fails with "file:line: message" on the first bad line.
+    static bool loadConfig(const std::string& filename, std::unordered_map<std::string, std::string>& config,
+                           std::string& error) {
+        std::vector<std::string> sections, open;
+        if (!load(filename, config, sections, open, error)) return false;
+        if (!config.contains("test_order") && !sections.empty()) {
+            std::string order;
+            for (const auto& s : sections) order += (order.empty() ? "" : ", ") + s;
+            config["test_order"] = order;
         }
-        
         return true;
     }
-    
+
     static std::vector<std::string> getTestOrder(const std::unordered_map<std::string, std::string>& config) {
         std::vector<std::string> tests;
         auto it = config.find("test_order");
@@ -56,6 +292,80 @@ public:
         }
         return tests;
     }
+
+private:
+    static void trim(std::string& text) {
+        text.erase(0, text.find_first_not_of(" \t\r"));
+        text.erase(text.find_last_not_of(" \t\r") + 1);
+    }
+
+    // `open` holds the files being read, so an include cycle is an error rather than a hang
+    static bool load(const std::string& filename, std::unordered_map<std::string, std::string>& config,
+                     std::vector<std::string>& sections, std::vector<std::string>& open, std::string& error) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            error = "cannot read " + filename;
+            return false;
+        }
+        open.push_back(std::filesystem::weakly_canonical(filename).string());
+
+        std::string line, section;
+        for (unsigned number = 1; std::getline(file, line); ++number) {
+            const std::string where = filename + ":" + std::to_string(number) + ": ";
+            line.erase(std::min(line.find('#'), line.size())); // comment, whole line or trailing
+            trim(line);
+            if (line.empty()) continue;
+
+            if (line.front() == '[') {
+                if (line.back() != ']') {
+                    error = where + "unterminated section '" + line + "'";
+                    return false;
+                }
+                section = line.substr(1, line.size() - 2);
+                trim(section);
+                if (auto bad = PresetSchema::checkTest(section)) {
+                    error = where + "[" + section + "]: " + *bad;
+                    return false;
+                }
+                if (std::ranges::find(sections, section) == sections.end()) sections.push_back(section);
+                continue;
+            }
+
+            // Find = separator
+            size_t pos = line.find('=');
+            if (pos == std::string::npos) {
+                error = where + "expected key = value, got '" + line + "'";
+                return false;
+            }
+
+            std::string key = line.substr(0, pos);
+            std::string value = line.substr(pos + 1);
+            trim(key);
+            trim(value);
+
+            if (key == "include") {
+                const std::filesystem::path path = std::filesystem::path(filename).parent_path() / value;
+                if (std::ranges::find(open, std::filesystem::weakly_canonical(path).string()) != open.end()) {
+                    error = where + value + " includes itself";
+                    return false;
+                }
+                if (!std::filesystem::exists(path)) {
+                    error = where + "cannot read " + path.string();
+                    return false;
+                }
+                if (!load(path.string(), config, sections, open, error)) return false;
+                continue;
+            }
+            if (!section.empty()) key = section + "." + key;
+            if (auto bad = PresetSchema::check(key, value)) {
+                error = where + *bad;
+                return false;
+            }
+            config[key] = value;
+        }
+        open.pop_back();
+        return true;
+    }
 };
 
-#endif // CONFIG_HPP
\ No newline at end of file
+#endif // CONFIG_HPP
@@ -5,6 +5,33 @@ extern "C" {
     void p3np1E(unsigned long a, unsigned long * steps);
     void primes(unsigned long a, unsigned long * steps);
     void avx(float * a, float * b, float * c);
+    void avx512(float * a, float * b, float * c);
+    void flopsFma256Ps(void * acc, const void * coef, unsigned long steps);
+    void flopsFma256Pd(void * acc, const void * coef, unsigned long steps);
+    void flopsFma512Ps(void * acc, const void * coef, unsigned long steps);
+    void flopsFma512Pd(void * acc, const void * coef, unsigned long steps);
+    void streamRead256(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamWrite256(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamWrite256Nt(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamCopy256(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamCopy256Nt(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamScale256(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamScale256Nt(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamAdd256(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamAdd256Nt(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamTriad256(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamTriad256Nt(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamRead512(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamWrite512(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamWrite512Nt(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamCopy512(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamCopy512Nt(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamScale512(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamScale512Nt(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamAdd512(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamAdd512Nt(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamTriad512(double * dst, const double * x, const double * y, double s, unsigned long bytes);
+    void streamTriad512Nt(double * dst, const double * x, const double * y, double s, unsigned long bytes);
     void floodL1L2(void* buffer, unsigned long * iterations_ptr, size_t buffer1_size);
     void floodMemory(void* buffer, unsigned long * iterations_ptr, size_t buffer_size);
     void rowhammerAttack(void* buffer, unsigned long * iterations_ptr, size_t buffer_size);
@@ -15,9 +42,11 @@ extern "C" {
     void aes128DecryptBlock(void * out, const void * in, const void * key);
     void aesXtsDecrypt(void * out, const void * in, const void* key, const void * tweak, size_t blocks);
     void diskWrite(const char * name);
-    void startLZMA(int duration);
+    double startLZMA(int duration, unsigned threads); // threads == 0: every pool worker; returns ops/s
+    bool lzmaRoundTrip(unsigned worker_id, unsigned long op, size_t chunk_size);
     void spawn_system_monitor();
     void spawn_system_monitor_quiet();
+    void stop_system_monitor_quiet();
     void stop_system_monitor();
     void renderPixel(int iterations, int thread_id, float* output);
     void branchTorture(unsigned long iterations, int pattern_type);
@@ -25,4 +54,5 @@ extern "C" {
     void cacheL2Test(unsigned long iterations, void* buffer);
     void cacheL3Test(unsigned long iterations, void* buffer);
     void memoryLatencyTest(unsigned long iterations, void* buffer, size_t buffer_size);
+    void* pointerChase(void* node, unsigned long steps);
 }
\ No newline at end of file
@@ -0,0 +1,185 @@
+#ifndef CPUFEATURES_HPP
+#define CPUFEATURES_HPP
+
+#include <cctype>
+#include <cpuid.h>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Instruction sets a kernel variant can be written for
+enum IsaFeature : unsigned {
+    ISA_AVX = 1u << 0,
+    ISA_AVX2 = 1u << 1,
+    ISA_FMA = 1u << 2,
+    ISA_AES = 1u << 3,
+    ISA_SHA = 1u << 4,
+    ISA_SSE42 = 1u << 5,
+    ISA_VAES = 1u << 6,
+    ISA_AVX512F = 1u << 7,
+    ISA_AVX512BW = 1u << 8,
+    ISA_AVX512DQ = 1u << 9,
+    ISA_AVX512VL = 1u << 10,
+};
+
+struct IsaName {
+    unsigned bit;
+    const char* name; // for people: "AVX-512F"
+    const char* key;  // session record features{}: "avx512f"
+};
+
+inline constexpr IsaName ISA_NAMES[] = {
+    {ISA_SSE42, "SSE4.2", "sse42"},        {ISA_AVX, "AVX", "avx"},
+    {ISA_AVX2, "AVX2", "avx2"},            {ISA_FMA, "FMA", "fma"},
+    {ISA_AES, "AES-NI", "aes"},            {ISA_VAES, "VAES", "vaes"},
+    {ISA_SHA, "SHA-NI", "sha"},            {ISA_AVX512F, "AVX-512F", "avx512f"},
+    {ISA_AVX512BW, "AVX-512BW", "avx512bw"}, {ISA_AVX512DQ, "AVX-512DQ", "avx512dq"},
+    {ISA_AVX512VL, "AVX-512VL", "avx512vl"},
+};
+
+// "AVX2, FMA"
+inline std::string isaNames(unsigned mask) {
+    std::string out;
+    for (const IsaName& n : ISA_NAMES) {
+        if (mask & n.bit) out += (out.empty() ? "" : ", ") + std::string(n.name);
+    }
+    return out;
+}
+
+// "avx2, sha" -> IsaFeature bits, nothing if a name is unknown
+inline std::optional<unsigned> parseIsa(const std::string& list) {
+    unsigned mask = 0;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        std::erase_if(item, ::isspace);
+        if (item.empty()) continue;
+        const IsaName* found = nullptr;
+        for (const IsaName& n : ISA_NAMES) {
+            if (item == n.key) found = &n;
+        }
+        if (!found) return std::nullopt;
+        mask |= found->bit;
+    }
+    return mask;
+}
+
+// What the CPU reports through CPUID and what the OS lets a process use. The
+// VEX and EVEX instruction sets also need the kernel to save their register
+// state on a context switch (XCR0, read with XGETBV): a hypervisor or a
+// kernel booted with noxsave can leave them off while CPUID still lists
+// them, and running them anyway faults with SIGILL.
+class CpuFeatures {
+public:
+    static CpuFeatures& getInstance() {
+        static CpuFeatures instance;
+        return instance;
+    }
+
+    // IsaFeature bits that can run here
+    unsigned usable() const { return usable_; }
+    bool has(unsigned mask) const { return (usable_ & mask) == mask; }
+
+    const std::string& brand() const { return brand_; }
+
+    // Treat instruction sets as missing ("disable_isa = avx512f"), so every
+    // host of a mixed fleet runs the same kernel variants
+    void disable(unsigned mask) {
+        usable_ &= ~mask;
+        disabled_ |= mask;
+    }
+
+    // Why `mask` cannot run: "AVX2, FMA" or "AVX-512F (disabled by the OS)"
+    std::string missing(unsigned mask) const {
+        const unsigned lacking = mask & ~usable_;
+        const unsigned off = lacking & reported_ & ~disabled_;
+        const unsigned told = lacking & disabled_;
+        std::string out = isaNames(lacking & ~off & ~told);
+        if (off) out += (out.empty() ? "" : ", ") + isaNames(off) + " (disabled by the OS)";
+        if (told) out += (out.empty() ? "" : ", ") + isaNames(told) + " (disable_isa)";
+        return out;
+    }
+
+    // "ISA: AVX+ AVX2- FMA+ ...", short enough for the menu box
+    std::string summary() const {
+        static constexpr std::pair<unsigned, const char*> shown[] = {
+            {ISA_AVX, "AVX"}, {ISA_AVX2, "AVX2"}, {ISA_FMA, "FMA"}, {ISA_AES, "AES"},
+            {ISA_VAES, "VAES"}, {ISA_SHA, "SHA"}, {ISA_AVX512F, "AVX512"}};
+        std::string out = "ISA:";
+        for (const auto& [bit, name] : shown) out += " " + std::string(name) + (has(bit) ? "+" : "-");
+        return out;
+    }
+
+    // Session record features{}
+    std::vector<std::pair<std::string, bool>> flags() const {
+        std::vector<std::pair<std::string, bool>> out;
+        for (const IsaName& n : ISA_NAMES) out.emplace_back(n.key, has(n.bit));
+        return out;
+    }
+
+private:
+    CpuFeatures() { detect(); }
+
+    CpuFeatures(const CpuFeatures&) = delete;
+    CpuFeatures& operator=(const CpuFeatures&) = delete;
+
+    void detect() {
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        char brand[49] = {0};
+        if (__get_cpuid_max(0x80000000, nullptr) >= 0x80000004) {
+            for (unsigned leaf = 0; leaf < 3; ++leaf) {
+                __get_cpuid(0x80000002 + leaf, &eax, &ebx, &ecx, &edx);
+                const unsigned regs[] = {eax, ebx, ecx, edx};
+                std::memcpy(brand + leaf * 16, regs, 16);
+            }
+        }
+        brand_ = brand;
+        brand_.erase(0, brand_.find_first_not_of(' '));
+
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return;
+        const bool osxsave = ecx & bit_OSXSAVE;
+        if (ecx & bit_SSE4_2) reported_ |= ISA_SSE42;
+        if (ecx & bit_AES) reported_ |= ISA_AES;
+        if (ecx & bit_AVX) reported_ |= ISA_AVX;
+        if (ecx & bit_FMA) reported_ |= ISA_FMA;
+
+        // Leaf 7 needs its subleaf in ECX; __get_cpuid would leave it undefined
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+            if (ebx & bit_AVX2) reported_ |= ISA_AVX2;
+            if (ebx & bit_SHA) reported_ |= ISA_SHA;
+            if (ebx & bit_AVX512F) reported_ |= ISA_AVX512F;
+            if (ebx & bit_AVX512BW) reported_ |= ISA_AVX512BW;
+            if (ebx & bit_AVX512DQ) reported_ |= ISA_AVX512DQ;
+            if (ebx & bit_AVX512VL) reported_ |= ISA_AVX512VL;
+            if (ecx & bit_VAES) reported_ |= ISA_VAES;
+        }
+
+        // XMM|YMM state for VEX, plus opmask and both ZMM halves for EVEX
+        const uint64_t xcr0 = osxsave ? xgetbv() : 0;
+        const bool ymm = (xcr0 & 0x6) == 0x6;
+        const bool zmm = (xcr0 & 0xE6) == 0xE6;
+        constexpr unsigned VEX = ISA_AVX | ISA_AVX2 | ISA_FMA | ISA_VAES;
+        constexpr unsigned EVEX = ISA_AVX512F | ISA_AVX512BW | ISA_AVX512DQ | ISA_AVX512VL;
+        usable_ = reported_ & ~(VEX | EVEX);
+        if (ymm) usable_ |= reported_ & VEX;
+        if (zmm) usable_ |= reported_ & EVEX;
+    }
+
+    // Encoded by hand so this header needs no -mxsave
+    static uint64_t xgetbv() {
+        uint32_t lo = 0, hi = 0;
+        asm volatile(".byte 0x0f, 0x01, 0xd0" : "=a"(lo), "=d"(hi) : "c"(0));
+        return (static_cast<uint64_t>(hi) << 32) | lo;
+    }
+
+    std::string brand_;
+    unsigned reported_ = 0; // CPUID
+    unsigned usable_ = 0;   // CPUID and XCR0, less disabled_
+    unsigned disabled_ = 0;
+};
+
+#endif // CPUFEATURES_HPP
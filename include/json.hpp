@@ -0,0 +1,274 @@
+#ifndef JSON_HPP
+#define JSON_HPP
+
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Streaming JSON emitter for result records. Containers are opened and closed
+// explicitly and the writer places the commas; non-finite numbers become null
+// so a NaN statistic never produces an unparseable line.
+class JsonWriter {
+public:
+    JsonWriter& object() { return open('{', '}'); }
+    JsonWriter& array() { return open('[', ']'); }
+
+    JsonWriter& end() {
+        out_ += closers_.back();
+        closers_.pop_back();
+        first_ = false;
+        return *this;
+    }
+
+    JsonWriter& key(std::string_view name) {
+        separate();
+        quote(name);
+        out_ += ':';
+        after_key_ = true;
+        return *this;
+    }
+
+    JsonWriter& value(std::string_view text) { separate(); quote(text); return *this; }
+    JsonWriter& value(const char* text) { return value(std::string_view(text)); }
+    JsonWriter& value(const std::string& text) { return value(std::string_view(text)); }
+    JsonWriter& value(bool flag) { separate(); out_ += flag ? "true" : "false"; return *this; }
+    JsonWriter& null() { separate(); out_ += "null"; return *this; }
+
+    template<std::integral T>
+    JsonWriter& value(T number) {
+        separate();
+        char buf[24];
+        const auto res = std::to_chars(buf, buf + sizeof(buf), number);
+        out_.append(buf, res.ptr);
+        return *this;
+    }
+
+    template<std::floating_point T>
+    JsonWriter& value(T number) {
+        separate();
+        if (!std::isfinite(number)) {
+            out_ += "null";
+            return *this;
+        }
+        char buf[32];
+        const auto res = std::to_chars(buf, buf + sizeof(buf), static_cast<double>(number));
+        out_.append(buf, res.ptr);
+        return *this;
+    }
+
+    template<typename T>
+    JsonWriter& field(std::string_view name, const T& v) { return key(name).value(v); }
+
+    const std::string& str() const { return out_; }
+
+private:
+    JsonWriter& open(char opener, char closer) {
+        separate();
+        out_ += opener;
+        closers_.push_back(closer);
+        first_ = true;
+        return *this;
+    }
+
+    void separate() {
+        if (after_key_) {
+            after_key_ = false;
+        } else if (!first_) {
+            out_ += ',';
+        }
+        first_ = false;
+    }
+
+    void quote(std::string_view text) {
+        out_ += '"';
+        for (const char ch : text) {
+            switch (ch) {
+                case '"':  out_ += "\\\""; break;
+                case '\\': out_ += "\\\\"; break;
+                case '\n': out_ += "\\n"; break;
+                case '\r': out_ += "\\r"; break;
+                case '\t': out_ += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(ch) < 0x20) {
+                        char buf[8];
+                        std::snprintf(buf, sizeof(buf), "\\u%04x", ch);
+                        out_ += buf;
+                    } else {
+                        out_ += ch;
+                    }
+            }
+        }
+        out_ += '"';
+    }
+
+    std::string out_;
+    std::vector<char> closers_;
+    bool first_ = true;
+    bool after_key_ = false;
+};
+
+// Parsed JSON document, enough to read result records back. Numbers are
+// doubles; object members keep their file order.
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    bool isNull() const { return type == Type::Null; }
+
+    // Member by name, nullptr when absent or not an object
+    const JsonValue* find(std::string_view name) const {
+        for (const auto& [k, v] : object) {
+            if (k == name) return &v;
+        }
+        return nullptr;
+    }
+
+    std::string str(std::string_view name, const std::string& fallback = "") const {
+        const JsonValue* v = find(name);
+        return v && v->type == Type::String ? v->string : fallback;
+    }
+
+    double num(std::string_view name, double fallback = 0) const {
+        const JsonValue* v = find(name);
+        return v && v->type == Type::Number ? v->number : fallback;
+    }
+
+    // Numbers of an array member; nulls and other types are skipped
+    std::vector<double> numbers(std::string_view name) const {
+        std::vector<double> out;
+        if (const JsonValue* v = find(name)) {
+            for (const auto& e : v->array) {
+                if (e.type == Type::Number) out.push_back(e.number);
+            }
+        }
+        return out;
+    }
+
+    static std::optional<JsonValue> parse(std::string_view text) {
+        JsonValue value;
+        size_t pos = 0;
+        if (!parseValue(text, pos, value, 0)) return std::nullopt;
+        skipSpace(text, pos);
+        if (pos != text.size()) return std::nullopt;
+        return value;
+    }
+
+private:
+    static constexpr int MAX_DEPTH = 64;
+
+    static void skipSpace(std::string_view t, size_t& pos) {
+        while (pos < t.size() && (t[pos] == ' ' || t[pos] == '\t' || t[pos] == '\n' || t[pos] == '\r')) ++pos;
+    }
+
+    static bool literal(std::string_view t, size_t& pos, std::string_view word) {
+        if (t.substr(pos, word.size()) != word) return false;
+        pos += word.size();
+        return true;
+    }
+
+    static bool parseString(std::string_view t, size_t& pos, std::string& out) {
+        if (pos >= t.size() || t[pos] != '"') return false;
+        ++pos;
+        while (pos < t.size() && t[pos] != '"') {
+            char ch = t[pos++];
+            if (ch != '\\') {
+                out += ch;
+                continue;
+            }
+            if (pos >= t.size()) return false;
+            switch (ch = t[pos++]) {
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    // BMP code point to UTF-8; surrogate pairs are not combined
+                    if (pos + 4 > t.size()) return false;
+                    unsigned code = 0;
+                    if (std::from_chars(t.data() + pos, t.data() + pos + 4, code, 16).ptr != t.data() + pos + 4) return false;
+                    pos += 4;
+                    if (code < 0x80) {
+                        out += static_cast<char>(code);
+                    } else if (code < 0x800) {
+                        out += static_cast<char>(0xC0 | (code >> 6));
+                        out += static_cast<char>(0x80 | (code & 0x3F));
+                    } else {
+                        out += static_cast<char>(0xE0 | (code >> 12));
+                        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                        out += static_cast<char>(0x80 | (code & 0x3F));
+                    }
+                    break;
+                }
+                default: out += ch; break; // \" \\ \/
+            }
+        }
+        if (pos >= t.size()) return false;
+        ++pos;
+        return true;
+    }
+
+    static bool parseValue(std::string_view t, size_t& pos, JsonValue& v, int depth) {
+        if (depth > MAX_DEPTH) return false;
+        skipSpace(t, pos);
+        if (pos >= t.size()) return false;
+        switch (t[pos]) {
+            case 'n': v.type = Type::Null; return literal(t, pos, "null");
+            case 't': v.type = Type::Bool; v.boolean = true; return literal(t, pos, "true");
+            case 'f': v.type = Type::Bool; v.boolean = false; return literal(t, pos, "false");
+            case '"': v.type = Type::String; return parseString(t, pos, v.string);
+            case '[': {
+                v.type = Type::Array;
+                ++pos;
+                skipSpace(t, pos);
+                if (pos < t.size() && t[pos] == ']') return ++pos, true;
+                while (true) {
+                    if (!parseValue(t, pos, v.array.emplace_back(), depth + 1)) return false;
+                    skipSpace(t, pos);
+                    if (pos >= t.size()) return false;
+                    if (t[pos++] == ']') return true;
+                    if (t[pos - 1] != ',') return false;
+                }
+            }
+            case '{': {
+                v.type = Type::Object;
+                ++pos;
+                skipSpace(t, pos);
+                if (pos < t.size() && t[pos] == '}') return ++pos, true;
+                while (true) {
+                    skipSpace(t, pos);
+                    auto& member = v.object.emplace_back();
+                    if (!parseString(t, pos, member.first)) return false;
+                    skipSpace(t, pos);
+                    if (pos >= t.size() || t[pos++] != ':') return false;
+                    if (!parseValue(t, pos, member.second, depth + 1)) return false;
+                    skipSpace(t, pos);
+                    if (pos >= t.size()) return false;
+                    if (t[pos++] == '}') return true;
+                    if (t[pos - 1] != ',') return false;
+                }
+            }
+            default: {
+                v.type = Type::Number;
+                const auto res = std::from_chars(t.data() + pos, t.data() + t.size(), v.number);
+                if (res.ec != std::errc()) return false;
+                pos = static_cast<size_t>(res.ptr - t.data());
+                return true;
+            }
+        }
+    }
+};
+
+#endif // JSON_HPP
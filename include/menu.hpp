@@ -7,42 +7,31 @@
 
 class MenuSystem {
 public:
-    static void showMainMenu(const std::string& cpu_brand, bool has_avx, bool has_avx2, 
-                           bool has_fma, bool has_aes, bool has_sha) {
+    // One line of the test list
+    struct Entry {
+        char key;
+        std::string title;
+        std::string category;
+    };
+
+    static void showMainMenu(const std::string& cpu_brand, const std::string& features,
+                           const std::vector<Entry>& entries) {
         drawBox();
         
         std::cout << "│ " << centerText("SIFT v0.9.0 - System Intensive Function Tester", 46) << " │\n";
         std::cout << "│ " << centerText("CPU: " + cpu_brand, 46) << " │\n";
-        
-        std::string features = "Features: AVX" + std::string(has_avx ? "+" : "-") +
-                              " AVX2" + std::string(has_avx2 ? "+" : "-") +
-                              " FMA" + std::string(has_fma ? "+" : "-") +
-                              " AES" + std::string(has_aes ? "+" : "-") +
-                              " SHA" + std::string(has_sha ? "+" : "-");
         std::cout << "│ " << centerText(features, 46) << " │\n";
         
         std::cout << "├" << std::string(48, '-') << "┤\n";
-        std::cout << "│                                                │\n";
-        std::cout << "│  NORMAL TESTS                                  │\n";
-        std::cout << "│  [1] AVX Stress Test                           │\n";
-        std::cout << "│  [2] CPU Rendering (Death Mode)                │\n";
-        std::cout << "│  [3] Memory Stress + Rowhammer                 │\n";
-        std::cout << "│  [4] Full System Torture                       │\n";
-        std::cout << "│                                                │\n";
-        std::cout << "│  REAL-WORLD TESTS                              │\n";
-        std::cout << "│  [5] Branch Prediction                         │\n";
-        std::cout << "│  [6] Cache Hierarchy (L1/L2/L3)                │\n";
-        std::cout << "│  [7] 3n+1 Collatz Conjecture                   │\n";
-        std::cout << "│  [8] Prime Factorization                       │\n";
-        std::cout << "│                                                │\n";
-        std::cout << "│  🛡️ SECURITY TESTS                              │\n";
-        std::cout << "│  [9] AES Encryption                            │\n";
-        std::cout << "│  [A] AES Decryption                            │\n";
-        std::cout << "│  [B] SHA-256 Hashing                           │\n";
-        std::cout << "│                                                │\n";
-        std::cout << "│  💾 I/O TESTS                                  │\n";
-        std::cout << "│  [C] Disk Write Stress                         │\n";
-        std::cout << "│  [D] LZMA Compression                          │\n";
+        std::string category;
+        for (const Entry& e : entries) {
+            if (e.category != category) {
+                category = e.category;
+                std::cout << "│                                                │\n";
+                std::cout << "│  " << padText(category, 46) << "│\n";
+            }
+            std::cout << "│  " << padText("[" + std::string(1, e.key) + "] " + e.title, 46) << "│\n";
+        }
         std::cout << "│                                                │\n";
         std::cout << "│  ⚙️ UTILITIES                                   │\n";
         std::cout << "│  [R] Show Recommendation                       │\n";
@@ -87,9 +76,10 @@ public:
     //     std::cout.flush();
     // }
     
+    // 'Q' once stdin is closed, so a piped session ends instead of spinning
     static char getMenuChoice() {
-        char choice;
-        std::cin >> choice;
+        char choice = 'Q';
+        if (!(std::cin >> choice)) return 'Q';
         return std::toupper(choice);
     }
     
@@ -103,15 +93,39 @@ private:
         std::cout << "┌" << std::string(48, '-') << "┐\n";
     }
     
+    // Terminal columns: one per code point, two for emoji (4-byte UTF-8),
+    // none for the emoji variation selector
+    static int displayWidth(const std::string& text) {
+        int width = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            const auto byte = static_cast<unsigned char>(text[i]);
+            if ((byte & 0xC0) == 0x80) continue;
+            if (text.compare(i, 3, "\xEF\xB8\x8F") == 0) continue;
+            width += byte >= 0xF0 ? 2 : 1;
+        }
+        return width;
+    }
+
+    // Cut at a character boundary to at most `width` columns
+    static std::string fit(std::string text, int width) {
+        while (displayWidth(text) > width) {
+            while (!text.empty() && (static_cast<unsigned char>(text.back()) & 0xC0) == 0x80) text.pop_back();
+            if (!text.empty()) text.pop_back();
+        }
+        return text;
+    }
+
     static std::string centerText(const std::string& text, int width) {
-        if (text.length() >= width) return text.substr(0, width);
-        int padding = (width - text.length()) / 2;
-        return std::string(padding, ' ') + text + std::string(width - text.length() - padding, ' ');
+        const int length = displayWidth(text);
+        if (length >= width) return fit(text, width);
+        int padding = (width - length) / 2;
+        return std::string(padding, ' ') + text + std::string(width - length - padding, ' ');
     }
     
     static std::string padText(const std::string& text, int width) {
-        if (text.length() >= width) return text.substr(0, width);
-        return text + std::string(width - text.length(), ' ');
+        const int length = displayWidth(text);
+        if (length >= width) return fit(text, width);
+        return text + std::string(width - length, ' ');
     }
 };
 
@@ -0,0 +1,210 @@
+#ifndef PERF_HPP
+#define PERF_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <linux/perf_event.h>
+#include <optional>
+#include <string>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+enum PerfEvent {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCH_MISSES,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_REF_CYCLES,
+    PERF_EVENT_COUNT
+};
+
+inline const char* perfEventName(int event) {
+    static constexpr const char* names[] = {
+        "cycles", "instructions", "branch-misses", "L1D-misses", "LLC-misses", "dTLB-misses", "ref-cycles"};
+    return names[event];
+}
+
+// Counter values for one thread's timed region, already scaled for
+// multiplexing. valid[e] is false when the kernel refused the event.
+struct PerfCounts {
+    std::array<uint64_t, PERF_EVENT_COUNT> value{};
+    std::array<bool, PERF_EVENT_COUNT> valid{};
+
+    bool any() const {
+        for (bool v : valid) {
+            if (v) return true;
+        }
+        return false;
+    }
+
+    bool has(int event) const { return valid[event]; }
+
+    PerfCounts& operator+=(const PerfCounts& other) {
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            if (!other.valid[e]) continue;
+            value[e] += other.value[e];
+            valid[e] = true;
+        }
+        return *this;
+    }
+
+    double ipc() const {
+        return has(PERF_CYCLES) && has(PERF_INSTRUCTIONS) && value[PERF_CYCLES]
+                   ? static_cast<double>(value[PERF_INSTRUCTIONS]) / static_cast<double>(value[PERF_CYCLES]) : 0.0;
+    }
+
+    // Misses per thousand instructions
+    double mpki(int event) const {
+        return has(event) && has(PERF_INSTRUCTIONS) && value[PERF_INSTRUCTIONS]
+                   ? static_cast<double>(value[event]) * 1000.0 / static_cast<double>(value[PERF_INSTRUCTIONS]) : 0.0;
+    }
+
+    // ref-cycles tick at the nominal (TSC) rate while the core is unhalted,
+    // so cycles / ref-cycles scales the TSC rate to the clock actually run.
+    double effectiveGhz(double tsc_ghz) const {
+        return has(PERF_CYCLES) && has(PERF_REF_CYCLES) && value[PERF_REF_CYCLES]
+                   ? tsc_ghz * static_cast<double>(value[PERF_CYCLES]) / static_cast<double>(value[PERF_REF_CYCLES]) : 0.0;
+    }
+};
+
+// A perf_event_open group on the calling thread. attrs[0] is meant to lead;
+// events the kernel rejects (perf_event_paranoid, VMs without a vPMU, events
+// this CPU lacks) are skipped one by one and the first accepted one leads.
+// With nothing accepted the group is a cheap no-op.
+class EventGroup {
+public:
+    explicit EventGroup(std::vector<perf_event_attr> attrs)
+        : fds_(attrs.size(), -1), ids_(attrs.size(), 0) {
+        for (size_t e = 0; e < attrs.size(); ++e) {
+            perf_event_attr& attr = attrs[e];
+            attr.size = sizeof(attr);
+            attr.disabled = leader_ < 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+                               PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0));
+            if (fd < 0) continue;
+            if (leader_ < 0) leader_ = fd;
+            fds_[e] = fd;
+            ioctl(fd, PERF_EVENT_IOC_ID, &ids_[e]);
+        }
+    }
+
+    ~EventGroup() {
+        for (int fd : fds_) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    EventGroup(const EventGroup&) = delete;
+    EventGroup& operator=(const EventGroup&) = delete;
+
+    bool open() const { return leader_ >= 0; }
+
+    void start() const {
+        if (leader_ < 0) return;
+        ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    void stop() const {
+        if (leader_ >= 0) ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    // One value per attr, scaled for multiplexing; nullopt where the event
+    // was refused or the group never got onto the PMU.
+    std::vector<std::optional<uint64_t>> read() const {
+        std::vector<std::optional<uint64_t>> values(fds_.size());
+        if (leader_ < 0) return values;
+
+        // { nr, time_enabled, time_running, { value, id } * nr }
+        std::vector<uint64_t> buf(3 + 2 * fds_.size(), 0);
+        if (::read(leader_, buf.data(), buf.size() * sizeof(uint64_t)) <= 0) return values;
+        const uint64_t nr = buf[0], enabled = buf[1], running = buf[2];
+        if (running == 0) return values;
+
+        const double scale = static_cast<double>(enabled) / static_cast<double>(running);
+        for (uint64_t i = 0; i < nr && i < fds_.size(); ++i) {
+            const uint64_t value = buf[3 + 2 * i], id = buf[4 + 2 * i];
+            for (size_t e = 0; e < fds_.size(); ++e) {
+                if (fds_[e] >= 0 && ids_[e] == id) {
+                    values[e] = static_cast<uint64_t>(static_cast<double>(value) * scale);
+                }
+            }
+        }
+        return values;
+    }
+
+    // Why counters may be missing, for the report
+    static std::string paranoidLevel() {
+        std::ifstream file("/proc/sys/kernel/perf_event_paranoid");
+        std::string level;
+        std::getline(file, level);
+        return level.empty() ? "?" : level;
+    }
+
+private:
+    int leader_ = -1;
+    std::vector<int> fds_;
+    std::vector<uint64_t> ids_;
+};
+
+// The fixed set of generic counters every worker collects.
+class PerfGroup {
+public:
+    PerfGroup() : group_(attrs()) {}
+
+    bool open() const { return group_.open(); }
+    void start() const { group_.start(); }
+    void stop() const { group_.stop(); }
+
+    PerfCounts read() const {
+        PerfCounts counts;
+        const auto values = group_.read();
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            if (!values[e]) continue;
+            counts.value[e] = *values[e];
+            counts.valid[e] = true;
+        }
+        return counts;
+    }
+
+    static std::string paranoidLevel() { return EventGroup::paranoidLevel(); }
+
+private:
+    static std::vector<perf_event_attr> attrs() {
+        std::vector<perf_event_attr> list(PERF_EVENT_COUNT);
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            perf_event_attr& attr = list[e];
+            std::memset(&attr, 0, sizeof(attr));
+            auto cache = [&](uint64_t id) {
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = id | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            };
+            attr.type = PERF_TYPE_HARDWARE;
+            switch (e) {
+                case PERF_CYCLES:        attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+                case PERF_INSTRUCTIONS:  attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+                case PERF_BRANCH_MISSES: attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+                case PERF_L1D_MISSES:    cache(PERF_COUNT_HW_CACHE_L1D); break;
+                case PERF_LLC_MISSES:    cache(PERF_COUNT_HW_CACHE_LL); break;
+                case PERF_DTLB_MISSES:   cache(PERF_COUNT_HW_CACHE_DTLB); break;
+                case PERF_REF_CYCLES:    attr.config = PERF_COUNT_HW_REF_CPU_CYCLES; break;
+                default: break;
+            }
+        }
+        return list;
+    }
+
+    EventGroup group_;
+};
+
+#endif // PERF_HPP
@@ -0,0 +1,86 @@
+#ifndef PROCSTAT_HPP
+#define PROCSTAT_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+// Busy and total jiffies from /proc/stat, machine-wide and per logical CPU.
+// The file stays open and is re-read with pread from offset 0, which procfs
+// regenerates on every read; concurrent callers each bring their own buffer.
+class CpuTimes {
+public:
+    struct Times {
+        uint64_t busy = 0;  // everything but idle and iowait
+        uint64_t total = 0;
+    };
+
+    static CpuTimes& getInstance() {
+        static CpuTimes instance;
+        return instance;
+    }
+
+    bool available() const { return fd_ >= 0; }
+
+    // per_cpu is indexed by CPU id; ids absent from the file (offline) stay zero
+    bool read(Times& all, std::vector<Times>& per_cpu) const {
+        std::vector<char> buf(64 * 1024);
+        ssize_t n = 0;
+        while (fd_ >= 0) {
+            n = pread(fd_, buf.data(), buf.size() - 1, 0);
+            if (n <= 0) return false;
+            if (static_cast<size_t>(n) < buf.size() - 1) break;
+            buf.resize(buf.size() * 2); // thousands of CPUs
+        }
+        if (n <= 0) return false;
+        buf[static_cast<size_t>(n)] = '\0';
+
+        per_cpu.clear();
+        for (const char* line = buf.data(); line && std::strncmp(line, "cpu", 3) == 0;) {
+            const char* p = line + 3;
+            const bool aggregate = *p == ' ';
+            char* end = nullptr;
+            const unsigned long id = aggregate ? 0 : std::strtoul(p, &end, 10);
+            if (!aggregate) p = end;
+            uint64_t v[8] = {};
+            for (uint64_t& x : v) {
+                x = std::strtoull(p, &end, 10);
+                p = end;
+            }
+            Times t;
+            for (uint64_t x : v) t.total += x;
+            t.busy = t.total - v[3] - v[4];
+            if (aggregate) {
+                all = t;
+            } else {
+                if (per_cpu.size() <= id) per_cpu.resize(id + 1);
+                per_cpu[id] = t;
+            }
+            line = std::strchr(line, '\n');
+            if (line) ++line;
+        }
+        return true;
+    }
+
+    // Percent busy between two readings of the same CPU
+    static float usage(const Times& before, const Times& after) {
+        if (after.total <= before.total) return 0.0f;
+        return 100.0f * static_cast<float>(after.busy - before.busy) / static_cast<float>(after.total - before.total);
+    }
+
+private:
+    CpuTimes() : fd_(open("/proc/stat", O_RDONLY | O_CLOEXEC)) {}
+    ~CpuTimes() {
+        if (fd_ >= 0) close(fd_);
+    }
+
+    CpuTimes(const CpuTimes&) = delete;
+    CpuTimes& operator=(const CpuTimes&) = delete;
+
+    const int fd_;
+};
+
+#endif // PROCSTAT_HPP
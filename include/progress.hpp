@@ -0,0 +1,116 @@
+#ifndef PROGRESS_HPP
+#define PROGRESS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "workerpool.hpp"
+
+// Live iteration totals of the trial in flight. Each worker owns one cache
+// line and overwrites its running total there after every chunk; readers only
+// load, so the spinner or the telemetry thread can sample at any rate without
+// pulling a line away from a worker mid-chunk. The epoch is odd while a trial
+// is timing and moves on every begin()/end(), which tells a reader that the
+// totals were reset rather than that a worker stalled.
+class ProgressBoard {
+public:
+    struct Reading {
+        uint64_t epoch = 0; // odd while a trial is timing
+        double t = 0;       // seconds since that trial's start
+        std::vector<uint64_t> done; // iterations so far, by worker tid
+        std::vector<unsigned> cpus; // logical CPU of each worker
+
+        bool live() const { return epoch & 1; }
+    };
+
+    static ProgressBoard& getInstance() {
+        static ProgressBoard instance;
+        return instance;
+    }
+
+    // From each worker before the start barrier
+    void enter(unsigned tid, unsigned cpu) {
+        slots_[tid].cpu.store(cpu, std::memory_order_relaxed);
+        slots_[tid].done.store(0, std::memory_order_relaxed);
+    }
+
+    // From the worker that completes the start barrier, before anyone is released
+    void begin(unsigned threads, std::chrono::steady_clock::time_point start) {
+        threads_.store(std::min(threads, capacity_), std::memory_order_relaxed);
+        start_.store(start.time_since_epoch().count(), std::memory_order_relaxed);
+        epoch_.fetch_add(1, std::memory_order_release);
+    }
+
+    // After every chunk; single writer per slot, so a plain store
+    void publish(unsigned tid, uint64_t done) { slots_[tid].done.store(done, std::memory_order_relaxed); }
+
+    // From the worker that completes the finish barrier
+    void end() { epoch_.fetch_add(1, std::memory_order_release); }
+
+    // Totals of the trial in flight, or of the last one while none is.
+    // Retries if a trial started or stopped halfway through the copy.
+    Reading read() const {
+        Reading r;
+        for (int attempt = 0; attempt < 4; ++attempt) {
+            r.epoch = epoch_.load(std::memory_order_acquire);
+            const unsigned n = threads_.load(std::memory_order_relaxed);
+            const auto start = std::chrono::steady_clock::time_point(
+                std::chrono::steady_clock::duration(start_.load(std::memory_order_relaxed)));
+            r.t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            r.done.resize(n);
+            r.cpus.resize(n);
+            for (unsigned i = 0; i < n; ++i) {
+                r.done[i] = slots_[i].done.load(std::memory_order_relaxed);
+                r.cpus[i] = slots_[i].cpu.load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (epoch_.load(std::memory_order_relaxed) == r.epoch) break;
+        }
+        return r;
+    }
+
+private:
+    ProgressBoard()
+        : capacity_(WorkerPool::getInstance().size()), slots_(std::make_unique<Slot[]>(capacity_)) {}
+
+    ProgressBoard(const ProgressBoard&) = delete;
+    ProgressBoard& operator=(const ProgressBoard&) = delete;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> done{0};
+        std::atomic<unsigned> cpu{0};
+    };
+
+    const unsigned capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<uint64_t> epoch_{0};
+    std::atomic<unsigned> threads_{0};
+    std::atomic<std::chrono::steady_clock::rep> start_{0};
+};
+
+// Per-thread rates from successive board readings. Each reader keeps its own
+// meter, since the interval is whatever that reader's sampling period is.
+class ProgressMeter {
+public:
+    // Iterations per second of every worker since the previous update() of
+    // the same trial; empty on the first reading of a trial or while idle
+    const std::vector<double>& update(const ProgressBoard::Reading& r) {
+        rates_.clear();
+        if (r.live() && r.epoch == last_.epoch && r.t > last_.t && r.done.size() == last_.done.size()) {
+            rates_.resize(r.done.size());
+            for (size_t i = 0; i < r.done.size(); ++i) {
+                rates_[i] = static_cast<double>(r.done[i] - last_.done[i]) / (r.t - last_.t);
+            }
+        }
+        last_ = r;
+        return rates_;
+    }
+
+private:
+    ProgressBoard::Reading last_;
+    std::vector<double> rates_;
+};
+
+#endif // PROGRESS_HPP
@@ -0,0 +1,176 @@
+#ifndef RAPL_HPP
+#define RAPL_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+enum EnergyDomain {
+    ENERGY_PACKAGE,
+    ENERGY_CORE,
+    ENERGY_DRAM,
+    ENERGY_DOMAIN_COUNT
+};
+
+inline const char* energyDomainName(int domain) {
+    static constexpr const char* names[] = {"package", "core", "dram"};
+    return names[domain];
+}
+
+// Joules per domain over one window, summed across packages. valid[d] is
+// false when no zone of that domain exists or its counter is unreadable.
+struct EnergyCounts {
+    std::array<double, ENERGY_DOMAIN_COUNT> joules{};
+    std::array<bool, ENERGY_DOMAIN_COUNT> valid{};
+    double seconds = 0;
+
+    bool has(int domain) const { return valid[domain]; }
+    bool any() const { return has(ENERGY_PACKAGE) || has(ENERGY_CORE) || has(ENERGY_DRAM); }
+    double watts(int domain) const { return has(domain) && seconds > 0 ? joules[domain] / seconds : 0.0; }
+
+    EnergyCounts& operator+=(const EnergyCounts& other) {
+        for (int d = 0; d < ENERGY_DOMAIN_COUNT; ++d) {
+            if (!other.valid[d]) continue;
+            joules[d] += other.joules[d];
+            valid[d] = true;
+        }
+        seconds += other.seconds;
+        return *this;
+    }
+};
+
+// Energy of a whole test next to the work done in it, for efficiency figures.
+// Package energy is the basis: it is the one domain every RAPL CPU reports.
+struct EnergyUse {
+    EnergyCounts energy;
+    double work = 0; // iterations across all threads and trials
+
+    bool valid() const { return energy.has(ENERGY_PACKAGE) && work > 0; }
+    double joulesPerIteration() const { return valid() ? energy.joules[ENERGY_PACKAGE] / work : 0.0; }
+    // iterations per second per watt, i.e. iterations per joule
+    double iterationsPerJoule() const {
+        return valid() && energy.joules[ENERGY_PACKAGE] > 0 ? work / energy.joules[ENERGY_PACKAGE] : 0.0;
+    }
+};
+
+// RAPL energy counters through the powercap sysfs interface. Intel exposes
+// intel-rapl:<pkg> (package-N) with core/uncore/dram subzones; AMD Zen uses
+// the same driver and names with package and core only. energy_uj counts
+// microjoules and wraps at max_energy_range_uj. The counters are root-only
+// on kernels with the PLATYPUS fix (CVE-2020-8694), in which case every
+// domain simply reads as unavailable. Files stay open and are read with
+// pread so a sample costs a few syscalls.
+class Rapl {
+public:
+    struct Reading {
+        std::vector<uint64_t> raw; // microjoules per zone, zone order
+        std::chrono::steady_clock::time_point when;
+    };
+
+    static Rapl& getInstance() {
+        static Rapl instance;
+        return instance;
+    }
+
+    bool available() const { return !zones_.empty(); }
+
+    Reading read() const {
+        Reading r;
+        r.raw.reserve(zones_.size());
+        for (const Zone& z : zones_) r.raw.push_back(readCounter(z.fd));
+        r.when = std::chrono::steady_clock::now();
+        return r;
+    }
+
+    // Energy between two readings, unwrapping each counter once. A typical
+    // package range (~262 kJ) lasts about 17 minutes at 250 W; longer windows
+    // need intermediate readings to stay exact.
+    EnergyCounts delta(const Reading& before, const Reading& after) const {
+        EnergyCounts e;
+        e.seconds = std::chrono::duration<double>(after.when - before.when).count();
+        for (size_t i = 0; i < zones_.size() && i < before.raw.size() && i < after.raw.size(); ++i) {
+            const Zone& z = zones_[i];
+            const uint64_t b = before.raw[i], a = after.raw[i];
+            if (a == UINT64_MAX || b == UINT64_MAX) continue;
+            const uint64_t uj = a >= b ? a - b : a + (z.range - b);
+            e.joules[z.domain] += static_cast<double>(uj) / 1e6;
+            e.valid[z.domain] = true;
+        }
+        return e;
+    }
+
+private:
+    struct Zone {
+        EnergyDomain domain;
+        int fd;
+        uint64_t range; // max_energy_range_uj
+    };
+
+    Rapl() {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator("/sys/class/powercap", ec)) {
+            // intel-rapl-mmio duplicates the MSR package zone on client parts
+            const std::string id = entry.path().filename().string();
+            if (!id.starts_with("intel-rapl:")) continue;
+
+            const std::string name = readLine(entry.path() / "name");
+            EnergyDomain domain;
+            if (name.starts_with("package")) {
+                domain = ENERGY_PACKAGE;
+            } else if (name == "core") {
+                domain = ENERGY_CORE;
+            } else if (name == "dram") {
+                domain = ENERGY_DRAM;
+            } else {
+                continue; // uncore, psys
+            }
+
+            const int fd = open((entry.path() / "energy_uj").c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) continue;
+            uint64_t range = 0;
+            try {
+                range = std::stoull(readLine(entry.path() / "max_energy_range_uj"));
+            } catch (...) {}
+            if (range == 0 || readCounter(fd) == UINT64_MAX) {
+                close(fd);
+                continue;
+            }
+            zones_.push_back({domain, fd, range});
+        }
+    }
+
+    ~Rapl() {
+        for (const Zone& z : zones_) close(z.fd);
+    }
+
+    Rapl(const Rapl&) = delete;
+    Rapl& operator=(const Rapl&) = delete;
+
+    static std::string readLine(const std::filesystem::path& path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    // UINT64_MAX when the read fails (EACCES on restricted kernels)
+    static uint64_t readCounter(int fd) {
+        char buf[32];
+        const ssize_t n = pread(fd, buf, sizeof(buf) - 1, 0);
+        if (n <= 0) return UINT64_MAX;
+        buf[n] = '\0';
+        return std::strtoull(buf, nullptr, 10);
+    }
+
+    std::vector<Zone> zones_;
+};
+
+#endif // RAPL_HPP
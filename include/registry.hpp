@@ -0,0 +1,204 @@
+#ifndef REGISTRY_HPP
+#define REGISTRY_HPP
+
+#include "cpufeatures.hpp"
+#include "workload.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// One tunable of a test
+struct TestParam {
+    std::string name = {};   // record param and "sift run --<name>", e.g. "iterations"
+    std::string key = {};    // flat preset key from before sections, e.g. "avx_iterations"
+    double fallback = 0;     // recommended value, used when nothing sets it
+    std::string prompt = {}; // interactive question; empty: presets and the command line only
+    bool integer = true;
+    double min = 0, max = std::numeric_limits<double>::max();
+    bool sizes = false;      // sizes an iteration-mode run: not asked for with a duration, 0 skips the test
+    bool scales = false;     // multiplied by the full system test's intensity
+    bool seconds = false;    // the test's time budget rather than a kernel argument
+    std::string full = {};   // values the full system test steps through ("1..4"); default the fallback
+};
+
+// The usual work count: asked for unless a duration is set, scaled by the full test's intensity
+inline TestParam iterationsParam(std::string key, double fallback) {
+    return {.name = "iterations", .key = std::move(key), .fallback = fallback, .prompt = "Iterations?: ",
+            .sizes = true, .scales = true};
+}
+
+// One parameter set of a test, in declaration order
+class TestValues {
+public:
+    double get(std::string_view name) const {
+        for (const auto& [n, v] : values_) {
+            if (n == name) return v;
+        }
+        return 0;
+    }
+
+    unsigned long count(std::string_view name) const { return static_cast<unsigned long>(get(name)); }
+
+    void set(const std::string& name, double value) {
+        for (auto& [n, v] : values_) {
+            if (n == name) {
+                v = value;
+                return;
+            }
+        }
+        values_.emplace_back(name, value);
+    }
+
+    const std::vector<std::pair<std::string, double>>& all() const { return values_; }
+
+    // Record form: whole numbers without exponent or fraction, the rest shortest round-trip
+    static std::string text(double value) {
+        if (value == std::trunc(value) && std::abs(value) < 9.2e18) {
+            return std::to_string(static_cast<long long>(value));
+        }
+        char buf[32];
+        return std::string(buf, std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::general).ptr);
+    }
+
+private:
+    std::vector<std::pair<std::string, double>> values_;
+};
+
+// Where one workload instance runs
+struct WorkerSlot {
+    unsigned tid;     // index among the test's threads
+    unsigned threads; // threads running the test
+    unsigned id;      // unique across tests running at once, for per-thread files
+};
+
+using WorkloadMaker = std::function<std::unique_ptr<Workload>(const TestValues&, const WorkerSlot&)>;
+
+// One implementation of a test's kernel
+struct KernelVariant {
+    std::string name = {}; // recorded with the result, e.g. "avx2-fma"
+    unsigned isa = 0;      // IsaFeature bits it needs
+    WorkloadMaker make = {};
+};
+
+// Everything the menu, presets, "sift run" and library callers need to know
+// about a test. The kernel's setup/run/teardown are the Workload a variant's
+// `make` returns; the front ends time, repeat and report it. Variants are
+// listed best first and the first the CPU can run is used, so one binary
+// picks AVX-512, AVX2 or a portable kernel per host.
+struct TestDescriptor {
+    std::string name = {};     // preset, command line and scenario name
+    std::string title = {};    // menu entry
+    std::string category = {}; // menu section
+    char menu = 0;             // menu key; 0 takes the next free one
+    std::vector<TestParam> params = {};
+    std::string unit = "ips";  // what the scores count, per second
+    std::string spinner = {};  // shown while it runs
+    std::string score = {};    // report title
+    std::vector<std::string> logs = {}; // record names (or their prefixes) it logs under; the first is the default
+    std::function<std::string(const TestValues&)> log_name = {}; // record name when a parameter picks it
+    std::string hazard = {};   // needs "<hazard> = allow", or a yes to `warning`, before it runs
+    std::string warning = {};
+    std::vector<KernelVariant> variants = {};
+    // Best score one physical core can reach per clock cycle with a variant
+    // (FLOPs for an FMA kernel); when set, reports put the score against it
+    std::function<double(const TestValues&, const KernelVariant&)> peak_per_cycle = {};
+    // The threads' scores add up to something they share (memory bandwidth),
+    // so reports also give their sum per socket
+    bool per_socket = false;
+
+    std::string logName(const TestValues& values) const { return log_name ? log_name(values) : logs.front(); }
+
+    // Best variant this CPU runs, nothing when it lacks every one
+    const KernelVariant* variant(unsigned isa) const {
+        const auto it = std::ranges::find_if(variants, [isa](const KernelVariant& v) { return (v.isa & ~isa) == 0; });
+        return it == variants.end() ? nullptr : &*it;
+    }
+
+    const TestParam* param(std::string_view param_name) const {
+        const auto it = std::ranges::find(params, param_name, &TestParam::name);
+        return it == params.end() ? nullptr : &*it;
+    }
+};
+
+// Every test the binary has, filled by RegisterTest objects before main()
+// runs. Front ends only read it, so adding a kernel is one registration.
+class TestRegistry {
+public:
+    static constexpr std::string_view MENU_KEYS = "123456789ABCDEFGHIJKLMNOPSTUVWXYZ";
+    // Menu entries that are not tests: full system test, recommendations, quit
+    static constexpr std::string_view RESERVED_KEYS = "4RQ";
+
+    static TestRegistry& getInstance() {
+        static TestRegistry instance;
+        return instance;
+    }
+
+    void add(TestDescriptor test) {
+        tests_.push_back(std::move(test));
+        arranged_ = false;
+    }
+
+    // Menu order
+    const std::vector<TestDescriptor>& all() {
+        if (!arranged_) arrange();
+        return tests_;
+    }
+
+    const TestDescriptor* find(std::string_view name) {
+        const auto& tests = all();
+        const auto it = std::ranges::find(tests, name, &TestDescriptor::name);
+        return it == tests.end() ? nullptr : &*it;
+    }
+
+    const TestDescriptor* byMenuKey(char key) {
+        const auto& tests = all();
+        const auto it = std::ranges::find(tests, key, &TestDescriptor::menu);
+        return it == tests.end() ? nullptr : &*it;
+    }
+
+private:
+    TestRegistry() = default;
+
+    TestRegistry(const TestRegistry&) = delete;
+    TestRegistry& operator=(const TestRegistry&) = delete;
+
+    // Registration order differs between builds, so keyless tests are handed
+    // keys in name order and everything is sorted by key
+    void arrange() {
+        std::ranges::sort(tests_, {}, &TestDescriptor::name);
+        std::string taken(RESERVED_KEYS);
+        for (const auto& t : tests_) {
+            if (t.menu) taken += t.menu;
+        }
+        for (auto& t : tests_) {
+            if (t.menu) continue;
+            for (char key : MENU_KEYS) {
+                if (taken.find(key) == std::string::npos) {
+                    t.menu = key;
+                    taken += key;
+                    break;
+                }
+            }
+        }
+        std::ranges::stable_sort(tests_, {}, [](const TestDescriptor& t) { return MENU_KEYS.find(t.menu); });
+        arranged_ = true;
+    }
+
+    std::vector<TestDescriptor> tests_;
+    bool arranged_ = false;
+};
+
+// Static registration from any translation unit, *.module.cpp plugins included:
+//   static const RegisterTest avx_test({.name = "avx", ...});
+struct RegisterTest {
+    explicit RegisterTest(TestDescriptor test) { TestRegistry::getInstance().add(std::move(test)); }
+};
+
+#endif // REGISTRY_HPP
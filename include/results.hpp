@@ -0,0 +1,573 @@
+#ifndef RESULTS_HPP
+#define RESULTS_HPP
+
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <sys/utsname.h>
+#include <unistd.h>
+#include "json.hpp"
+#include "perf.hpp"
+#include "rapl.hpp"
+#include "stats.hpp"
+#include "thermal.hpp"
+#include "topdown.hpp"
+#include "tsc.hpp"
+
+// Everything one scored test produced. A cache run is four of these, one per level.
+struct TestRecord {
+    std::string test;
+    std::vector<std::pair<std::string, std::string>> params;
+    std::string placement;
+    std::vector<double> scores;          // per thread, iterations per second
+    std::vector<std::vector<double>> thread_trials; // per thread, one score per measured trial
+    std::vector<IterationCost> costs;    // per thread
+    std::vector<PerfCounts> counters;    // per thread
+    TopDown topdown;
+    TrialStats stats;
+    double thread_median = 0;
+    EnergyUse energy;
+    ThermalSummary thermal;
+    bool truncated = false; // a trial stopped early or was skipped (cancel, temperature ceiling)
+    std::string unit = "ips"; // what the scores count per second, from the test's registration
+    std::string variant;      // kernel implementation that ran, e.g. "avx2-fma"
+    double clock_ghz = 0;     // core clock while it ran, 0 when unknown
+    std::string clock_source; // "counters" or "cpufreq"
+    double peak = 0;          // theoretical score of the cores that ran, 0 when the test has no model
+    std::vector<std::pair<unsigned, double>> sockets = {}; // package -> its threads' scores summed
+    unsigned long errors = 0; // iterations whose results came out wrong; any fails the test
+};
+
+// Structured result sink. Records are serialized on the caller's thread into
+// an in-memory buffer; a writer thread appends them to the JSON Lines file
+// (and the optional CSV) in batches, so no test waits on the filesystem.
+// Host, kernel and run ID are captured once per process.
+//
+// Schema (SCHEMA_VERSION 1), one object per line, "record" says which kind:
+//   session: run_id, timestamp, host, kernel, arch, cpu, sift_version,
+//            logical_cpus, placement, features{}, tsc{ghz, invariant}
+//   test:    run_id, timestamp, host, kernel, arch, cpu, test, params{},
+//            threads, placement, unit, variant, truncated, errors, scores[],
+//            thread_trials[[]], cost[{cycles, ns}], stats{...},
+//            counters[{event: count}], clock{ghz, source, tsc_ratio} | null,
+//            peak | null, sockets[{package, score}],
+//            topdown{...} | null, energy{...} | null,
+//            thermal{core_events, package_events, peak_c, trend_c_per_s,
+//            min_mhz, min_cpu, aborted, impacts[{trial, t, cpu, kind,
+//            thread, change}], cores[{cpu, usage, mhz, peak_c}]}
+//   sweep:   run_id, timestamp, host, kernel, arch, cpu, test, placement,
+//            points[{threads, throughput, speedup, efficiency}], knee | null
+//   timeseries: run_id, timestamp, host, kernel, arch, cpu, test, trial,
+//            cpus[], t[], usage[[]], mhz[[]], temp_c[[]] (one row per CPU),
+//            thread_cpus[], rate[[]] (one row per worker thread)
+//   comparison: run_id, timestamp, host, kernel, arch, cpu, test, baseline,
+//            results[{scope, baseline_n, current_n, baseline_median,
+//            current_median, change, p, exact, verdict}]
+// Fields are only ever added; a rename or type change bumps SCHEMA_VERSION.
+class ResultStore {
+public:
+    static constexpr int SCHEMA_VERSION = 1;
+    using Params = std::vector<std::pair<std::string, std::string>>;
+
+    static ResultStore& getInstance() {
+        static ResultStore instance;
+        return instance;
+    }
+
+    // Both take effect from the next flush; an empty CSV path disables the CSV
+    void setJsonlPath(const std::string& path) {
+        std::lock_guard lock(mutex_);
+        jsonl_path_ = path;
+    }
+
+    void setCsvPath(const std::string& path) {
+        std::lock_guard lock(mutex_);
+        csv_path_ = path;
+    }
+
+    // Also hand this run's records to out as they are logged, for
+    // "sift run --format json|csv": every record as JSON Lines, or the test
+    // rows under a CSV header. Written on the logging thread, so out sees
+    // them in order without waiting for a batch. nullptr turns it off.
+    void setMirror(std::ostream* out, bool csv = false) {
+        std::lock_guard lock(mutex_);
+        mirror_ = out;
+        mirror_csv_ = csv;
+        mirror_header_ = false;
+    }
+
+    // Per-CPU time series of every trial as "timeseries" records; off by
+    // default since a long test on a big machine adds megabytes
+    void setTimeseries(bool on) { timeseries_ = on; }
+    bool timeseries() const { return timeseries_; }
+
+    const std::string& runId() const { return run_id_; }
+    const std::string& host() const { return host_; }
+    const std::string& cpu() const { return cpu_; }
+    const std::string& jsonlPath() const { return jsonl_path_; }
+
+    // Parameter value as the record stores it
+    template<typename T>
+    static std::string param(const T& value) {
+        std::ostringstream out;
+        out << value;
+        return out.str();
+    }
+
+    // features: instruction set -> usable on this host (CPUID and OS support)
+    void logSystemInfo(const std::string& cpu_brand, const std::vector<std::pair<std::string, bool>>& features,
+                       const std::string& placement, const char* version) {
+        cpu_ = cpu_brand;
+        JsonWriter json;
+        header(json, "session");
+        json.field("sift_version", version);
+        json.field("logical_cpus", std::thread::hardware_concurrency());
+        json.field("placement", placement);
+        json.key("features").object();
+        for (const auto& [name, usable] : features) json.field(name, usable);
+        json.end();
+        json.key("tsc").object()
+            .field("ghz", Tsc::getInstance().ghz())
+            .field("invariant", Tsc::getInstance().invariant())
+            .end();
+        json.end();
+        push(json.str(), {});
+    }
+
+    void logTestResult(const TestRecord& r) {
+        JsonWriter json;
+        header(json, "test");
+        json.field("test", r.test);
+        json.key("params").object();
+        for (const auto& [name, value] : r.params) json.field(name, value);
+        json.end();
+        json.field("threads", r.scores.size());
+        json.field("placement", r.placement);
+        json.field("unit", r.unit);
+        json.field("variant", r.variant);
+        json.field("truncated", r.truncated);
+        json.field("errors", r.errors);
+
+        json.key("scores").array();
+        for (double s : r.scores) json.value(s);
+        json.end();
+
+        json.key("thread_trials").array();
+        for (const auto& per_thread : r.thread_trials) {
+            json.array();
+            for (double t : per_thread) json.value(t);
+            json.end();
+        }
+        json.end();
+
+        json.key("cost").array();
+        for (const auto& c : r.costs) json.object().field("cycles", c.cycles).field("ns", c.ns).end();
+        json.end();
+
+        const TrialStats& s = r.stats;
+        json.key("stats").object()
+            .field("mean", s.mean).field("median", s.median).field("thread_median", r.thread_median)
+            .field("stddev", s.stddev).field("cv", s.cv)
+            .field("ci_low", s.ci_low).field("ci_high", s.ci_high).field("mad", s.mad)
+            .field("rejected", s.rejected()).field("verdict", s.verdict());
+        json.key("trials").array();
+        for (double t : s.trials) json.value(t);
+        json.end().end();
+
+        // Refused events are left out, never written as zero
+        json.key("counters").array();
+        for (const auto& c : r.counters) {
+            json.object();
+            for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+                if (c.has(e)) json.field(perfEventName(e), c.value[e]);
+            }
+            json.end();
+        }
+        json.end();
+
+        json.key("clock");
+        if (r.clock_ghz > 0) {
+            const double tsc = Tsc::getInstance().ghz();
+            json.object().field("ghz", r.clock_ghz).field("source", r.clock_source)
+                .field("tsc_ratio", tsc > 0 ? r.clock_ghz / tsc : 0.0)
+                .end();
+        } else {
+            json.null();
+        }
+        json.key("peak");
+        if (r.peak > 0) {
+            json.value(r.peak);
+        } else {
+            json.null();
+        }
+        json.key("sockets").array();
+        for (const auto& [package, score] : r.sockets) json.object().field("package", package).field("score", score).end();
+        json.end();
+
+        const TopDown& d = r.topdown;
+        json.key("topdown");
+        if (d.valid) {
+            json.object()
+                .field("method", d.method)
+                .field("retiring", d.retiring).field("bad_spec", d.bad_spec);
+            if (d.frontend_valid) {
+                json.field("frontend", d.frontend);
+            } else {
+                json.key("frontend").null();
+            }
+            json.field("backend", d.backend).field("memory", d.memory).field("core", d.core)
+                .field("memory_estimated", d.memory_approx)
+                .end();
+        } else {
+            json.null();
+        }
+
+        // Domains the machine doesn't report are null
+        const EnergyUse& e = r.energy;
+        json.key("energy");
+        if (e.energy.any()) {
+            json.object().field("seconds", e.energy.seconds);
+            for (int d = 0; d < ENERGY_DOMAIN_COUNT; ++d) {
+                json.key(std::string(energyDomainName(d)) + "_joules");
+                if (e.energy.has(d)) {
+                    json.value(e.energy.joules[d]);
+                } else {
+                    json.null();
+                }
+            }
+            json.field("package_watts", e.energy.watts(ENERGY_PACKAGE))
+                .field("joules_per_iteration", e.joulesPerIteration())
+                .field("iterations_per_joule", e.iterationsPerJoule())
+                .end();
+        } else {
+            json.null();
+        }
+
+        // Sensors the machine lacks are null; event counts are always present
+        const ThermalSummary& th = r.thermal;
+        json.key("thermal").object()
+            .field("core_events", th.core_events)
+            .field("package_events", th.package_events);
+        if (th.has_temperature) {
+            json.field("peak_c", th.peak_c).field("trend_c_per_s", th.trend);
+        } else {
+            json.key("peak_c").null().key("trend_c_per_s").null();
+        }
+        if (th.min_mhz > 0) {
+            json.field("min_mhz", th.min_mhz).field("min_cpu", th.min_cpu);
+        } else {
+            json.key("min_mhz").null().key("min_cpu").null();
+        }
+        json.field("aborted", th.aborted).key("impacts").array();
+        for (const ThrottleImpact& i : th.impacts) {
+            json.object().field("trial", i.trial).field("t", i.event.t).field("cpu", i.event.cpu)
+                .field("kind", i.event.package ? "package" : "core")
+                .field("thread", i.thread).field("change", i.change)
+                .end();
+        }
+        json.end();
+        // Imbalance view: every CPU, null where the machine lacks the source
+        auto opt = [&json](std::string_view name, bool ok, float v) {
+            if (ok) {
+                json.field(name, v);
+            } else {
+                json.key(name).null();
+            }
+        };
+        json.key("cores").array();
+        for (const auto& c : th.cores) {
+            json.object().field("cpu", c.cpu);
+            opt("usage", CpuTimes::getInstance().available(), c.usage);
+            opt("mhz", c.mhz > 0, c.mhz);
+            opt("peak_c", c.peak_c > 0, c.peak_c);
+            json.end();
+        }
+        json.end().end();
+        json.end();
+        push(json.str(), csvRow(r));
+    }
+
+    void logSweepResult(const std::string& test_name,
+                        const std::string& placement,
+                        const std::vector<unsigned>& threads,
+                        const std::vector<double>& throughput,
+                        unsigned knee) {
+        JsonWriter json;
+        header(json, "sweep");
+        json.field("test", test_name);
+        json.field("placement", placement);
+        const double base = throughput.empty() ? 0.0 : throughput.front();
+        json.key("points").array();
+        for (size_t i = 0; i < threads.size() && i < throughput.size(); ++i) {
+            const double speedup = base > 0 ? throughput[i] / base : 0.0;
+            json.object()
+                .field("threads", threads[i]).field("throughput", throughput[i])
+                .field("speedup", speedup).field("efficiency", speedup / threads[i])
+                .end();
+        }
+        json.end();
+        json.key("knee");
+        if (knee) {
+            json.value(knee);
+        } else {
+            json.null();
+        }
+        json.end();
+        push(json.str(), {});
+    }
+
+    void logComparison(const std::string& test_name, const std::string& baseline,
+                       const std::vector<Comparison>& results) {
+        JsonWriter json;
+        header(json, "comparison");
+        json.field("test", test_name);
+        json.field("baseline", baseline);
+        json.key("results").array();
+        for (const auto& c : results) {
+            json.object()
+                .field("scope", c.scope).field("baseline_n", c.baseline_n).field("current_n", c.current_n)
+                .field("baseline_median", c.baseline_median).field("current_median", c.current_median)
+                .field("change", c.change).field("p", c.test.p).field("exact", c.test.exact)
+                .field("verdict", c.verdictName())
+                .end();
+        }
+        json.end().end();
+        push(json.str(), {});
+    }
+
+    // thread_cpus/thread_rates: each worker's CPU and its iterations/s over
+    // every interval of trace.times
+    void logTimeseries(const std::string& test_name, unsigned trial, const ThermalTrace& trace,
+                       const std::vector<unsigned>& thread_cpus, const std::vector<std::vector<double>>& thread_rates) {
+        JsonWriter json;
+        header(json, "timeseries");
+        json.field("test", test_name).field("trial", trial);
+        const auto& cpus = ThermalSensors::getInstance().cpus();
+        json.key("cpus").array();
+        for (size_t c = 0; c < trace.cpus && c < cpus.size(); ++c) json.value(cpus[c]);
+        json.end().key("t").array();
+        for (double t : trace.times) json.value(t);
+        json.end();
+        for (const auto& [name, series] : {std::pair{"usage", &trace.usage}, {"mhz", &trace.mhz}, {"temp_c", &trace.core_c}}) {
+            json.key(name).array();
+            for (size_t c = 0; c < trace.cpus; ++c) {
+                json.array();
+                for (size_t k = 0; k < trace.times.size(); ++k) json.value((*series)[k * trace.cpus + c]);
+                json.end();
+            }
+            json.end();
+        }
+        json.key("thread_cpus").array();
+        for (unsigned cpu : thread_cpus) json.value(cpu);
+        json.end().key("rate").array();
+        for (const auto& rates : thread_rates) {
+            json.array();
+            for (double r : rates) json.value(r);
+            json.end();
+        }
+        json.end();
+        json.end();
+        push(json.str(), {});
+    }
+
+    // Block until everything logged so far is on disk
+    void flush() {
+        std::unique_lock lock(mutex_);
+        flush_requested_ = true;
+        wake_.notify_one();
+        drained_.wait(lock, [this] { return pending_.empty() && !writing_; });
+    }
+
+private:
+    struct Pending {
+        std::string json;
+        std::string csv;
+    };
+
+    // Records buffered before the writer is woken early
+    static constexpr size_t BATCH = 16;
+    static constexpr auto IDLE_FLUSH = std::chrono::seconds(2);
+
+    ResultStore() {
+        char hostname[256] = {0};
+        gethostname(hostname, sizeof(hostname) - 1);
+        host_ = hostname;
+        struct utsname sys_info;
+        if (uname(&sys_info) == 0) {
+            kernel_ = std::string(sys_info.sysname) + " " + sys_info.release;
+            arch_ = sys_info.machine;
+        }
+        char id[48];
+        std::snprintf(id, sizeof(id), "%s-%08x", timestamp("%Y%m%dT%H%M%SZ").c_str(), std::random_device{}());
+        run_id_ = id;
+        writer_ = std::thread([this] { writerLoop(); });
+    }
+
+    ~ResultStore() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        writer_.join();
+    }
+
+    ResultStore(const ResultStore&) = delete;
+    ResultStore& operator=(const ResultStore&) = delete;
+
+    static std::string timestamp(const char* format) {
+        const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::tm utc{};
+        gmtime_r(&now, &utc);
+        char buf[32];
+        std::strftime(buf, sizeof(buf), format, &utc);
+        return buf;
+    }
+
+    // Fields every record starts with; the caller closes the object
+    void header(JsonWriter& json, const char* record) const {
+        json.object()
+            .field("schema_version", SCHEMA_VERSION)
+            .field("record", record)
+            .field("run_id", run_id_)
+            .field("timestamp", timestamp("%Y-%m-%dT%H:%M:%SZ"))
+            .field("host", host_)
+            .field("kernel", kernel_)
+            .field("arch", arch_)
+            .field("cpu", cpu_);
+    }
+
+    static constexpr const char* CSV_HEADER =
+        "schema_version,run_id,timestamp,host,kernel,cpu,test,params,threads,placement,"
+        "mean,median,stddev,cv,ci_low,ci_high,trials,rejected,verdict,"
+        "cycles_per_iter,ns_per_iter,ipc,retiring,bad_spec,frontend,backend,memory,core,"
+        "package_watts,core_watts,dram_watts,joules_per_iter,iters_per_joule,"
+        "throttle_events,peak_temp_c,thermal_abort,truncated,unit,variant,clock_ghz,peak,errors";
+
+    static std::string csvField(const std::string& text) {
+        if (text.find_first_of(",\"\n") == std::string::npos) return text;
+        std::string quoted = "\"";
+        for (char ch : text) {
+            if (ch == '"') quoted += '"';
+            quoted += ch;
+        }
+        return quoted + "\"";
+    }
+
+    // One row per test record; columns a record lacks are left empty
+    std::string csvRow(const TestRecord& r) const {
+        std::string params;
+        for (const auto& [name, value] : r.params) params += (params.empty() ? "" : ";") + name + "=" + value;
+        PerfCounts total;
+        for (const auto& c : r.counters) total += c;
+        const IterationCost cost = meanCost(r.costs);
+        const TopDown& d = r.topdown;
+        auto num = [](double v) {
+            char buf[32];
+            return std::string(buf, std::to_chars(buf, buf + sizeof(buf), v).ptr);
+        };
+        auto opt = [&](bool ok, double v) { return ok ? num(v) : std::string(); };
+
+        const std::vector<std::string> cols = {
+            std::to_string(SCHEMA_VERSION), run_id_, timestamp("%Y-%m-%dT%H:%M:%SZ"), host_, kernel_, cpu_,
+            r.test, params, std::to_string(r.scores.size()), r.placement,
+            num(r.stats.mean), num(r.stats.median), num(r.stats.stddev), num(r.stats.cv),
+            num(r.stats.ci_low), num(r.stats.ci_high), std::to_string(r.stats.trials.size()),
+            std::to_string(r.stats.rejected()), r.stats.verdict(),
+            num(cost.cycles), num(cost.ns),
+            opt(total.has(PERF_INSTRUCTIONS) && total.has(PERF_CYCLES), total.ipc()),
+            opt(d.valid, d.retiring), opt(d.valid, d.bad_spec), opt(d.valid && d.frontend_valid, d.frontend),
+            opt(d.valid, d.backend), opt(d.valid, d.memory), opt(d.valid, d.core),
+            opt(r.energy.energy.has(ENERGY_PACKAGE), r.energy.energy.watts(ENERGY_PACKAGE)),
+            opt(r.energy.energy.has(ENERGY_CORE), r.energy.energy.watts(ENERGY_CORE)),
+            opt(r.energy.energy.has(ENERGY_DRAM), r.energy.energy.watts(ENERGY_DRAM)),
+            opt(r.energy.valid(), r.energy.joulesPerIteration()), opt(r.energy.valid(), r.energy.iterationsPerJoule()),
+            std::to_string(r.thermal.core_events + r.thermal.package_events),
+            opt(r.thermal.has_temperature, r.thermal.peak_c), r.thermal.aborted ? "1" : "0",
+            r.truncated ? "1" : "0", r.unit, r.variant, opt(r.clock_ghz > 0, r.clock_ghz), opt(r.peak > 0, r.peak),
+            std::to_string(r.errors)};
+        std::string row;
+        for (size_t i = 0; i < cols.size(); ++i) row += (i ? "," : "") + csvField(cols[i]);
+        return row;
+    }
+
+    void push(std::string json, std::string csv) {
+        std::lock_guard lock(mutex_);
+        if (mirror_ && !mirror_csv_) {
+            *mirror_ << json << "\n" << std::flush;
+        } else if (mirror_ && !csv.empty()) {
+            if (!std::exchange(mirror_header_, true)) *mirror_ << CSV_HEADER << "\n";
+            *mirror_ << csv << "\n" << std::flush;
+        }
+        pending_.push_back({std::move(json), std::move(csv)});
+        if (pending_.size() >= BATCH) wake_.notify_one();
+    }
+
+    void writerLoop() {
+        std::unique_lock lock(mutex_);
+        while (true) {
+            wake_.wait_for(lock, IDLE_FLUSH, [this] {
+                return stopping_ || flush_requested_ || pending_.size() >= BATCH;
+            });
+            if (!pending_.empty()) {
+                std::vector<Pending> batch;
+                batch.swap(pending_);
+                const std::string jsonl_path = jsonl_path_, csv_path = csv_path_;
+                writing_ = true;
+                lock.unlock();
+                write(batch, jsonl_path, csv_path);
+                lock.lock();
+                writing_ = false;
+            }
+            flush_requested_ = false;
+            drained_.notify_all();
+            if (stopping_ && pending_.empty()) return;
+        }
+    }
+
+    static void write(const std::vector<Pending>& batch, const std::string& jsonl_path, const std::string& csv_path) {
+        std::ofstream jsonl(jsonl_path, std::ios::app);
+        for (const auto& p : batch) {
+            if (jsonl.is_open()) jsonl << p.json << "\n";
+        }
+        if (csv_path.empty()) return;
+
+        std::error_code ec;
+        const bool fresh = !std::filesystem::exists(csv_path, ec) || std::filesystem::file_size(csv_path, ec) == 0;
+        std::ofstream csv(csv_path, std::ios::app);
+        if (!csv.is_open()) return;
+        if (fresh) csv << CSV_HEADER << "\n";
+        for (const auto& p : batch) {
+            if (!p.csv.empty()) csv << p.csv << "\n";
+        }
+    }
+
+    std::string host_, kernel_, arch_, cpu_, run_id_;
+    std::string jsonl_path_ = "results.jsonl";
+    std::string csv_path_;
+    bool timeseries_ = false;
+    std::ostream* mirror_ = nullptr;
+    bool mirror_csv_ = false;
+    bool mirror_header_ = false;
+
+    std::mutex mutex_;
+    std::condition_variable wake_, drained_;
+    std::vector<Pending> pending_;
+    bool writing_ = false;
+    bool flush_requested_ = false;
+    bool stopping_ = false;
+    std::thread writer_;
+};
+
+#endif // RESULTS_HPP
@@ -5,12 +5,22 @@
 #include <thread>
 #include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <string>
+#include "progress.hpp"
 
 class Spinner {
 public:
     Spinner(const std::string& message) : message_(message), running_(true) {
-        spinner_thread_ = std::thread(&Spinner::spin, this);
+        if (animated_) {
+            spinner_thread_ = std::thread(&Spinner::spin, this);
+        } else {
+            std::cout << message_ << std::endl;
+        }
     }
+
+    // Off when output is a pipe or file: one line at start and end, no frames
+    static void setAnimated(bool on) { animated_ = on; }
     
     ~Spinner() {
         stop();
@@ -22,7 +32,11 @@ public:
             if (spinner_thread_.joinable()) {
                 spinner_thread_.join();
             }
-            std::cout << "\r" << message_ << " ✅ Done!\n";
+            if (animated_) {
+                std::cout << "\r" << message_ << " ✅ Done!\033[K\n";
+            } else {
+                std::cout << message_ << " ✅ Done!\n";
+            }
         }
     }
 
@@ -32,15 +46,43 @@ private:
         int frame = 0;
         
         while (running_) {
-            std::cout << "\r" << message_ << " " << frames[frame] << std::flush;
-            frame = (frame + 1) % 8;
+            // Rates over half a second; shorter windows are mostly chunk jitter
+            if (frame % 5 == 0) status_ = status(meter_.update(ProgressBoard::getInstance().read()));
+            std::cout << "\r" << message_ << " " << frames[frame % 8] << status_ << "\033[K" << std::flush;
+            frame = (frame + 1) % 40;
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
     }
     
+    // Total rate of the trial in flight and its slowest thread against the mean
+    std::string status(const std::vector<double>& rates) {
+        if (rates.empty()) return status_;
+        double total = 0;
+        size_t slowest = 0;
+        for (size_t i = 0; i < rates.size(); ++i) {
+            total += rates[i];
+            if (rates[i] < rates[slowest]) slowest = i;
+        }
+        char buf[128];
+        const char* prefix[] = {"", "k", "M", "G", "T"};
+        double scaled = total;
+        int p = 0;
+        for (; scaled >= 1000 && p < 4; ++p) scaled /= 1000;
+        int n = std::snprintf(buf, sizeof(buf), "  %.2f %s it/s", scaled, prefix[p]);
+        const double mean = total / static_cast<double>(rates.size());
+        if (rates.size() > 1 && mean > 0) {
+            std::snprintf(buf + n, sizeof(buf) - static_cast<size_t>(n), " | slowest: thread %zu %+.1f%%",
+                          slowest, 100.0 * (rates[slowest] / mean - 1));
+        }
+        return buf;
+    }
+
     std::string message_;
     std::atomic<bool> running_;
     std::thread spinner_thread_;
+    ProgressMeter meter_;
+    std::string status_;
+    inline static bool animated_ = true;
 };
 
 #endif // SPINNER_HPP
\ No newline at end of file
@@ -0,0 +1,212 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+// How many times a test is repeated. Warm-up trials run the full test but are
+// discarded; every measured trial contributes one score to TrialStats.
+struct TrialPlan {
+    unsigned warmup = 0;
+    unsigned measured = 1;
+    double max_cv = 0.02; // coefficient of variation above which a result is unstable
+};
+
+inline double median(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    std::ranges::sort(values);
+    const size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2.0;
+}
+
+// Two-sided 95% Student t critical value for the given degrees of freedom.
+inline double tCritical95(size_t df) {
+    static constexpr double table[] = {
+        0.0,   12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+        2.228, 2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093,
+        2.086, 2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045,
+        2.042};
+    if (df == 0) return 0.0;
+    if (df < std::size(table)) return table[df];
+    if (df <= 60) return 2.000;
+    if (df <= 120) return 1.980;
+    return 1.960;
+}
+
+// Summary of one score per measured trial after outlier rejection.
+struct TrialStats {
+    std::vector<double> trials; // every measured trial, in run order
+    std::vector<double> kept;   // trials that survived outlier rejection
+    double mean = 0;
+    double median = 0;
+    double stddev = 0;          // sample standard deviation of kept trials
+    double cv = 0;              // stddev / mean
+    double ci_low = 0;          // 95% confidence interval of the mean
+    double ci_high = 0;
+    double mad = 0;             // median absolute deviation of all trials
+    bool stable = false;
+
+    size_t rejected() const { return trials.size() - kept.size(); }
+
+    const char* verdict() const {
+        if (kept.size() < 2) return "SINGLE TRIAL";
+        return stable ? "STABLE" : "UNSTABLE";
+    }
+
+    // Half-width of the confidence interval relative to the mean, i.e. the
+    // smallest difference between two runs that is more than noise.
+    double relativeError() const { return mean > 0 ? (ci_high - mean) / mean : 0.0; }
+};
+
+// Cost of one iteration in TSC reference cycles and wall-clock nanoseconds.
+struct IterationCost {
+    double cycles = 0;
+    double ns = 0;
+};
+
+inline IterationCost meanCost(const std::vector<IterationCost>& costs) {
+    IterationCost mean;
+    for (const auto& c : costs) {
+        mean.cycles += c.cycles / static_cast<double>(costs.size());
+        mean.ns += c.ns / static_cast<double>(costs.size());
+    }
+    return mean;
+}
+
+// Modified z-score (Iglewicz & Hoaglin): a trial is an outlier when
+// 0.6745 * |x - median| / MAD exceeds 3.5. With MAD == 0 nothing is rejected.
+inline TrialStats summarize(const std::vector<double>& trials, double max_cv) {
+    TrialStats s;
+    s.trials = trials;
+    if (trials.empty()) return s;
+
+    const double med = median(trials);
+    std::vector<double> deviations;
+    deviations.reserve(trials.size());
+    for (double x : trials) deviations.push_back(std::fabs(x - med));
+    s.mad = median(deviations);
+
+    for (double x : trials) {
+        if (s.mad > 0 && 0.6745 * std::fabs(x - med) / s.mad > 3.5) continue;
+        s.kept.push_back(x);
+    }
+
+    const double n = static_cast<double>(s.kept.size());
+    s.mean = std::accumulate(s.kept.begin(), s.kept.end(), 0.0) / n;
+    s.median = median(s.kept);
+    if (s.kept.size() > 1) {
+        double sq = 0;
+        for (double x : s.kept) sq += (x - s.mean) * (x - s.mean);
+        s.stddev = std::sqrt(sq / (n - 1));
+    }
+    s.cv = s.mean > 0 ? s.stddev / s.mean : 0.0;
+    const double half = tCritical95(s.kept.size() - 1) * s.stddev / std::sqrt(n);
+    s.ci_low = s.mean - half;
+    s.ci_high = s.mean + half;
+    s.stable = s.kept.size() >= 2 && s.cv <= max_cv;
+    return s;
+}
+
+// Mann-Whitney U (Wilcoxon rank-sum) test of "a and b come from the same
+// distribution", two-sided. No normality assumption, which suits benchmark
+// scores: they are skewed by preemption and throttling and have few samples.
+struct RankTest {
+    double u = 0;          // U statistic of a
+    double p = 1;          // two-sided p-value
+    bool exact = false;    // exact null distribution rather than normal approximation
+};
+
+inline RankTest mannWhitney(const std::vector<double>& a, const std::vector<double>& b) {
+    RankTest r;
+    const size_t n1 = a.size(), n2 = b.size(), n = n1 + n2;
+    if (n1 == 0 || n2 == 0) return r;
+
+    // Average ranks over the pooled samples, summing t^3 - t per tie group
+    std::vector<std::pair<double, bool>> pooled;
+    pooled.reserve(n);
+    for (double x : a) pooled.emplace_back(x, true);
+    for (double x : b) pooled.emplace_back(x, false);
+    std::ranges::sort(pooled, {}, &std::pair<double, bool>::first);
+    double rank_sum_a = 0, tie_term = 0;
+    for (size_t i = 0; i < n;) {
+        size_t j = i;
+        while (j < n && pooled[j].first == pooled[i].first) ++j;
+        const double rank = (static_cast<double>(i + j) + 1) / 2; // ranks i+1 .. j
+        for (size_t k = i; k < j; ++k) {
+            if (pooled[k].second) rank_sum_a += rank;
+        }
+        const double t = static_cast<double>(j - i);
+        tie_term += t * t * t - t;
+        i = j;
+    }
+    const double mn = static_cast<double>(n1 * n2);
+    r.u = rank_sum_a - static_cast<double>(n1 * (n1 + 1)) / 2;
+    const double tail_u = std::min(r.u, mn - r.u);
+
+    // Exact: count rank arrangements with U <= tail_u by the recurrence
+    // c(i, j, u) = c(i-1, j, u-j) + c(i, j-1, u); only valid without ties.
+    if (tie_term == 0 && n1 <= 30 && n2 <= 30) {
+        const size_t max_u = n1 * n2;
+        std::vector<std::vector<double>> prev(n2 + 1, std::vector<double>(max_u + 1, 0.0)), cur = prev;
+        for (size_t j = 0; j <= n2; ++j) prev[j][0] = 1; // i = 0
+        for (size_t i = 1; i <= n1; ++i) {
+            for (auto& row : cur) std::ranges::fill(row, 0.0);
+            cur[0][0] = 1;
+            for (size_t j = 1; j <= n2; ++j) {
+                for (size_t u = 0; u <= i * j; ++u) {
+                    cur[j][u] = (u >= j ? prev[j][u - j] : 0.0) + cur[j - 1][u];
+                }
+            }
+            std::swap(prev, cur);
+        }
+        double total = 0, tail = 0;
+        for (size_t u = 0; u <= max_u; ++u) {
+            total += prev[n2][u];
+            if (static_cast<double>(u) <= tail_u) tail += prev[n2][u];
+        }
+        r.p = std::min(1.0, 2 * tail / total);
+        r.exact = true;
+        return r;
+    }
+
+    // Normal approximation with tie and continuity correction
+    const double nd = static_cast<double>(n);
+    const double var = mn / 12 * ((nd + 1) - tie_term / (nd * (nd - 1)));
+    if (var <= 0) return r;
+    const double z = std::max(0.0, std::fabs(r.u - mn / 2) - 0.5) / std::sqrt(var);
+    r.p = std::min(1.0, std::erfc(z / std::sqrt(2.0)));
+    return r;
+}
+
+// Outcome of comparing one score (a whole test or one thread of it) against
+// the baseline. Scores are throughputs, so lower is a regression.
+struct Comparison {
+    enum class Verdict { Unchanged, Improved, Regressed, Insufficient };
+
+    std::string scope;           // "test" or "thread N"
+    size_t baseline_n = 0;
+    size_t current_n = 0;
+    double baseline_median = 0;
+    double current_median = 0;
+    double change = 0;           // relative change of the medians
+    RankTest test;
+    Verdict verdict = Verdict::Insufficient;
+
+    const char* verdictName() const {
+        switch (verdict) {
+            case Verdict::Unchanged:    return "unchanged";
+            case Verdict::Improved:     return "improved";
+            case Verdict::Regressed:    return "regressed";
+            case Verdict::Insufficient: return "insufficient";
+        }
+        return "";
+    }
+};
+
+#endif // STATS_HPP
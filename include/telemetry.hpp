@@ -0,0 +1,360 @@
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <optional>
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+#include "procstat.hpp"
+#include "progress.hpp"
+#include "rapl.hpp"
+#include "thermal.hpp"
+
+// One machine-wide reading. Plain data so the ring can copy it around.
+struct TelemetrySample {
+    double t = 0;           // seconds since the sampler started
+    float cpu_temp = 0;     // package temperature, degrees C (0 without a sensor)
+    float cpu_usage = 0;    // percent busy over the last interval, all CPUs
+    float memory_usage = 0; // percent of MemTotal not available
+    float ram_gb_used = 0;
+    float ram_gb_total = 0;
+    float package_watts = 0; // 0 without RAPL
+    int cpu_mhz = 0;         // mean scaling_cur_freq over all CPUs (0 without cpufreq)
+    bool throttling = false; // a throttle counter moved during the interval
+};
+
+// Single-producer ring with lock-free readers. Every slot carries a sequence
+// number that is odd while the producer writes it (a per-slot seqlock), so a
+// reader that raced with an overwrite sees the change and retries or drops
+// that slot. The producer never waits for readers.
+template<typename T, size_t N>
+class TelemetryRing {
+    static_assert((N & (N - 1)) == 0, "capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+    static constexpr size_t CAPACITY = N;
+
+    void push(const T& value) {
+        const uint64_t n = head_.load(std::memory_order_relaxed);
+        Slot& s = slots_[n & (N - 1)];
+        const uint64_t seq = s.seq.load(std::memory_order_relaxed);
+        s.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&s.value, &value, sizeof(T));
+        s.seq.store(seq + 2, std::memory_order_release);
+        head_.store(n + 1, std::memory_order_release);
+    }
+
+    // Samples pushed so far; slot i is valid for i in [count - CAPACITY, count)
+    uint64_t count() const { return head_.load(std::memory_order_acquire); }
+
+    // Copy of sample i, or nothing if it has been or is being overwritten.
+    // Slot i & (N-1) has been written i / N + 1 times once sample i is in,
+    // so any other even sequence number means a different sample.
+    std::optional<T> read(uint64_t i) const {
+        const uint64_t head = count();
+        if (i >= head || head - i > N) return std::nullopt;
+        const Slot& s = slots_[i & (N - 1)];
+        const uint64_t expected = 2 * (i / N + 1);
+        for (int attempt = 0; attempt < 4; ++attempt) {
+            const uint64_t before = s.seq.load(std::memory_order_acquire);
+            if (before > expected) return std::nullopt;
+            if (before != expected) continue;
+            T out;
+            std::memcpy(&out, &s.value, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.seq.load(std::memory_order_relaxed) == expected) return out;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<T> latest() const {
+        const uint64_t head = count();
+        return head ? read(head - 1) : std::nullopt;
+    }
+
+    // Up to n most recent samples, oldest first
+    std::vector<T> recent(size_t n) const {
+        const uint64_t head = count();
+        const uint64_t first = head - std::min<uint64_t>({head, n, N});
+        std::vector<T> out;
+        out.reserve(head - first);
+        for (uint64_t i = first; i < head; ++i) {
+            if (auto v = read(i)) out.push_back(*v);
+        }
+        return out;
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq{0};
+        T value{};
+    };
+
+    std::array<Slot, N> slots_{};
+    alignas(64) std::atomic<uint64_t> head_{0};
+};
+
+// Per-CPU rows next to the machine-wide samples, same seqlock scheme as
+// TelemetryRing. The row width (CPU count) is only known at runtime, so each
+// metric is its own CAPACITY x width array: one metric of one CPU over time
+// is a strided walk, one sample of all CPUs is contiguous.
+class CoreRing {
+public:
+    static constexpr size_t CAPACITY = 256;
+    enum Metric { USAGE, MHZ, TEMP, RATE, METRICS }; // RATE: iterations/s of the worker on that CPU
+
+    explicit CoreRing(size_t width) : width_(width), seq_(CAPACITY), data_(METRICS * CAPACITY * width) {}
+
+    size_t width() const { return width_; }
+    uint64_t count() const { return head_.load(std::memory_order_acquire); }
+
+    // rows[m] holds width() values of metric m
+    void push(const std::array<const float*, METRICS>& rows) {
+        const uint64_t n = head_.load(std::memory_order_relaxed);
+        const size_t slot = n & (CAPACITY - 1);
+        const uint64_t seq = seq_[slot].load(std::memory_order_relaxed);
+        seq_[slot].store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t m = 0; m < METRICS; ++m) std::memcpy(row(m, slot), rows[m], width_ * sizeof(float));
+        seq_[slot].store(seq + 2, std::memory_order_release);
+        head_.store(n + 1, std::memory_order_release);
+    }
+
+    // Copy row i of every metric into rows[m] (width() floats each); false if
+    // it is gone or was being overwritten
+    bool read(uint64_t i, const std::array<float*, METRICS>& rows) const {
+        const uint64_t head = count();
+        if (i >= head || head - i > CAPACITY) return false;
+        const size_t slot = i & (CAPACITY - 1);
+        const uint64_t expected = 2 * (i / CAPACITY + 1);
+        if (seq_[slot].load(std::memory_order_acquire) != expected) return false;
+        for (size_t m = 0; m < METRICS; ++m) std::memcpy(rows[m], row(m, slot), width_ * sizeof(float));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return seq_[slot].load(std::memory_order_relaxed) == expected;
+    }
+
+private:
+    float* row(size_t metric, size_t slot) { return data_.data() + (metric * CAPACITY + slot) * width_; }
+    const float* row(size_t metric, size_t slot) const { return data_.data() + (metric * CAPACITY + slot) * width_; }
+
+    const size_t width_;
+    std::vector<std::atomic<uint64_t>> seq_;
+    std::vector<float> data_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+};
+
+// Headless sampler: one thread, pinned to a housekeeping CPU, reading procfs
+// and sysfs at a fixed rate through descriptors opened once (pread, no
+// ifstream per sample) and publishing into a TelemetryRing. It never touches
+// GL; the ImGui monitor is just another reader of ring(). start()/stop() are
+// reference counted so the GUI and a quiet run can share one sampler.
+class Telemetry {
+public:
+    static constexpr double MIN_HZ = 1;
+    static constexpr double MAX_HZ = 10;
+    using Ring = TelemetryRing<TelemetrySample, 1024>;
+
+    static Telemetry& getInstance() {
+        static Telemetry instance;
+        return instance;
+    }
+
+    // Takes effect on the next start(); hz is clamped to [MIN_HZ, MAX_HZ]
+    void setRate(double hz) { hz_ = std::clamp(hz, MIN_HZ, MAX_HZ); }
+    double rate() const { return hz_; }
+    // Logical CPU for the sampler thread; -1 leaves it unpinned
+    void setCpu(int cpu) { cpu_ = cpu; }
+    int cpu() const { return cpu_; }
+
+    void start() {
+        std::lock_guard lock(mutex_);
+        if (users_++ > 0) return;
+        stopping_ = false;
+        thread_ = std::thread([this] { loop(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard lock(mutex_);
+            if (users_ == 0 || --users_ > 0) return;
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        if (thread_.joinable()) thread_.join();
+    }
+
+    bool running() {
+        std::lock_guard lock(mutex_);
+        return users_ > 0;
+    }
+
+    const Ring& ring() const { return ring_; }
+    // Per-CPU usage, frequency, temperature and worker rate, slot order of ThermalSensors::cpus()
+    const CoreRing& cores() const { return cores_; }
+
+private:
+    Telemetry() : cores_(ThermalSensors::getInstance().cpus().size()) {
+        meminfo_fd_ = open("/proc/meminfo", O_RDONLY | O_CLOEXEC);
+    }
+
+    ~Telemetry() {
+        {
+            std::lock_guard lock(mutex_);
+            users_ = 0;
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        if (thread_.joinable()) thread_.join();
+        if (meminfo_fd_ >= 0) close(meminfo_fd_);
+    }
+
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+
+    void loop() {
+        if (cpu_ >= 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu_, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        }
+        using clock = std::chrono::steady_clock;
+        const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / hz_));
+        const auto origin = clock::now();
+        State state;
+        state.usage.resize(cores_.width());
+        state.mhz.resize(cores_.width());
+        state.temp.resize(cores_.width());
+        state.rate.resize(cores_.width());
+        sample(state, origin); // primes the interval counters
+
+        std::unique_lock lock(mutex_);
+        for (auto next = origin + period; !wake_.wait_until(lock, next, [this] { return stopping_; }); next += period) {
+            lock.unlock();
+            const TelemetrySample s = sample(state, origin);
+            cores_.push({state.usage.data(), state.mhz.data(), state.temp.data(), state.rate.data()});
+            ring_.push(s);
+            lock.lock();
+        }
+    }
+
+    // Previous counters, to turn cumulative values into per-interval ones
+    struct State {
+        CpuTimes::Times all;
+        std::vector<CpuTimes::Times> times; // by CPU id
+        ThermalSensors::Snapshot thermal;
+        Rapl::Reading energy;
+        ProgressMeter progress;
+        std::vector<float> usage, mhz, temp, rate; // per CPU slot, filled by sample()
+    };
+
+    TelemetrySample sample(State& state, std::chrono::steady_clock::time_point origin) const {
+        TelemetrySample s;
+        s.t = std::chrono::duration<double>(std::chrono::steady_clock::now() - origin).count();
+
+        CpuTimes::Times all;
+        std::vector<CpuTimes::Times> times;
+        if (CpuTimes::getInstance().read(all, times)) {
+            if (state.all.total) s.cpu_usage = CpuTimes::usage(state.all, all);
+            const auto& cpus = ThermalSensors::getInstance().cpus();
+            for (size_t i = 0; i < cpus.size(); ++i) {
+                const unsigned id = cpus[i];
+                state.usage[i] = id < times.size() && id < state.times.size() ? CpuTimes::usage(state.times[id], times[id]) : 0.0f;
+            }
+            state.all = all;
+            state.times = std::move(times);
+        }
+
+        char buf[4096];
+        if (readFile(meminfo_fd_, buf, sizeof(buf))) {
+            const double total = meminfoKb(buf, "MemTotal:");
+            const double available = meminfoKb(buf, "MemAvailable:");
+            s.ram_gb_total = static_cast<float>(total / 1024 / 1024);
+            s.ram_gb_used = static_cast<float>((total - available) / 1024 / 1024);
+            s.memory_usage = total > 0 ? static_cast<float>(100 * (total - available) / total) : 0.0f;
+        }
+
+        const ThermalSensors& sensors = ThermalSensors::getInstance();
+        ThermalSensors::Snapshot thermal = sensors.read();
+        s.cpu_temp = static_cast<float>(thermal.package_c);
+        for (size_t i = 0; i < thermal.khz.size() && i < state.mhz.size(); ++i) {
+            state.mhz[i] = static_cast<float>(thermal.khz[i]) / 1000.0f;
+            state.temp[i] = thermal.core_c[i];
+        }
+        if (!thermal.khz.empty() && sensors.hasFrequency()) {
+            uint64_t khz = 0;
+            for (unsigned f : thermal.khz) khz += f;
+            s.cpu_mhz = static_cast<int>(khz / thermal.khz.size() / 1000);
+        }
+        if (!state.thermal.core_throttle.empty()) {
+            for (size_t i = 0; i < thermal.core_throttle.size(); ++i) {
+                s.throttling |= thermal.core_throttle[i] > state.thermal.core_throttle[i] ||
+                                thermal.package_throttle[i] > state.thermal.package_throttle[i];
+            }
+        }
+        state.thermal = std::move(thermal);
+
+        // Workers of the trial in flight, by the CPU they are pinned to
+        std::ranges::fill(state.rate, 0.0f);
+        const ProgressBoard::Reading progress = ProgressBoard::getInstance().read();
+        const std::vector<double>& rates = state.progress.update(progress);
+        const auto& slots = sensors.cpus();
+        for (size_t i = 0; i < rates.size(); ++i) {
+            const auto it = std::ranges::find(slots, progress.cpus[i]);
+            if (it != slots.end()) state.rate[static_cast<size_t>(it - slots.begin())] += static_cast<float>(rates[i]);
+        }
+
+        const Rapl& rapl = Rapl::getInstance();
+        if (rapl.available()) {
+            Rapl::Reading now = rapl.read();
+            if (!state.energy.raw.empty()) {
+                s.package_watts = static_cast<float>(rapl.delta(state.energy, now).watts(ENERGY_PACKAGE));
+            }
+            state.energy = std::move(now);
+        }
+        return s;
+    }
+
+    static bool readFile(int fd, char* buf, size_t size) {
+        if (fd < 0) return false;
+        const ssize_t n = pread(fd, buf, size - 1, 0);
+        if (n <= 0) return false;
+        buf[n] = '\0';
+        return true;
+    }
+
+    static double meminfoKb(const char* text, const char* key) {
+        const char* line = std::strstr(text, key);
+        return line ? std::strtod(line + std::strlen(key), nullptr) : 0.0;
+    }
+
+    Ring ring_;
+    CoreRing cores_;
+    int meminfo_fd_ = -1;
+    double hz_ = 4;
+    int cpu_ = -1;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    unsigned users_ = 0;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+#endif // TELEMETRY_HPP
@@ -0,0 +1,393 @@
+#ifndef THERMAL_HPP
+#define THERMAL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "procstat.hpp"
+#include "topology.hpp"
+
+// Per-CPU throttle counters, frequency and temperature plus package
+// temperature, read from sysfs through descriptors opened once:
+//   cpuN/thermal_throttle/{core,package}_throttle_count  (Intel therm_throt)
+//   cpuN/cpufreq/scaling_cur_freq                         (any cpufreq driver)
+//   hwmon coretemp "Package id N", k10temp/zenpower Tdie/Tctl, or the
+//   x86_pkg_temp thermal zone, hottest package wins
+//   hwmon coretemp "Core N" per core; k10temp/zenpower TccdN per CCD, where
+//   the CCDs of a package are matched to its L3 domains in CPU id order
+// Anything missing reads as 0 and the matching has*() is false.
+class ThermalSensors {
+public:
+    struct Snapshot {
+        std::chrono::steady_clock::time_point when;
+        std::vector<uint64_t> core_throttle;    // per CPU, cumulative
+        std::vector<uint64_t> package_throttle; // per CPU, cumulative
+        std::vector<unsigned> khz;              // per CPU
+        std::vector<float> core_c;              // per CPU, its core's or CCD's sensor
+        double package_c = 0;
+    };
+
+    static ThermalSensors& getInstance() {
+        static ThermalSensors instance;
+        return instance;
+    }
+
+    // Logical CPU id of each per-CPU slot in a snapshot
+    const std::vector<unsigned>& cpus() const { return cpus_; }
+    bool hasThrottleCounters() const { return has_throttle_; }
+    bool hasFrequency() const { return has_freq_; }
+    bool hasTemperature() const { return !temp_fds_.empty(); }
+    bool hasCoreTemperature() const { return !core_temp_fds_.empty(); }
+
+    Snapshot read() const {
+        Snapshot s;
+        s.when = std::chrono::steady_clock::now();
+        s.core_throttle.resize(cpus_.size());
+        s.package_throttle.resize(cpus_.size());
+        s.khz.resize(cpus_.size());
+        for (size_t i = 0; i < cpus_.size(); ++i) {
+            s.core_throttle[i] = readNumber(core_fds_[i]);
+            s.package_throttle[i] = readNumber(package_fds_[i]);
+            s.khz[i] = static_cast<unsigned>(readNumber(freq_fds_[i]));
+        }
+        for (int fd : temp_fds_) s.package_c = std::max(s.package_c, static_cast<double>(readNumber(fd)) / 1000.0);
+        // several CPUs share a sensor; read each one once
+        std::vector<float> sensors(core_temp_fds_.size());
+        for (size_t i = 0; i < sensors.size(); ++i) sensors[i] = static_cast<float>(readNumber(core_temp_fds_[i])) / 1000.0f;
+        s.core_c.resize(cpus_.size());
+        for (size_t i = 0; i < cpus_.size(); ++i) s.core_c[i] = core_temp_of_[i] >= 0 ? sensors[core_temp_of_[i]] : 0.0f;
+        return s;
+    }
+
+private:
+    ThermalSensors() {
+        const std::string base = "/sys/devices/system/cpu/cpu";
+        for (const auto& cpu : Topology::getInstance().cpus()) {
+            const std::string dir = base + std::to_string(cpu.id) + "/";
+            cpus_.push_back(cpu.id);
+            core_fds_.push_back(openFile(dir + "thermal_throttle/core_throttle_count"));
+            package_fds_.push_back(openFile(dir + "thermal_throttle/package_throttle_count"));
+            freq_fds_.push_back(openFile(dir + "cpufreq/scaling_cur_freq"));
+            has_throttle_ |= core_fds_.back() >= 0;
+            has_freq_ |= freq_fds_.back() >= 0;
+        }
+        core_temp_of_.assign(cpus_.size(), -1);
+        findTemperature();
+    }
+
+    ~ThermalSensors() {
+        for (const auto* fds : {&core_fds_, &package_fds_, &freq_fds_, &temp_fds_, &core_temp_fds_}) {
+            for (int fd : *fds) {
+                if (fd >= 0) close(fd);
+            }
+        }
+    }
+
+    ThermalSensors(const ThermalSensors&) = delete;
+    ThermalSensors& operator=(const ThermalSensors&) = delete;
+
+    void findTemperature() {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        // hwmonN order follows driver probe order, i.e. package order
+        std::vector<fs::path> hwmons;
+        for (const auto& entry : fs::directory_iterator("/sys/class/hwmon", ec)) hwmons.push_back(entry.path());
+        std::ranges::sort(hwmons, [](const fs::path& a, const fs::path& b) {
+            return std::strtoul(a.filename().c_str() + 5, nullptr, 10) < std::strtoul(b.filename().c_str() + 5, nullptr, 10);
+        });
+
+        unsigned amd_package = 0;
+        for (const auto& hwmon : hwmons) {
+            const std::string name = readLine(hwmon / "name");
+            const bool intel = name == "coretemp";
+            if (!intel && name != "k10temp" && name != "zenpower") continue;
+
+            unsigned package = intel ? 0 : amd_package++;
+            std::string package_input;
+            std::vector<std::pair<unsigned, std::string>> sensors; // core id or CCD number, input file
+            for (int i = 1; i < 256; ++i) {
+                const std::string prefix = (hwmon / ("temp" + std::to_string(i))).string();
+                const std::string label = readLine(prefix + "_label");
+                if (label.starts_with("Package id ")) {
+                    package = static_cast<unsigned>(std::strtoul(label.c_str() + 11, nullptr, 10));
+                    package_input = prefix + "_input";
+                } else if (label == "Tdie" || (label == "Tctl" && package_input.empty())) {
+                    package_input = prefix + "_input"; // Tdie has no fan-curve offset, prefer it
+                } else if (intel && label.starts_with("Core ")) {
+                    sensors.emplace_back(std::strtoul(label.c_str() + 5, nullptr, 10), prefix + "_input");
+                } else if (!intel && label.starts_with("Tccd")) {
+                    sensors.emplace_back(std::strtoul(label.c_str() + 4, nullptr, 10), prefix + "_input");
+                }
+            }
+            if (!package_input.empty()) {
+                const int fd = openFile(package_input);
+                if (fd >= 0) temp_fds_.push_back(fd);
+            }
+            if (sensors.empty()) continue;
+            std::ranges::sort(sensors);
+
+            // k10temp has no CPU mapping: spread the package's L3 domains over
+            // its CCDs in order (two CCX per CCD on Zen 2, one from Zen 3 on)
+            std::vector<unsigned> l3s;
+            const auto& topo = Topology::getInstance().cpus();
+            for (const auto& cpu : topo) {
+                if (cpu.package == package) l3s.push_back(cpu.l3);
+            }
+            std::ranges::sort(l3s);
+            l3s.erase(std::unique(l3s.begin(), l3s.end()), l3s.end());
+
+            for (size_t k = 0; k < sensors.size(); ++k) {
+                const int fd = openFile(sensors[k].second);
+                if (fd < 0) continue;
+                const int index = static_cast<int>(core_temp_fds_.size());
+                core_temp_fds_.push_back(fd);
+                for (size_t slot = 0; slot < topo.size(); ++slot) {
+                    const auto& cpu = topo[slot];
+                    if (cpu.package != package) continue;
+                    const size_t l3 = static_cast<size_t>(std::ranges::find(l3s, cpu.l3) - l3s.begin());
+                    if (intel ? cpu.core == sensors[k].first : l3 * sensors.size() / l3s.size() == k) {
+                        core_temp_of_[slot] = index;
+                    }
+                }
+            }
+        }
+        if (!temp_fds_.empty()) return;
+        for (const auto& zone : fs::directory_iterator("/sys/class/thermal", ec)) {
+            if (readLine(zone.path() / "type") != "x86_pkg_temp") continue;
+            const int fd = openFile((zone.path() / "temp").string());
+            if (fd >= 0) temp_fds_.push_back(fd);
+        }
+    }
+
+    static int openFile(const std::string& path) {
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd >= 0 && readNumber(fd) == 0 && path.ends_with("_freq")) {
+            // some virtual CPUs expose cpufreq without a live value
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    static uint64_t readNumber(int fd) {
+        if (fd < 0) return 0;
+        char buf[32];
+        const ssize_t n = pread(fd, buf, sizeof(buf) - 1, 0);
+        if (n <= 0) return 0;
+        buf[n] = '\0';
+        return std::strtoull(buf, nullptr, 10);
+    }
+
+    static std::string readLine(const std::filesystem::path& path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    std::vector<unsigned> cpus_;
+    std::vector<int> core_fds_, package_fds_, freq_fds_, temp_fds_;
+    std::vector<int> core_temp_fds_; // one per core (coretemp) or CCD (k10temp)
+    std::vector<int> core_temp_of_;  // per CPU slot, index into core_temp_fds_ or -1
+    bool has_throttle_ = false;
+    bool has_freq_ = false;
+};
+
+// A throttle counter that moved between two samples. t is seconds since the
+// start of the trial's timed window.
+struct ThrottleEvent {
+    double t = 0;
+    unsigned cpu = 0;
+    bool package = false; // package-wide (PROCHOT / package limit) rather than core
+    uint64_t count = 0;   // increments seen in this interval
+};
+
+// What the sensors saw during one trial
+struct ThermalTrace {
+    std::vector<ThrottleEvent> events;
+    std::vector<std::pair<double, double>> temperature; // (t, degrees C)
+    std::vector<double> mean_mhz;                       // per CPU, slot order of ThermalSensors::cpus()
+    bool aborted = false;                               // the temperature ceiling was reached
+
+    // Per-CPU series in slot order, one row of `cpus` values per sample time:
+    // value of slot c in sample k is at [k * cpus + c]. Usage covers the
+    // interval ending at that sample; 0 where a source is missing.
+    size_t cpus = 0;
+    std::vector<double> times;
+    std::vector<float> usage, mhz, core_c;
+
+    double peakTemperature() const {
+        double peak = 0;
+        for (const auto& [t, c] : temperature) peak = std::max(peak, c);
+        return peak;
+    }
+
+    // Least-squares slope of temperature over time, degrees C per second
+    double temperatureTrend() const {
+        const double n = static_cast<double>(temperature.size());
+        if (n < 2) return 0;
+        double st = 0, sc = 0, stt = 0, stc = 0;
+        for (const auto& [t, c] : temperature) {
+            st += t; sc += c; stt += t * t; stc += t * c;
+        }
+        const double den = n * stt - st * st;
+        return den > 0 ? (n * stc - st * sc) / den : 0.0;
+    }
+};
+
+// A throttle event next to the thread it hit: the thread's rate after the
+// event against its rate before it.
+struct ThrottleImpact {
+    unsigned trial = 0;
+    ThrottleEvent event;
+    unsigned thread = 0;
+    double change = 0; // after / before - 1
+};
+
+// Throttle event counts and temperature extremes over all measured trials
+struct ThermalSummary {
+    size_t core_events = 0;
+    size_t package_events = 0;
+    double peak_c = 0;
+    double trend = 0;   // mean per-trial slope, degrees C per second
+    double min_mhz = 0; // slowest participating CPU, mean over its trials
+    unsigned min_cpu = 0;
+    bool has_temperature = false;
+    bool aborted = false;
+    std::vector<ThrottleImpact> impacts;
+
+    // Every CPU of the machine over the measured trials, for imbalance
+    struct Core {
+        unsigned cpu = 0;
+        float usage = 0;  // mean percent busy
+        float mhz = 0;    // mean frequency
+        float peak_c = 0; // hottest reading of its core/CCD sensor
+    };
+    std::vector<Core> cores;
+
+    bool throttled() const { return core_events + package_events > 0; }
+};
+
+// Samples ThermalSensors on its own thread from construction until stop().
+// With a ceiling set, reaching it latches tripped() so the workers can stop
+// at their next chunk boundary and later trials and tests are skipped.
+class ThermalWatch {
+public:
+    static constexpr auto INTERVAL = std::chrono::milliseconds(100);
+
+    // Degrees C; 0 disables the abort
+    static void setCeiling(double celsius) { ceiling_.store(celsius); }
+    static double ceiling() { return ceiling_.load(); }
+    static bool tripped() { return tripped_.load(std::memory_order_relaxed); }
+
+    // Clear the latch once the package has cooled 5 C below the ceiling
+    static void rearm() {
+        if (!tripped()) return;
+        const double c = ThermalSensors::getInstance().read().package_c;
+        if (c < ceiling() - 5) tripped_.store(false);
+    }
+
+    explicit ThermalWatch(std::chrono::steady_clock::time_point start)
+        : start_(start), last_(ThermalSensors::getInstance().read()) {
+        CpuTimes::getInstance().read(last_all_, last_times_);
+        trace_->cpus = last_.khz.size();
+        thread_ = std::thread([this] { loop(); });
+    }
+
+    ~ThermalWatch() { stop(); }
+
+    ThermalWatch(const ThermalWatch&) = delete;
+    ThermalWatch& operator=(const ThermalWatch&) = delete;
+
+    // Take a final sample and hand over the trace; later calls return the same one
+    std::shared_ptr<const ThermalTrace> stop() {
+        {
+            std::lock_guard lock(mutex_);
+            if (stopping_) return trace_;
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+        sample();
+        const size_t samples = trace_->times.size();
+        for (size_t c = 0; c < trace_->cpus; ++c) {
+            double sum = 0;
+            for (size_t k = 0; k < samples; ++k) sum += trace_->mhz[k * trace_->cpus + c];
+            trace_->mean_mhz.push_back(samples ? sum / static_cast<double>(samples) : 0.0);
+        }
+        trace_->aborted = aborted_;
+        return trace_;
+    }
+
+private:
+    void loop() {
+        std::unique_lock lock(mutex_);
+        while (!wake_.wait_for(lock, INTERVAL, [this] { return stopping_; })) {
+            lock.unlock();
+            sample();
+            lock.lock();
+        }
+    }
+
+    void sample() {
+        ThermalSensors::Snapshot now = ThermalSensors::getInstance().read();
+        CpuTimes::Times all;
+        std::vector<CpuTimes::Times> times;
+        CpuTimes::getInstance().read(all, times);
+        const double t = std::chrono::duration<double>(now.when - start_).count();
+        const auto& cpus = ThermalSensors::getInstance().cpus();
+        trace_->times.push_back(t);
+        for (size_t i = 0; i < cpus.size(); ++i) {
+            const unsigned id = cpus[i];
+            trace_->usage.push_back(id < times.size() && id < last_times_.size()
+                                        ? CpuTimes::usage(last_times_[id], times[id]) : 0.0f);
+            trace_->mhz.push_back(static_cast<float>(now.khz[i]) / 1000.0f);
+            trace_->core_c.push_back(now.core_c[i]);
+            if (now.core_throttle[i] > last_.core_throttle[i]) {
+                trace_->events.push_back({t, cpus[i], false, now.core_throttle[i] - last_.core_throttle[i]});
+            }
+            if (now.package_throttle[i] > last_.package_throttle[i]) {
+                trace_->events.push_back({t, cpus[i], true, now.package_throttle[i] - last_.package_throttle[i]});
+            }
+        }
+        if (ThermalSensors::getInstance().hasTemperature()) {
+            trace_->temperature.emplace_back(t, now.package_c);
+            const double limit = ceiling();
+            if (limit > 0 && now.package_c >= limit) {
+                aborted_ = true;
+                tripped_.store(true);
+            }
+        }
+        last_ = std::move(now);
+        last_times_ = std::move(times);
+    }
+
+    inline static std::atomic<double> ceiling_{0};
+    inline static std::atomic<bool> tripped_{false};
+
+    const std::chrono::steady_clock::time_point start_;
+    ThermalSensors::Snapshot last_;
+    CpuTimes::Times last_all_;
+    std::vector<CpuTimes::Times> last_times_;
+    bool aborted_ = false;
+    std::shared_ptr<ThermalTrace> trace_ = std::make_shared<ThermalTrace>();
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+#endif // THERMAL_HPP
@@ -0,0 +1,330 @@
+#ifndef TOPDOWN_HPP
+#define TOPDOWN_HPP
+
+#include "perf.hpp"
+#include <algorithm>
+#include <array>
+#include <cpuid.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Raw inputs of the top-down model, by role. Each backend fills the roles
+// it has events for; TopDown::compute works out what the roles allow.
+enum TopdownRole {
+    TD_SLOTS,         // issue slots (Intel) or unhalted cycles (AMD, * width)
+    TD_RETIRING,      // slots that retired uops / retired ops
+    TD_BAD_SPEC,      // slots wasted on mis-speculation (perf-metrics only)
+    TD_FE_BOUND,      // slots the frontend left empty
+    TD_BE_BOUND,      // slots the backend could not accept
+    TD_MEM_BOUND,     // level 2: backend slots stalled on memory
+    TD_ISSUED,        // uops issued / ops dispatched (bad spec = issued - retired)
+    TD_RECOVERY,      // Intel pre-ICL recovery bubbles
+    TD_STALL_ALL,     // AMD: cycles retire was blocked by an incomplete op
+    TD_STALL_LOAD,    // AMD: ... by an incomplete load
+    TD_ROLE_COUNT
+};
+
+struct TopdownCounts {
+    std::array<double, TD_ROLE_COUNT> value{};
+    std::array<bool, TD_ROLE_COUNT> valid{};
+
+    bool has(int role) const { return valid[role]; }
+
+    TopdownCounts& operator+=(const TopdownCounts& other) {
+        for (int r = 0; r < TD_ROLE_COUNT; ++r) {
+            if (!other.valid[r]) continue;
+            value[r] += other.value[r];
+            valid[r] = true;
+        }
+        return *this;
+    }
+};
+
+// Which events the running CPU offers, decided once:
+//   perf-metrics  Intel Icelake+ `slots` + `topdown-*` (level 2 on SPR+)
+//   intel-slots   Intel Skylake-era `topdown-total-slots` & co
+//   amd-zen       Zen4/Zen5 PMCx1A0 dispatch-slot events
+//   approx        formulas over the generic counters of perf.hpp
+class TopdownModel {
+public:
+    enum class Method { Approx, PerfMetrics, IntelSlots, AmdZen };
+
+    static TopdownModel& getInstance() {
+        static TopdownModel instance;
+        return instance;
+    }
+
+    Method method() const { return method_; }
+    double width() const { return width_; }
+
+    const char* name() const {
+        switch (method_) {
+            case Method::PerfMetrics: return "perf-metrics";
+            case Method::IntelSlots:  return "intel-slots";
+            case Method::AmdZen:      return "amd-zen";
+            default:                  return "approx";
+        }
+    }
+
+    const std::vector<perf_event_attr>& attrs() const { return attrs_; }
+    const std::vector<int>& roles() const { return roles_; }
+    const std::vector<double>& scales() const { return scales_; }
+
+private:
+    TopdownModel() {
+        for (const char* pmu : {"cpu", "cpu_core"}) {
+            const std::string dir = std::string("/sys/bus/event_source/devices/") + pmu + "/";
+            if (!std::filesystem::exists(dir + "type")) continue;
+            if (std::filesystem::exists(dir + "events/slots") &&
+                std::filesystem::exists(dir + "events/topdown-retiring")) {
+                method_ = Method::PerfMetrics;
+                // slots must lead the group for the kernel to expose PERF_METRICS
+                addSysfs(dir, "slots", TD_SLOTS);
+                addSysfs(dir, "topdown-retiring", TD_RETIRING);
+                addSysfs(dir, "topdown-bad-spec", TD_BAD_SPEC);
+                addSysfs(dir, "topdown-fe-bound", TD_FE_BOUND);
+                addSysfs(dir, "topdown-be-bound", TD_BE_BOUND);
+                addSysfs(dir, "topdown-mem-bound", TD_MEM_BOUND);
+                return;
+            }
+            if (std::filesystem::exists(dir + "events/topdown-total-slots")) {
+                method_ = Method::IntelSlots;
+                addSysfs(dir, "topdown-total-slots", TD_SLOTS);
+                addSysfs(dir, "topdown-slots-retired", TD_RETIRING);
+                addSysfs(dir, "topdown-slots-issued", TD_ISSUED);
+                addSysfs(dir, "topdown-fetch-bubbles", TD_FE_BOUND);
+                addSysfs(dir, "topdown-recovery-bubbles", TD_RECOVERY);
+                return;
+            }
+        }
+
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        char vendor[13] = {};
+        if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) return;
+        std::memcpy(vendor, &ebx, 4);
+        std::memcpy(vendor + 4, &edx, 4);
+        std::memcpy(vendor + 8, &ecx, 4);
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return;
+        const unsigned family = ((eax >> 8) & 0xF) + ((eax >> 20) & 0xFF);
+        const unsigned model = ((eax >> 4) & 0xF) | ((eax >> 12) & 0xF0);
+        const bool zen4 = family == 0x19 && ((model >= 0x10 && model <= 0x1F) ||
+                                             (model >= 0x60 && model <= 0x7F) ||
+                                             (model >= 0xA0 && model <= 0xAF));
+        const bool zen5 = family == 0x1A;
+        if (std::strcmp(vendor, "AuthenticAMD") == 0 && (zen4 || zen5)) {
+            method_ = Method::AmdZen;
+            width_ = zen5 ? 8 : 6;
+            addGeneric(PERF_COUNT_HW_CPU_CYCLES, TD_SLOTS);
+            addAmd(0x0C1, 0x00, TD_RETIRING);    // ex_ret_ops
+            addAmd(0x1A0, 0x01, TD_FE_BOUND);    // de_no_dispatch_per_slot.no_ops_from_frontend
+            addAmd(0x1A0, 0x1E, TD_BE_BOUND);    // de_no_dispatch_per_slot.backend_stalls
+            addAmd(0x0AA, 0x07, TD_ISSUED);      // de_src_op_disp.all
+            addAmd(0x0D6, 0x02, TD_STALL_ALL);   // ex_no_retire.not_complete
+            addAmd(0x0D6, 0xA2, TD_STALL_LOAD);  // ex_no_retire.load_not_complete
+        }
+    }
+
+    TopdownModel(const TopdownModel&) = delete;
+    TopdownModel& operator=(const TopdownModel&) = delete;
+
+    static std::string readLine(const std::string& path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    // Encode a sysfs event string ("event=0x00,umask=0x81") using the PMU's
+    // format files ("config:0-7"), so no per-generation tables are needed.
+    void addSysfs(const std::string& dir, const std::string& event, int role) {
+        const std::string spec = readLine(dir + "events/" + event);
+        if (spec.empty()) return;
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = static_cast<uint32_t>(std::stoul(readLine(dir + "type")));
+
+        std::stringstream terms(spec);
+        std::string term;
+        while (std::getline(terms, term, ',')) {
+            const auto eq = term.find('=');
+            const std::string field = term.substr(0, eq);
+            const uint64_t value = eq == std::string::npos ? 1 : std::stoull(term.substr(eq + 1), nullptr, 0);
+            const std::string format = readLine(dir + "format/" + field); // e.g. "config:0-7,21"
+            const auto colon = format.find(':');
+            if (colon == std::string::npos) continue;
+            __u64* target = format.starts_with("config2") ? &attr.config2
+                             : format.starts_with("config1") ? &attr.config1 : &attr.config;
+            std::stringstream ranges(format.substr(colon + 1));
+            std::string range;
+            unsigned shift = 0;
+            while (std::getline(ranges, range, ',')) {
+                const auto dash = range.find('-');
+                const unsigned lo = static_cast<unsigned>(std::stoul(range.substr(0, dash)));
+                const unsigned hi = dash == std::string::npos ? lo : static_cast<unsigned>(std::stoul(range.substr(dash + 1)));
+                for (unsigned bit = lo; bit <= hi; ++bit, ++shift) {
+                    if ((value >> shift) & 1) *target |= uint64_t{1} << bit;
+                }
+            }
+        }
+
+        const std::string scale = readLine(dir + "events/" + event + ".scale");
+        attrs_.push_back(attr);
+        roles_.push_back(role);
+        scales_.push_back(scale.empty() ? 1.0 : std::stod(scale));
+    }
+
+    void addGeneric(uint64_t config, int role) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attrs_.push_back(attr);
+        roles_.push_back(role);
+        scales_.push_back(1.0);
+    }
+
+    // AMD raw encoding: event[7:0] | umask << 8 | event[11:8] << 32
+    void addAmd(uint64_t event, uint64_t umask, int role) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_RAW;
+        attr.config = (event & 0xFF) | (umask << 8) | ((event & 0xF00) << 24);
+        attrs_.push_back(attr);
+        roles_.push_back(role);
+        scales_.push_back(1.0);
+    }
+
+    Method method_ = Method::Approx;
+    double width_ = 4; // slots per cycle used by the approximation
+    std::vector<perf_event_attr> attrs_;
+    std::vector<int> roles_;
+    std::vector<double> scales_;
+};
+
+// Per-worker group for the model's events; empty in approx mode.
+class TopdownGroup {
+public:
+    TopdownGroup() : group_(TopdownModel::getInstance().attrs()) {}
+
+    void start() const { group_.start(); }
+    void stop() const { group_.stop(); }
+
+    TopdownCounts read() const {
+        const TopdownModel& model = TopdownModel::getInstance();
+        TopdownCounts counts;
+        const auto values = group_.read();
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (!values[i]) continue;
+            counts.value[model.roles()[i]] = static_cast<double>(*values[i]) * model.scales()[i];
+            counts.valid[model.roles()[i]] = true;
+        }
+        return counts;
+    }
+
+private:
+    EventGroup group_;
+};
+
+// Level-1 breakdown as fractions of issue slots, plus the level-2 split of
+// Backend Bound into Memory and Core. Fields the inputs could not support
+// are flagged rather than guessed (frontend has no generic approximation).
+struct TopDown {
+    double retiring = 0, bad_spec = 0, frontend = 0, backend = 0;
+    double memory = 0, core = 0;
+    bool valid = false;
+    bool frontend_valid = false;
+    bool memory_approx = false; // memory/core split estimated from miss counts
+    const char* method = "approx";
+
+    // Rough per-event stall costs for the approximations, in core cycles
+    static constexpr double MISPREDICT_PENALTY = 20;
+    static constexpr double L2_HIT_PENALTY = 12;
+    static constexpr double LLC_MISS_PENALTY = 200;
+
+    static TopDown compute(const TopdownCounts& t, const PerfCounts& p) {
+        const TopdownModel& model = TopdownModel::getInstance();
+        TopDown d;
+        d.method = model.name();
+        auto frac = [](double part, double whole) { return whole > 0 ? std::clamp(part / whole, 0.0, 1.0) : 0.0; };
+
+        switch (model.method()) {
+            case TopdownModel::Method::PerfMetrics: {
+                if (!t.has(TD_RETIRING) || !t.has(TD_BAD_SPEC) || !t.has(TD_FE_BOUND) || !t.has(TD_BE_BOUND)) break;
+                const double sum = t.value[TD_RETIRING] + t.value[TD_BAD_SPEC] + t.value[TD_FE_BOUND] + t.value[TD_BE_BOUND];
+                d.retiring = frac(t.value[TD_RETIRING], sum);
+                d.bad_spec = frac(t.value[TD_BAD_SPEC], sum);
+                d.frontend = frac(t.value[TD_FE_BOUND], sum);
+                d.backend = frac(t.value[TD_BE_BOUND], sum);
+                d.valid = d.frontend_valid = true;
+                if (t.has(TD_MEM_BOUND)) {
+                    d.memory = std::min(d.backend, frac(t.value[TD_MEM_BOUND], sum));
+                    d.core = d.backend - d.memory;
+                    return d;
+                }
+                break;
+            }
+            case TopdownModel::Method::IntelSlots: {
+                if (!t.has(TD_SLOTS) || !t.has(TD_RETIRING) || !t.has(TD_ISSUED) ||
+                    !t.has(TD_FE_BOUND) || !t.has(TD_RECOVERY)) break;
+                const double slots = t.value[TD_SLOTS];
+                d.frontend = frac(t.value[TD_FE_BOUND], slots);
+                d.bad_spec = frac(t.value[TD_ISSUED] - t.value[TD_RETIRING] + t.value[TD_RECOVERY], slots);
+                d.retiring = frac(t.value[TD_RETIRING], slots);
+                d.backend = std::max(0.0, 1.0 - d.frontend - d.bad_spec - d.retiring);
+                d.valid = d.frontend_valid = true;
+                break;
+            }
+            case TopdownModel::Method::AmdZen: {
+                if (!t.has(TD_SLOTS) || !t.has(TD_RETIRING) || !t.has(TD_FE_BOUND) ||
+                    !t.has(TD_BE_BOUND) || !t.has(TD_ISSUED)) break;
+                const double slots = t.value[TD_SLOTS] * model.width();
+                d.frontend = frac(t.value[TD_FE_BOUND], slots);
+                d.backend = frac(t.value[TD_BE_BOUND], slots);
+                d.retiring = frac(t.value[TD_RETIRING], slots);
+                d.bad_spec = frac(std::max(0.0, t.value[TD_ISSUED] - t.value[TD_RETIRING]), slots);
+                d.valid = d.frontend_valid = true;
+                if (t.has(TD_STALL_ALL) && t.has(TD_STALL_LOAD) && t.value[TD_STALL_ALL] > 0) {
+                    d.memory = d.backend * frac(t.value[TD_STALL_LOAD], t.value[TD_STALL_ALL]);
+                    d.core = d.backend - d.memory;
+                    return d;
+                }
+                break;
+            }
+            case TopdownModel::Method::Approx:
+                break;
+        }
+
+        // Nothing precise for level 1: estimate from the generic counters.
+        // Retiring from IPC against the nominal width, bad speculation and
+        // memory stalls from miss counts times a typical penalty.
+        if (!d.valid) {
+            if (!p.has(PERF_CYCLES) || !p.has(PERF_INSTRUCTIONS) || p.value[PERF_CYCLES] == 0) return d;
+            d.method = "approx";
+            const double cycles = static_cast<double>(p.value[PERF_CYCLES]);
+            d.retiring = std::min(1.0, p.ipc() / model.width());
+            d.bad_spec = p.has(PERF_BRANCH_MISSES)
+                       ? std::min(1.0 - d.retiring, static_cast<double>(p.value[PERF_BRANCH_MISSES]) * MISPREDICT_PENALTY / cycles)
+                       : 0.0;
+            d.backend = 1.0 - d.retiring - d.bad_spec; // frontend cannot be told apart
+            d.valid = true;
+        }
+
+        // Level 2 without dedicated events: memory share of Backend Bound from misses
+        if (p.has(PERF_CYCLES) && p.value[PERF_CYCLES] > 0 && (p.has(PERF_L1D_MISSES) || p.has(PERF_LLC_MISSES))) {
+            const double llc = p.has(PERF_LLC_MISSES) ? static_cast<double>(p.value[PERF_LLC_MISSES]) : 0.0;
+            const double l1d = p.has(PERF_L1D_MISSES) ? static_cast<double>(p.value[PERF_L1D_MISSES]) : llc;
+            const double stall = (std::max(0.0, l1d - llc) * L2_HIT_PENALTY + llc * LLC_MISS_PENALTY) /
+                                 static_cast<double>(p.value[PERF_CYCLES]);
+            d.memory = std::min(d.backend, stall);
+            d.core = d.backend - d.memory;
+            d.memory_approx = true;
+        }
+        return d;
+    }
+};
+
+#endif // TOPDOWN_HPP
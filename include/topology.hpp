@@ -0,0 +1,322 @@
+#ifndef TOPOLOGY_HPP
+#define TOPOLOGY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Where worker threads go. Linear is the historical worker i -> CPU i layout;
+// the others are derived from the sysfs topology so the same policy gives the
+// same physical layout on every boot, whatever order the BIOS numbered CPUs in.
+enum class Placement {
+    Linear,   // worker i on logical CPU i
+    Physical, // one worker per physical core, SMT siblings left idle
+    SmtPairs, // fill both siblings of a core before moving to the next
+    SpreadL3, // round-robin physical cores across L3 domains (CCX/CCD)
+    PackCcx,  // fill a single L3 domain
+    PackNode  // fill a single NUMA node
+};
+
+inline const char* placementName(Placement p) {
+    switch (p) {
+        case Placement::Linear:   return "linear";
+        case Placement::Physical: return "physical";
+        case Placement::SmtPairs: return "smt";
+        case Placement::SpreadL3: return "spread-l3";
+        case Placement::PackCcx:  return "pack-ccx";
+        case Placement::PackNode: return "pack-node";
+    }
+    return "linear";
+}
+
+inline std::optional<Placement> parsePlacement(const std::string& name) {
+    for (Placement p : {Placement::Linear, Placement::Physical, Placement::SmtPairs,
+                        Placement::SpreadL3, Placement::PackCcx, Placement::PackNode}) {
+        if (name == placementName(p)) return p;
+    }
+    return std::nullopt;
+}
+
+// CPU layout read once from /sys/devices/system/cpu and /sys/devices/system/node.
+// Anything sysfs doesn't tell us falls back to "every CPU is its own core in
+// one L3 domain and one node", which degrades every policy to Linear.
+class Topology {
+public:
+    struct Cpu {
+        unsigned id = 0;
+        unsigned package = 0;
+        unsigned core = 0;   // core_id, unique within a package
+        unsigned smt = 0;    // position among the core's thread siblings
+        unsigned l3 = 0;     // index of the L3 domain (first CPU of shared_cpu_list)
+        unsigned node = 0;
+    };
+
+    // One data or unified cache of the first CPU
+    struct Cache {
+        unsigned level = 0;
+        size_t bytes = 0;
+        unsigned shared = 1; // logical CPUs sharing it
+    };
+
+    static Topology& getInstance() {
+        static Topology instance;
+        return instance;
+    }
+
+    const std::vector<Cpu>& cpus() const { return cpus_; }
+    unsigned physicalCores() const { return physical_cores_; }
+    unsigned l3Domains() const { return l3_domains_; }
+    unsigned nodes() const { return nodes_; }
+    // Innermost first; empty when sysfs has no cache directory
+    const std::vector<Cache>& caches() const { return caches_; }
+    // Last-level cache of the whole machine, every instance summed; 0 if unknown
+    size_t llcBytes() const { return llc_bytes_; }
+
+    // Logical CPU for each worker slot, in the order workers should be filled.
+    std::vector<unsigned> order(Placement p) const {
+        std::vector<Cpu> sorted = cpus_;
+        auto by = [&](auto key) {
+            std::ranges::stable_sort(sorted, [&](const Cpu& a, const Cpu& b) { return key(a) < key(b); });
+        };
+        switch (p) {
+            case Placement::Linear:
+                break;
+            case Placement::Physical:
+                by([](const Cpu& c) { return std::tuple(c.smt, c.package, c.core, c.id); });
+                break;
+            case Placement::SmtPairs:
+                by([](const Cpu& c) { return std::tuple(c.package, c.core, c.smt, c.id); });
+                break;
+            case Placement::SpreadL3: {
+                // rank of each physical core inside its L3 domain, then interleave domains
+                std::map<unsigned, unsigned> seen;
+                std::map<std::tuple<unsigned, unsigned>, unsigned> rank;
+                for (const Cpu& c : cpus_) {
+                    const auto key = std::tuple(c.package, c.core);
+                    if (c.smt == 0 && !rank.contains(key)) rank[key] = seen[c.l3]++;
+                }
+                by([&](const Cpu& c) {
+                    return std::tuple(c.smt, rank[std::tuple(c.package, c.core)], c.l3, c.id);
+                });
+                break;
+            }
+            case Placement::PackCcx:
+                by([](const Cpu& c) { return std::tuple(c.l3, c.smt, c.package, c.core, c.id); });
+                break;
+            case Placement::PackNode:
+                by([](const Cpu& c) { return std::tuple(c.node, c.l3, c.smt, c.package, c.core, c.id); });
+                break;
+        }
+        std::vector<unsigned> ids;
+        ids.reserve(sorted.size());
+        for (const Cpu& c : sorted) ids.push_back(c.id);
+        return ids;
+    }
+
+    // Natural thread count for a policy: leaving out SMT siblings or other
+    // domains is the point of Physical/Pack*, so they don't use every CPU.
+    unsigned defaultThreads(Placement p) const {
+        const unsigned first_l3 = cpus_.empty() ? 0 : order(Placement::PackCcx).front();
+        const unsigned first_node = cpus_.empty() ? 0 : order(Placement::PackNode).front();
+        switch (p) {
+            case Placement::Physical:
+                return physical_cores_;
+            case Placement::PackCcx:
+                return static_cast<unsigned>(std::ranges::count_if(cpus_, [&](const Cpu& c) {
+                    return c.l3 == cpuById(first_l3).l3;
+                }));
+            case Placement::PackNode:
+                return static_cast<unsigned>(std::ranges::count_if(cpus_, [&](const Cpu& c) {
+                    return c.node == cpuById(first_node).node;
+                }));
+            default:
+                return static_cast<unsigned>(cpus_.size());
+        }
+    }
+
+    // CPUs of the index-th L3 domain / NUMA node, in PackCcx order. Empty if out of range.
+    std::vector<unsigned> l3Domain(unsigned index) const {
+        std::vector<unsigned> firsts;
+        for (const Cpu& c : cpus_) {
+            if (std::ranges::find(firsts, c.l3) == firsts.end()) firsts.push_back(c.l3);
+        }
+        std::ranges::sort(firsts);
+        if (index >= firsts.size()) return {};
+        return filtered([&](const Cpu& c) { return c.l3 == firsts[index]; });
+    }
+
+    std::vector<unsigned> nodeCpus(unsigned node) const {
+        return filtered([&](const Cpu& c) { return c.node == node; });
+    }
+
+    std::string describe(Placement p, unsigned threads) const {
+        const auto ids = order(p);
+        std::ostringstream out;
+        out << placementName(p) << " (" << threads << " threads on CPUs ";
+        for (unsigned i = 0; i < threads && i < ids.size(); ++i) {
+            out << (i ? "," : "") << ids[i];
+        }
+        out << ")";
+        return out.str();
+    }
+
+private:
+    Topology() {
+        const std::string base = "/sys/devices/system/cpu/";
+        std::map<std::tuple<unsigned, unsigned>, size_t> last_level; // (level, first sharing CPU) -> bytes
+        std::vector<unsigned> online = parseList(readLine(base + "online"));
+        if (online.empty()) {
+            const unsigned n = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned i = 0; i < n; ++i) online.push_back(i);
+        }
+
+        for (unsigned id : online) {
+            const std::string dir = base + "cpu" + std::to_string(id) + "/";
+            Cpu c;
+            c.id = id;
+            c.package = readUnsigned(dir + "topology/physical_package_id", 0);
+            c.core = readUnsigned(dir + "topology/core_id", id);
+            const auto siblings = parseList(readLine(dir + "topology/thread_siblings_list"));
+            const auto pos = std::ranges::find(siblings, id);
+            c.smt = pos == siblings.end() ? 0 : static_cast<unsigned>(pos - siblings.begin());
+            c.l3 = id;
+            for (unsigned index = 0;; ++index) {
+                const std::string cache = dir + "cache/index" + std::to_string(index) + "/";
+                const std::string level = readLine(cache + "level");
+                if (level.empty()) break;
+                const auto shared = parseList(readLine(cache + "shared_cpu_list"));
+                if (level == "3" && !shared.empty()) c.l3 = shared.front();
+                if (readLine(cache + "type") == "Instruction") continue;
+                const Cache found{readUnsigned(cache + "level", 0), readBytes(cache + "size"),
+                                  std::max<unsigned>(1, static_cast<unsigned>(shared.size()))};
+                if (id == online.front()) caches_.push_back(found);
+                // one instance per set of CPUs sharing it
+                if (!shared.empty()) last_level[{found.level, shared.front()}] = found.bytes;
+            }
+            cpus_.push_back(c);
+        }
+
+        // No L3 information at all: treat the machine as one domain
+        if (readLine(base + "cpu" + std::to_string(online.front()) + "/cache/index3/level").empty()) {
+            for (Cpu& c : cpus_) c.l3 = cpus_.front().id;
+        }
+
+        for (unsigned node = 0;; ++node) {
+            const std::string list = readLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (list.empty()) break;
+            for (unsigned id : parseList(list)) {
+                for (Cpu& c : cpus_) {
+                    if (c.id == id) c.node = node;
+                }
+            }
+            nodes_ = node + 1;
+        }
+        nodes_ = std::max(1u, nodes_);
+
+        std::vector<std::tuple<unsigned, unsigned>> cores;
+        std::vector<unsigned> l3s;
+        for (const Cpu& c : cpus_) {
+            cores.emplace_back(c.package, c.core);
+            l3s.push_back(c.l3);
+        }
+        std::ranges::sort(cores);
+        std::ranges::sort(l3s);
+        physical_cores_ = static_cast<unsigned>(std::unique(cores.begin(), cores.end()) - cores.begin());
+        l3_domains_ = static_cast<unsigned>(std::unique(l3s.begin(), l3s.end()) - l3s.begin());
+
+        std::ranges::sort(caches_, {}, &Cache::level);
+        const unsigned top = last_level.empty() ? 0 : std::get<0>(last_level.rbegin()->first);
+        for (const auto& [key, bytes] : last_level) {
+            if (std::get<0>(key) == top) llc_bytes_ += bytes;
+        }
+    }
+
+    Topology(const Topology&) = delete;
+    Topology& operator=(const Topology&) = delete;
+
+    template<typename Pred>
+    std::vector<unsigned> filtered(Pred pred) const {
+        std::vector<unsigned> ids;
+        for (unsigned id : order(Placement::PackCcx)) {
+            if (pred(cpuById(id))) ids.push_back(id);
+        }
+        return ids;
+    }
+
+    const Cpu& cpuById(unsigned id) const {
+        for (const Cpu& c : cpus_) {
+            if (c.id == id) return c;
+        }
+        return cpus_.front();
+    }
+
+    static std::string readLine(const std::string& path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    static unsigned readUnsigned(const std::string& path, unsigned fallback) {
+        const std::string line = readLine(path);
+        try {
+            return line.empty() ? fallback : static_cast<unsigned>(std::stoul(line));
+        } catch (...) {
+            return fallback;
+        }
+    }
+
+    // sysfs cache size syntax: "48K", "2048K", "32M"
+    static size_t readBytes(const std::string& path) {
+        const std::string line = readLine(path);
+        try {
+            size_t suffix = 0;
+            const size_t n = std::stoul(line, &suffix);
+            switch (suffix < line.size() ? line[suffix] : ' ') {
+                case 'K': return n << 10;
+                case 'M': return n << 20;
+                case 'G': return n << 30;
+                default: return n;
+            }
+        } catch (...) {
+            return 0;
+        }
+    }
+
+public:
+    // sysfs cpu list syntax: "0-3,8,10-11"
+    static std::vector<unsigned> parseList(const std::string& list) {
+        std::vector<unsigned> ids;
+        std::stringstream ss(list);
+        std::string range;
+        while (std::getline(ss, range, ',')) {
+            try {
+                const auto dash = range.find('-');
+                const unsigned lo = static_cast<unsigned>(std::stoul(range.substr(0, dash)));
+                const unsigned hi = dash == std::string::npos ? lo
+                                  : static_cast<unsigned>(std::stoul(range.substr(dash + 1)));
+                for (unsigned i = lo; i <= hi; ++i) ids.push_back(i);
+            } catch (...) {
+                break;
+            }
+        }
+        return ids;
+    }
+
+private:
+    std::vector<Cpu> cpus_;
+    unsigned physical_cores_ = 1;
+    unsigned l3_domains_ = 1;
+    unsigned nodes_ = 0;
+    std::vector<Cache> caches_;
+    size_t llc_bytes_ = 0;
+};
+
+#endif // TOPOLOGY_HPP
@@ -0,0 +1,86 @@
+#ifndef TSC_HPP
+#define TSC_HPP
+
+#include <algorithm>
+#include <cpuid.h>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+#include <x86intrin.h>
+
+// Time-stamp counter backend. The TSC ticks at a fixed reference rate on any
+// CPU with an invariant TSC (CPUID 0x80000007 EDX[8]), independent of boost
+// and P-states, so cycles per iteration compare across boxes that clock
+// differently. The rate is calibrated once against CLOCK_MONOTONIC_RAW.
+class Tsc {
+public:
+    static Tsc& getInstance() {
+        static Tsc instance;
+        return instance;
+    }
+
+    bool invariant() const { return invariant_; }
+    double hz() const { return hz_; }
+    double ghz() const { return hz_ / 1e9; }
+
+    double toSeconds(uint64_t ticks) const { return hz_ > 0 ? static_cast<double>(ticks) / hz_ : 0.0; }
+
+    // Open a timed region: LFENCE keeps earlier work from being reordered
+    // past the read, the trailing one keeps the region's work after it.
+    static uint64_t begin() {
+        _mm_lfence();
+        const uint64_t t = __rdtsc();
+        _mm_lfence();
+        return t;
+    }
+
+    // Close a timed region: RDTSCP waits for all earlier instructions to
+    // retire, LFENCE stops later ones from starting before the read.
+    static uint64_t end() {
+        unsigned aux;
+        const uint64_t t = __rdtscp(&aux);
+        _mm_lfence();
+        return t;
+    }
+
+private:
+    Tsc() {
+        unsigned eax, ebx, ecx, edx;
+        if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) && eax >= 0x80000007) {
+            __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+            invariant_ = edx & (1u << 8);
+        }
+        hz_ = calibrate();
+    }
+
+    Tsc(const Tsc&) = delete;
+    Tsc& operator=(const Tsc&) = delete;
+
+    static uint64_t monotonicRawNs() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ull + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    // Median of five 10 ms windows, each bracketed so a preemption between the
+    // clock and TSC reads only costs that window.
+    static double calibrate() {
+        constexpr uint64_t WINDOW_NS = 10'000'000;
+        std::vector<double> rates;
+        for (int round = 0; round < 5; ++round) {
+            const uint64_t ns0 = monotonicRawNs();
+            const uint64_t t0 = begin();
+            uint64_t ns1 = ns0;
+            while (ns1 - ns0 < WINDOW_NS) ns1 = monotonicRawNs();
+            const uint64_t t1 = end();
+            rates.push_back(static_cast<double>(t1 - t0) * 1e9 / static_cast<double>(ns1 - ns0));
+        }
+        std::ranges::sort(rates);
+        return rates[rates.size() / 2];
+    }
+
+    bool invariant_ = false;
+    double hz_ = 0;
+};
+
+#endif // TSC_HPP
@@ -0,0 +1,142 @@
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+#include "topology.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+#include <vector>
+
+// Process-wide pool of long-lived worker threads, one per logical CPU.
+// Worker i is pinned to the i-th online CPU at startup, so tests no longer pay
+// for thread creation and core migration every time they run. setAffinity()
+// re-pins the workers when a placement policy asks for a different layout.
+class WorkerPool {
+public:
+    using Job = std::function<void(unsigned)>;
+
+    static WorkerPool& getInstance() {
+        static WorkerPool instance;
+        return instance;
+    }
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+    // Run fn(tid) on workers [0, n) and collect one result per worker.
+    template<typename R, typename F>
+    std::vector<R> run(unsigned n, F&& fn) {
+        n = std::min(n, size());
+        std::vector<R> results(n);
+        dispatch(n, [&results, &fn](unsigned tid) { results[tid] = fn(tid); });
+        return results;
+    }
+
+    // Blocking: hand job to workers [0, n) and wait until all of them return.
+    void dispatch(unsigned n, Job job) {
+        start(n, std::move(job));
+        wait();
+    }
+
+    // Non-blocking variant for callers that need to do work of their own
+    // (progress output, sampling) while the workers run. Pair with wait().
+    void start(unsigned n, Job job) {
+        std::unique_lock lock(mutex_);
+        idle_.wait(lock, [this] { return pending_ == 0; });
+        job_ = std::move(job);
+        active_ = std::min(n, size());
+        pending_ = active_;
+        ++generation_;
+        wake_.notify_all();
+    }
+
+    void wait() {
+        std::unique_lock lock(mutex_);
+        idle_.wait(lock, [this] { return pending_ == 0; });
+        job_ = nullptr;
+    }
+
+    // Pin worker i to cpus[i % cpus.size()]. Each worker pins itself, since
+    // that is the only way to be sure it has migrated before the next job.
+    void setAffinity(const std::vector<unsigned>& cpus) {
+        if (cpus.empty()) return;
+        dispatch(size(), [&cpus](unsigned tid) { pinThread(cpus[tid % cpus.size()]); });
+        std::lock_guard lock(mutex_);
+        for (unsigned i = 0; i < size(); ++i) pinned_[i] = cpus[i % cpus.size()];
+    }
+
+    // Logical CPU worker tid is currently pinned to
+    unsigned cpuOf(unsigned tid) {
+        std::lock_guard lock(mutex_);
+        return pinned_[tid % pinned_.size()];
+    }
+
+private:
+    WorkerPool() : cpus_(Topology::getInstance().order(Placement::Linear)), pinned_(cpus_) {
+        workers_.reserve(cpus_.size());
+        for (unsigned i = 0; i < cpus_.size(); ++i) {
+            workers_.emplace_back(&WorkerPool::loop, this, i);
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+            ++generation_;
+        }
+        wake_.notify_all();
+        for (auto& t : workers_) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    static void pinThread(unsigned core) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(core, &cpuset);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+    }
+
+    void loop(unsigned tid) {
+        pinThread(cpus_[tid]);
+        uint64_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [&] { return generation_ != seen; });
+                seen = generation_;
+                if (stopping_) return;
+                if (tid >= active_) continue;
+            }
+            // job_ is only replaced once every active worker has checked in,
+            // so reading it outside the lock is safe.
+            job_(tid);
+            {
+                std::lock_guard lock(mutex_);
+                if (--pending_ == 0) idle_.notify_all();
+            }
+        }
+    }
+
+    const std::vector<unsigned> cpus_; // initial layout, online CPUs in id order
+    std::vector<unsigned> pinned_;     // current layout after setAffinity()
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    Job job_;
+    unsigned active_ = 0;
+    unsigned pending_ = 0;
+    uint64_t generation_ = 0;
+    bool stopping_ = false;
+};
+
+#endif // WORKERPOOL_HPP
@@ -0,0 +1,564 @@
+#ifndef WORKLOAD_HPP
+#define WORKLOAD_HPP
+
+#include "cancel.hpp"
+#include "perf.hpp"
+#include "progress.hpp"
+#include "rapl.hpp"
+#include "stats.hpp"
+#include "thermal.hpp"
+#include "topdown.hpp"
+#include "tsc.hpp"
+#include "workerpool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Barrier for the worker pool: every worker spins until the last one arrives,
+// so all of them leave within a few hundred cycles of each other. Falls back to
+// yielding after a while so an oversubscribed box doesn't livelock.
+class SpinBarrier {
+public:
+    explicit SpinBarrier(unsigned count) : count_(count) {}
+
+    void arrive_and_wait() {
+        arrive_and_wait([] {});
+    }
+
+    // on_complete runs on the last thread to arrive, before anyone is released.
+    template<typename F>
+    void arrive_and_wait(F&& on_complete) {
+        const unsigned gen = generation_.load(std::memory_order_acquire);
+        if (arrived_.fetch_add(1, std::memory_order_acq_rel) + 1 == count_) {
+            on_complete();
+            arrived_.store(0, std::memory_order_relaxed);
+            generation_.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        for (unsigned spins = 0; generation_.load(std::memory_order_acquire) == gen; ++spins) {
+            if (spins < 1u << 16) {
+                __builtin_ia32_pause();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    alignas(64) std::atomic<unsigned> arrived_{0};
+    alignas(64) std::atomic<unsigned> generation_{0};
+    const unsigned count_;
+};
+
+// One worker's share of a test. setup() does allocation and pre-faulting,
+// run() is the only part that is timed, teardown() releases resources once
+// every worker has stopped measuring.
+struct Workload {
+    virtual ~Workload() = default;
+
+    // Return false if the worker cannot take part (e.g. allocation failed);
+    // it still joins the barriers but reports no work.
+    virtual bool setup() { return true; }
+    virtual void run(unsigned long iterations) = 0;
+    virtual void teardown() {}
+
+    unsigned long iterations = 0;
+    // Iterations whose result came out wrong; any of them fails the test
+    unsigned long errors = 0;
+    // What one iteration counts for in the test's unit (FLOPs, bytes); the
+    // sample's work and progress are in that unit, the live board in iterations
+    double work_per_iteration = 1;
+};
+
+using WorkloadFactory = std::function<std::unique_ptr<Workload>(unsigned tid)>;
+
+struct Sample {
+    double work = 0;    // iterations (times work_per_iteration) completed in the timed region
+    double seconds = 0; // length of the timed region
+    uint64_t cycles = 0; // TSC ticks across this worker's run() calls
+    PerfCounts perf;     // hardware counters over the same region (user mode)
+    TopdownCounts topdown; // top-down model inputs over the same region
+    EnergyCounts energy; // whole-machine RAPL energy of the trial, same in every sample of it
+    unsigned cpu = 0;    // logical CPU the worker was pinned to
+    // (seconds since start, work so far) after every chunk
+    std::vector<std::pair<double, double>> progress;
+    std::shared_ptr<const ThermalTrace> thermal; // shared by every sample of the trial
+    bool truncated = false; // stopped short of its budget by the temperature ceiling or a cancel
+    unsigned long errors = 0; // the Workload's wrong results, counted by run() or teardown()
+
+    double rate() const { return seconds > 0 ? work / seconds : 0.0; }
+
+    // Iterations done by time t, interpolated between chunk boundaries
+    double doneAt(double t) const {
+        const auto next = std::ranges::find_if(progress, [t](const auto& p) { return p.first >= t; });
+        if (next == progress.end()) return progress.empty() ? 0.0 : progress.back().second;
+        const auto [t0, w0] = next == progress.begin() ? std::pair{0.0, 0.0} : *std::prev(next);
+        const auto [t1, w1] = *next;
+        return t1 > t0 ? w0 + (w1 - w0) * (t - t0) / (t1 - t0) : w1;
+    }
+
+    // Rate before and after time t from the progress timeline; false when
+    // either side has less than MIN_SPAN seconds of chunks to go on
+    bool rateAround(double t, double& before, double& after) const {
+        constexpr double MIN_SPAN = 0.5;
+        const auto split = std::ranges::find_if(progress, [t](const auto& p) { return p.first >= t; });
+        if (split == progress.begin() || split == progress.end()) return false;
+        const auto& [t_split, w_split] = *std::prev(split);
+        const auto& [t_end, w_end] = progress.back();
+        if (t_split < MIN_SPAN || t_end - t_split < MIN_SPAN) return false;
+        before = w_split / t_split;
+        after = (w_end - w_split) / (t_end - t_split);
+        return true;
+    }
+};
+
+// How long a test runs. By default every Workload runs its own iteration
+// count; with seconds > 0 all workers instead run until a common deadline.
+struct Budget {
+    double seconds = 0;
+
+    bool timed() const { return seconds > 0; }
+};
+
+// Target length of one run() call between deadline checks and progress updates
+constexpr double CHUNK_SECONDS = 0.010;
+
+// Duration mode: time doubling probe runs until one is long enough to trust,
+// then size the chunk run between deadline checks from the per-call cost.
+// The probe doubles as warm-up and happens before the start barrier.
+inline unsigned long calibrateChunk(Workload& w) {
+    constexpr double PROBE_SECONDS = 0.005;
+    for (unsigned long n = 1;; n *= 2) {
+        const auto start = std::chrono::steady_clock::now();
+        w.run(n);
+        const double elapsed =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed >= PROBE_SECONDS || n >= 1UL << 40) {
+            const double per_call = elapsed / static_cast<double>(n);
+            return std::max(1UL, static_cast<unsigned long>(CHUNK_SECONDS / per_call));
+        }
+    }
+}
+
+// Iteration mode sizes its chunks inside the timed loop instead, so no work
+// is added to the run: start at one iteration and resize from how long the
+// last chunk took, growing at most 2x per step so one slow chunk can't
+// overshoot into a single huge call.
+inline unsigned long nextChunk(unsigned long chunk, double seconds) {
+    if (seconds <= 0) return chunk * 2;
+    const double fit = static_cast<double>(chunk) * CHUNK_SECONDS / seconds;
+    return std::clamp(static_cast<unsigned long>(fit), 1UL, chunk * 2);
+}
+
+// Three-phase run on the shared pool:
+//   1. every worker builds its Workload and runs setup() (untimed),
+//   2. all workers leave a spin barrier together and time only run(),
+//   3. a second barrier holds teardown() until the last worker has finished,
+//      so nobody's munmap/unlink lands inside somebody else's timed window.
+// run() is always called in ~10 ms chunks and every worker publishes its total
+// to the ProgressBoard after each one, so live per-thread rates can be read
+// while a long kernel runs. In duration mode the chunks run until the shared
+// deadline, in iteration mode until the Workload's count is done; both stop
+// early at a chunk boundary if the thermal watch trips its temperature ceiling
+// or a cancel is requested, and mark the sample truncated.
+inline std::vector<Sample> runWorkload(unsigned n, const WorkloadFactory& make,
+                                       const Budget& budget = {}) {
+    using clock = std::chrono::steady_clock;
+    WorkerPool& pool = WorkerPool::getInstance();
+    n = std::min(n, pool.size());
+    SpinBarrier start_line(n);
+    SpinBarrier finish_line(n);
+    clock::time_point start, deadline;
+    // Energy is package-wide, so it is sampled once by whichever worker
+    // completes each barrier rather than per thread
+    const Rapl& rapl = Rapl::getInstance();
+    ProgressBoard& board = ProgressBoard::getInstance();
+    Rapl::Reading energy_start;
+    EnergyCounts energy;
+    std::unique_ptr<ThermalWatch> watch;
+    std::shared_ptr<const ThermalTrace> thermal;
+    const auto stopping = [] { return ThermalWatch::tripped() || Cancellation::requested(); };
+
+    return pool.run<Sample>(n, [&](unsigned tid) {
+        std::unique_ptr<Workload> w = make(tid);
+        const bool ready = w && w->setup();
+        const unsigned long chunk = ready && budget.timed() ? calibrateChunk(*w) : 0;
+        const PerfGroup counters; // opened per worker thread, counts only this thread
+        const TopdownGroup slots;
+        std::vector<std::pair<double, double>> progress;
+        // ~10 ms chunks; reserved so a timed loop of known length never
+        // allocates, iteration mode grows it a handful of times at most
+        progress.reserve(chunk ? static_cast<size_t>(budget.seconds * 100) + 16 : 1024);
+        board.enter(tid, pool.cpuOf(tid));
+
+        start_line.arrive_and_wait([&] {
+            if (rapl.available()) energy_start = rapl.read();
+            // the watch's first sensor read stays out of the timed window
+            watch = std::make_unique<ThermalWatch>(clock::now());
+            start = clock::now();
+            deadline = start + std::chrono::duration_cast<clock::duration>(
+                                   std::chrono::duration<double>(budget.seconds));
+            board.begin(n, start);
+        });
+        unsigned long done = 0;
+        const double scale = ready ? w->work_per_iteration : 1.0;
+        counters.start();
+        slots.start();
+        const uint64_t t0 = Tsc::begin();
+        if (ready && budget.timed()) {
+            for (auto now = clock::now(); now < deadline && !stopping();) {
+                w->run(chunk);
+                done += chunk;
+                now = clock::now();
+                progress.emplace_back(std::chrono::duration<double>(now - start).count(), static_cast<double>(done) * scale);
+                board.publish(tid, done);
+            }
+        } else if (ready) {
+            for (unsigned long step = 1; done < w->iterations && !stopping();) {
+                const unsigned long count = std::min(step, w->iterations - done);
+                const auto before = clock::now();
+                w->run(count);
+                done += count;
+                const auto now = clock::now();
+                progress.emplace_back(std::chrono::duration<double>(now - start).count(), static_cast<double>(done) * scale);
+                board.publish(tid, done);
+                step = nextChunk(count, std::chrono::duration<double>(now - before).count());
+            }
+        }
+        const uint64_t t1 = Tsc::end();
+        slots.stop();
+        counters.stop();
+        const auto end = clock::now();
+        const bool truncated = ready && (budget.timed() ? end < deadline : done < w->iterations);
+        finish_line.arrive_and_wait([&] {
+            if (rapl.available()) energy = rapl.delta(energy_start, rapl.read());
+            thermal = watch->stop();
+            board.end();
+        });
+
+        if (ready) w->teardown();
+        return Sample{static_cast<double>(done) * scale, std::chrono::duration<double>(end - start).count(), t1 - t0,
+                      counters.read(), slots.read(), energy, pool.cpuOf(tid), std::move(progress), thermal,
+                      truncated, w ? w->errors : 0};
+    });
+}
+
+// Repeat a test per the plan: warm-up trials are run and dropped, then one
+// per-thread sample vector is returned for every measured trial. Once the
+// temperature ceiling trips, the trial in flight is kept and the rest skipped.
+// A cancel does the same, except that nothing is returned if it arrives
+// before the first measured trial.
+inline std::vector<std::vector<Sample>> runTrials(unsigned n, const WorkloadFactory& make,
+                                                  const Budget& budget, const TrialPlan& plan) {
+    const Cancellation::Scope cancellable;
+    ThermalWatch::rearm();
+    for (unsigned i = 0; i < plan.warmup && !ThermalWatch::tripped(); ++i) {
+        if (Cancellation::requested()) return {};
+        runWorkload(n, make, budget);
+    }
+    std::vector<std::vector<Sample>> trials;
+    trials.reserve(plan.measured);
+    for (unsigned i = 0; i < std::max(1u, plan.measured) && !Cancellation::requested(); ++i) {
+        if (i > 0 && ThermalWatch::tripped()) break;
+        trials.push_back(runWorkload(n, make, budget));
+    }
+    return trials;
+}
+
+// True when the trials cover less than the plan asked for: a trial was
+// skipped, or a worker stopped before its deadline or iteration count
+inline bool testTruncated(const std::vector<std::vector<Sample>>& trials, const TrialPlan& plan) {
+    if (trials.size() < std::max(1u, plan.measured)) return true;
+    for (const auto& trial : trials) {
+        if (std::ranges::any_of(trial, &Sample::truncated)) return true;
+    }
+    return false;
+}
+
+// Wrong results across every thread of the measured trials
+inline unsigned long testErrors(const std::vector<std::vector<Sample>>& trials) {
+    unsigned long errors = 0;
+    for (const auto& trial : trials) {
+        for (const Sample& s : trial) errors += s.errors;
+    }
+    return errors;
+}
+
+// Each thread's rate averaged over the measured trials.
+inline std::vector<double> threadRates(const std::vector<std::vector<Sample>>& trials) {
+    std::vector<double> rates(trials.empty() ? 0 : trials.front().size(), 0.0);
+    for (const auto& trial : trials) {
+        for (size_t i = 0; i < trial.size() && i < rates.size(); ++i) {
+            rates[i] += trial[i].rate() / static_cast<double>(trials.size());
+        }
+    }
+    return rates;
+}
+
+// Per-thread score of every measured trial: result[thread][trial]
+inline std::vector<std::vector<double>> threadTrialRates(const std::vector<std::vector<Sample>>& trials) {
+    std::vector<std::vector<double>> rates(trials.empty() ? 0 : trials.front().size());
+    for (const auto& trial : trials) {
+        for (size_t i = 0; i < trial.size() && i < rates.size(); ++i) rates[i].push_back(trial[i].rate());
+    }
+    return rates;
+}
+
+// Per-thread TSC cycles and nanoseconds per iteration over all measured trials
+// (total ticks / total iterations, so long and short trials weigh by work).
+inline std::vector<IterationCost> threadCosts(const std::vector<std::vector<Sample>>& trials) {
+    const size_t n = trials.empty() ? 0 : trials.front().size();
+    std::vector<IterationCost> costs(n);
+    for (size_t i = 0; i < n; ++i) {
+        double work = 0, cycles = 0, seconds = 0;
+        for (const auto& trial : trials) {
+            if (i >= trial.size()) continue;
+            work += trial[i].work;
+            cycles += static_cast<double>(trial[i].cycles);
+            seconds += trial[i].seconds;
+        }
+        if (work > 0) costs[i] = {cycles / work, seconds * 1e9 / work};
+    }
+    return costs;
+}
+
+// Per-thread counters summed over all measured trials
+inline std::vector<PerfCounts> threadCounters(const std::vector<std::vector<Sample>>& trials) {
+    std::vector<PerfCounts> counts(trials.empty() ? 0 : trials.front().size());
+    for (const auto& trial : trials) {
+        for (size_t i = 0; i < trial.size() && i < counts.size(); ++i) counts[i] += trial[i].perf;
+    }
+    return counts;
+}
+
+// Top-down breakdown of the whole test: every thread's and trial's counts summed
+inline TopDown testTopDown(const std::vector<std::vector<Sample>>& trials) {
+    TopdownCounts slots;
+    PerfCounts counts;
+    for (const auto& trial : trials) {
+        for (const auto& s : trial) {
+            slots += s.topdown;
+            counts += s.perf;
+        }
+    }
+    return TopDown::compute(slots, counts);
+}
+
+// One score per trial, the mean per-thread rate, which is what TrialStats summarizes.
+inline std::vector<double> trialRates(const std::vector<std::vector<Sample>>& trials) {
+    std::vector<double> rates;
+    rates.reserve(trials.size());
+    for (const auto& trial : trials) {
+        double total = 0;
+        for (const auto& s : trial) total += s.rate();
+        rates.push_back(trial.empty() ? 0.0 : total / static_cast<double>(trial.size()));
+    }
+    return rates;
+}
+
+// Energy of every measured trial against the work of all its threads
+inline EnergyUse testEnergy(const std::vector<std::vector<Sample>>& trials) {
+    EnergyUse use;
+    for (const auto& trial : trials) {
+        if (trial.empty()) continue;
+        use.energy += trial.front().energy;
+        for (const auto& s : trial) use.work += s.work;
+    }
+    return use;
+}
+
+// Throttle events of every measured trial lined up with the score of the
+// thread pinned to the throttled CPU. Package counters move on every CPU of
+// the package, so a package event reaches all of its threads the same way.
+inline std::vector<ThrottleImpact> throttleImpacts(const std::vector<std::vector<Sample>>& trials) {
+    std::vector<ThrottleImpact> out;
+    for (size_t t = 0; t < trials.size(); ++t) {
+        const auto& trial = trials[t];
+        if (trial.empty() || !trial.front().thermal) continue;
+        std::vector<bool> seen(trial.size(), false); // first event per thread only
+        for (const ThrottleEvent& e : trial.front().thermal->events) {
+            for (size_t i = 0; i < trial.size(); ++i) {
+                if (seen[i] || trial[i].cpu != e.cpu) continue;
+                double before = 0, after = 0;
+                if (!trial[i].rateAround(e.t, before, after) || before <= 0) continue;
+                seen[i] = true;
+                out.push_back({static_cast<unsigned>(t), e, static_cast<unsigned>(i), after / before - 1});
+            }
+        }
+    }
+    return out;
+}
+
+// Every thread's rate over each interval of the trial's thermal samples,
+// result[thread][sample], so it lines up with the per-CPU series
+inline std::vector<std::vector<double>> threadSeries(const std::vector<Sample>& trial) {
+    std::vector<std::vector<double>> series;
+    if (trial.empty() || !trial.front().thermal) return series;
+    const std::vector<double>& times = trial.front().thermal->times;
+    for (const Sample& s : trial) {
+        auto& rates = series.emplace_back();
+        rates.reserve(times.size());
+        double t_prev = 0, w_prev = 0;
+        for (double t : times) {
+            const double w = s.doneAt(t);
+            rates.push_back(t > t_prev ? (w - w_prev) / (t - t_prev) : 0.0);
+            t_prev = t;
+            w_prev = w;
+        }
+    }
+    return series;
+}
+
+inline ThermalSummary testThermal(const std::vector<std::vector<Sample>>& trials) {
+    ThermalSummary s;
+    const auto& slots = ThermalSensors::getInstance().cpus();
+    std::vector<double> mhz(slots.size(), 0.0);
+    std::vector<unsigned> used(slots.size(), 0);
+    size_t traced = 0;
+    for (const auto& trial : trials) {
+        if (trial.empty() || !trial.front().thermal) continue;
+        const ThermalTrace& trace = *trial.front().thermal;
+        ++traced;
+        double last_package = -1; // one package event per sample, not one per CPU
+        for (const auto& e : trace.events) {
+            if (!e.package) {
+                ++s.core_events;
+            } else if (e.t != last_package) {
+                ++s.package_events;
+                last_package = e.t;
+            }
+        }
+        if (!trace.temperature.empty()) {
+            s.has_temperature = true;
+            s.peak_c = std::max(s.peak_c, trace.peakTemperature());
+            s.trend += trace.temperatureTrend();
+        }
+        s.aborted |= trace.aborted;
+        for (const auto& sample : trial) {
+            const auto it = std::ranges::find(slots, sample.cpu);
+            const size_t slot = static_cast<size_t>(it - slots.begin());
+            if (it == slots.end() || slot >= trace.mean_mhz.size() || trace.mean_mhz[slot] <= 0) continue;
+            mhz[slot] += trace.mean_mhz[slot];
+            ++used[slot];
+        }
+    }
+    if (traced) s.trend /= static_cast<double>(traced);
+
+    s.cores.resize(slots.size());
+    std::vector<double> usage(slots.size(), 0.0), freq(slots.size(), 0.0);
+    size_t samples = 0;
+    for (const auto& trial : trials) {
+        if (trial.empty() || !trial.front().thermal) continue;
+        const ThermalTrace& trace = *trial.front().thermal;
+        if (trace.cpus != slots.size()) continue;
+        for (size_t k = 0; k < trace.times.size(); ++k, ++samples) {
+            for (size_t c = 0; c < slots.size(); ++c) {
+                const size_t at = k * trace.cpus + c;
+                usage[c] += trace.usage[at];
+                freq[c] += trace.mhz[at];
+                s.cores[c].peak_c = std::max(s.cores[c].peak_c, trace.core_c[at]);
+            }
+        }
+    }
+    for (size_t c = 0; c < slots.size(); ++c) {
+        s.cores[c].cpu = slots[c];
+        if (samples) {
+            s.cores[c].usage = static_cast<float>(usage[c] / static_cast<double>(samples));
+            s.cores[c].mhz = static_cast<float>(freq[c] / static_cast<double>(samples));
+        }
+    }
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (!used[i]) continue;
+        const double m = mhz[i] / used[i];
+        if (s.min_mhz == 0 || m < s.min_mhz) {
+            s.min_mhz = m;
+            s.min_cpu = slots[i];
+        }
+    }
+    s.impacts = throttleImpacts(trials);
+    return s;
+}
+
+// Core clock a test actually ran at, next to the TSC's fixed rate, so wide
+// vector kernels show their frequency license (AVX-512 and AVX2 run below
+// the scalar clock on many parts)
+struct TestClock {
+    double ghz = 0;          // 0: neither source was available
+    const char* source = ""; // "counters" (cycles over ref-cycles) or "cpufreq"
+
+    double ratio() const { return ghz > 0 && Tsc::getInstance().ghz() > 0 ? ghz / Tsc::getInstance().ghz() : 0.0; }
+};
+
+// Counted cycles where the PMU gives both cycle events, as only they see the
+// clock while the kernel runs; otherwise the sampled cpufreq mean of the CPUs
+// the threads were pinned to, which also averages in idle gaps
+inline TestClock testClock(const std::vector<std::vector<Sample>>& trials, const ThermalSummary& thermal) {
+    PerfCounts counts;
+    for (const auto& trial : trials) {
+        for (const auto& s : trial) counts += s.perf;
+    }
+    if (const double ghz = counts.effectiveGhz(Tsc::getInstance().ghz()); ghz > 0) return {ghz, "counters"};
+    double mhz = 0;
+    size_t used = 0;
+    for (const auto& trial : trials) {
+        for (const auto& s : trial) {
+            const auto core = std::ranges::find(thermal.cores, s.cpu, &ThermalSummary::Core::cpu);
+            if (core == thermal.cores.end() || core->mhz <= 0) continue;
+            mhz += core->mhz;
+            ++used;
+        }
+    }
+    if (used) return {mhz / static_cast<double>(used) / 1000, "cpufreq"};
+    return {};
+}
+
+// A test's score against what its cores could do at best. SMT siblings share
+// one core's pipes, so only physical cores count, at the measured clock or
+// else the TSC rate. The per-socket sums are filled in with or without a model.
+struct TestPeak {
+    struct Socket {
+        unsigned package = 0;
+        double score = 0;                 // its threads' scores summed
+        std::vector<unsigned> cores = {}; // core ids that ran a thread
+    };
+    double per_core = 0;     // theoretical score of one core, 0: no model
+    double ghz = 0;          // clock the model assumes
+    const char* source = ""; // of ghz: the TestClock's, or "TSC rate"
+    size_t cores = 0;        // physical cores that ran a thread
+    double score = 0;        // every thread's score summed
+    std::vector<Socket> sockets;
+
+    double peak() const { return per_core * static_cast<double>(cores); }
+    double fraction() const { return peak() > 0 ? score / peak() : 0.0; }
+};
+
+inline TestPeak testPeak(const std::vector<double>& scores, const std::vector<Sample>& trial, double per_cycle,
+                         const TestClock& clock) {
+    TestPeak p;
+    p.ghz = clock.ghz > 0 ? clock.ghz : Tsc::getInstance().ghz();
+    p.source = clock.ghz > 0 ? clock.source : "TSC rate";
+    if (per_cycle > 0 && p.ghz > 0) p.per_core = per_cycle * p.ghz * 1e9;
+    const auto& cpus = Topology::getInstance().cpus();
+    for (size_t i = 0; i < scores.size() && i < trial.size(); ++i) {
+        const auto cpu = std::ranges::find(cpus, trial[i].cpu, &Topology::Cpu::id);
+        const unsigned package = cpu == cpus.end() ? 0 : cpu->package;
+        const unsigned core = cpu == cpus.end() ? trial[i].cpu : cpu->core;
+        auto socket = std::ranges::find(p.sockets, package, &TestPeak::Socket::package);
+        if (socket == p.sockets.end()) socket = p.sockets.insert(p.sockets.end(), {.package = package});
+        socket->score += scores[i];
+        p.score += scores[i];
+        if (std::ranges::find(socket->cores, core) == socket->cores.end()) {
+            socket->cores.push_back(core);
+            ++p.cores;
+        }
+    }
+    std::ranges::sort(p.sockets, {}, &TestPeak::Socket::package);
+    return p;
+}
+
+#endif // WORKLOAD_HPP
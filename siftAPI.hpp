@@ -19,7 +19,8 @@ extern "C" {
     void aes128DecryptBlock(void * out, const void * in, const void * key);
     void aesXtsDecrypt(void * out, const void * in, const void* key, const void * tweak, size_t blocks);
     void diskWrite(const char * name);
-    void startLZMA(int duration);
+    double startLZMA(int duration, unsigned threads); // threads == 0: every pool worker; returns ops/s
+    bool lzmaRoundTrip(unsigned worker_id, unsigned long op, size_t chunk_size);
     void spawn_system_monitor();
     void stop_system_monitor();
     void renderPixel(int iterations, int thread_id, float* output);
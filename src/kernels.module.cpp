@@ -0,0 +1,995 @@
+#include "core.hpp"
+#include "pcg_random.hpp"
+#include "registry.hpp"
+#include "topology.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <immintrin.h>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <string>
+#include <sys/mman.h>
+#include <vector>
+
+// Built-in tests. Each one is a Workload around its asm kernel plus a
+// registration; the menu, presets, "sift run", scenarios and the full system
+// test are generated from the registry, so nothing else needs to know them.
+
+namespace {
+
+constexpr int AVX_BUFFER_SIZE = 64; // 256 bytes (L1 cache line optimized)
+constexpr int COLLATZ_BATCH_SIZE = 10000000;
+
+void* allocate_huge_buffer(size_t size) {
+#ifdef __linux__
+    void* ptr = mmap(nullptr, size, PROT_READ|PROT_WRITE,
+                    MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+    if (ptr != MAP_FAILED) return ptr;
+    // No reserved huge pages: plain mapping, ask THP to back it instead
+    ptr = mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) return nullptr;
+    madvise(ptr, size, MADV_HUGEPAGE);
+    return ptr;
+#else
+    return aligned_alloc(1 << 21, size); // Fallback to 2MB aligned
+#endif
+}
+
+void free_buffer(void* buf, size_t size) {
+#ifdef __linux__
+    munmap(buf, size);
+#else
+    free(buf);
+#endif
+}
+
+struct MemoryWorkload final : Workload {
+    static constexpr size_t size = 1 << 30; // 1GB
+    void* buffer = nullptr;
+    const int thread_id;
+    // The flood kernels repeat internally; in iteration mode that inner
+    // count is the user's iteration count, in duration mode one pass.
+    unsigned long passes;
+
+    MemoryWorkload(unsigned long iters, int tid)
+        : thread_id(tid), passes(std::max(1UL, iters)) { iterations = iters; }
+
+    bool setup() override {
+        buffer = allocate_huge_buffer(size);
+        if (!buffer) {
+            std::cerr << "Failed to allocate memory buffer for thread " << thread_id << std::endl;
+            return false;
+        }
+        std::memset(buffer, 0, size); // Take the first-touch page faults now
+        return true;
+    }
+
+    void run(unsigned long iters) override {
+        for (unsigned long i = 0; i < iters; ++i) {
+            floodL1L2(buffer, &passes, size);
+            floodMemory(buffer, &passes, size);
+            floodNt(buffer, &passes, size);
+            rowhammerAttack(buffer, &passes, size);
+        }
+    }
+
+    void teardown() override { free_buffer(buffer, size); }
+};
+
+struct Sha256Workload final : Workload {
+    explicit Sha256Workload(unsigned long iters) { iterations = iters; }
+    void run(unsigned long iters) override { sha256(iters); }
+};
+
+// FIPS 180-4 block compression, for CPUs without SHA-NI
+void sha256Compress(uint32_t state[8], const uint8_t block[64]) {
+    static constexpr uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = uint32_t{block[4 * i]} << 24 | uint32_t{block[4 * i + 1]} << 16 | uint32_t{block[4 * i + 2]} << 8 |
+               uint32_t{block[4 * i + 3]};
+    }
+    for (int i = 16; i < 64; ++i) {
+        const uint32_t s0 = std::rotr(w[i - 15], 7) ^ std::rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const uint32_t s1 = std::rotr(w[i - 2], 17) ^ std::rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; ++i) {
+        const uint32_t t1 = h + (std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+        const uint32_t t2 = (std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+// Two independent message streams, one block each per iteration: about the
+// 130 rounds an iteration of sha256.asm does
+struct Sha256ScalarWorkload final : Workload {
+    uint32_t state[2][8];
+    uint8_t blocks[2][64];
+
+    explicit Sha256ScalarWorkload(unsigned long iters) {
+        iterations = iters;
+        for (auto& st : state) {
+            const uint32_t iv[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+            std::memcpy(st, iv, sizeof(iv));
+        }
+        for (int i = 0; i < 64; ++i) {
+            blocks[0][i] = static_cast<uint8_t>(i * 0x11);
+            blocks[1][i] = static_cast<uint8_t>(0xde ^ (i * 0x5a));
+        }
+    }
+
+    void run(unsigned long iters) override {
+        for (unsigned long i = 0; i < iters; ++i) {
+            sha256Compress(state[0], blocks[0]);
+            sha256Compress(state[1], blocks[1]);
+        }
+        asm volatile("" : : "r"(state) : "memory");
+    }
+};
+
+struct AesWorkload final : Workload {
+    alignas(16) uint8_t key[32] = {0x01}; // All-zero key (worst-case)
+    alignas(16) uint8_t expanded_key[240]; // AES-256 expanded key
+    alignas(16) uint8_t input[16] = {0};
+    alignas(16) uint8_t output[16];
+    const size_t BLOCKS;
+    const bool decrypt;
+    std::unique_ptr<uint8_t[]> buffer;
+
+    AesWorkload(unsigned long iters, int block_size, bool dec)
+        : BLOCKS(size_t{1} << block_size), decrypt(dec) { iterations = iters; }
+
+    bool setup() override {
+        buffer = std::make_unique<uint8_t[]>(BLOCKS * 16); // Zeroed, so already faulted in
+        pcg32 gen(std::random_device{}());
+        std::uniform_int_distribution<uint8_t> dist(0, 255);
+        for (auto& v : key) v = dist(gen);
+        return true;
+    }
+
+    void run(unsigned long iters) override {
+        for (unsigned long i = 0; i < iters; i++) {
+            // Key expansion (stress FPU)
+            aes256Keygen(expanded_key, key);
+            uint8_t tweak[16] = {0};
+            if (!decrypt) {
+                // Encrypt individual blocks (stress latency)
+                for (size_t b = 0; b < BLOCKS; b++) {
+                    aes128EncryptBlock(output, input, key);
+                    asm volatile("" : : "r"(output) : "memory");
+                }
+                // XTS mode (stress throughput)
+                aesXtsEncrypt(buffer.get(), buffer.get(), expanded_key, tweak, BLOCKS);
+            } else {
+                // Decrypt individual blocks (stress latency)
+                for (size_t b = 0; b < BLOCKS; b++) {
+                    aes128DecryptBlock(output, input, key);
+                    asm volatile("" : : "r"(output) : "memory");
+                }
+                // XTS mode decryption (stress throughput)
+                aesXtsDecrypt(buffer.get(), buffer.get(), expanded_key, tweak, BLOCKS);
+            }
+        }
+    }
+
+    void teardown() override { buffer.reset(); }
+};
+
+struct CollatzWorkload final : Workload {
+    pcg32 gen;
+    std::uniform_int_distribution<unsigned long> dist;
+
+    CollatzWorkload(unsigned long iters, unsigned long lower, unsigned long upper, int tid)
+        : gen(42u + tid, 54u + tid), dist(lower, upper) { iterations = iters; }
+
+    void run(unsigned long iters) override {
+        for (unsigned long i = 0; i < iters; ) {
+            const unsigned long batch = std::min(static_cast<unsigned long>(COLLATZ_BATCH_SIZE), iters - i);
+
+            for (unsigned long j = 0; j < batch; ++j) {
+                unsigned long steps = 0;
+                p3np1E(dist(gen), &steps);
+            }
+            i += batch;
+        }
+    }
+};
+
+struct PrimesWorkload final : Workload {
+    pcg32 gen;
+    std::uniform_int_distribution<unsigned long> dist;
+    unsigned long total_steps = 0;
+
+    PrimesWorkload(unsigned long iters, unsigned long lower, unsigned long upper, int tid)
+        : gen(42u + tid, 54u + tid), dist(lower, upper) { iterations = iters; }
+
+    void run(unsigned long iters) override {
+        for (unsigned long i = 0; i < iters; ) {
+            const unsigned long batch = std::min(static_cast<unsigned long>(COLLATZ_BATCH_SIZE), iters - i);
+            unsigned long batch_steps = 0;
+
+            for (unsigned long j = 0; j < batch; ++j) {
+                unsigned long steps = 0;
+                primes(dist(gen), &steps);
+                batch_steps += steps;
+            }
+
+            total_steps += batch_steps;
+            i += batch;
+        }
+    }
+};
+
+// The waves of avx.asm (multiply-add chains, reciprocal and rsqrt estimates
+// with a Newton-Raphson step, division chains, compare-and-select, a
+// polynomial, square roots) on two SSE halves, for CPUs without AVX2/FMA.
+// Multiply and add stay separate where the asm fuses them.
+void sseStress(float* a, float* b, float* c) {
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 k0 = _mm_set1_ps(a[3]), k1 = _mm_set1_ps(b[4]), k2 = _mm_set1_ps(c[5]);
+    for (int half = 0; half < 8; half += 4) {
+        __m128 x0 = _mm_load_ps(a + half), x1 = _mm_load_ps(b + half), x2 = _mm_load_ps(c + half);
+        for (int i = 0; i < 128; ++i) {
+            x0 = _mm_add_ps(_mm_mul_ps(x0, k2), k0);
+            x1 = _mm_add_ps(_mm_mul_ps(x1, x0), k1);
+            x2 = _mm_add_ps(_mm_mul_ps(x2, x1), k2);
+
+            const __m128 r = _mm_rcp_ps(x2);
+            const __m128 s = _mm_rsqrt_ps(_mm_andnot_ps(sign, x1));
+            const __m128 nr = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(_mm_mul_ps(r, r), x2), s), r);
+
+            __m128 d = _mm_div_ps(nr, s);
+            d = _mm_div_ps(x0, d);
+            d = _mm_div_ps(d, x1);
+
+            const __m128 lt = _mm_cmplt_ps(d, x2);
+            x0 = _mm_or_ps(_mm_and_ps(lt, d), _mm_andnot_ps(lt, x0));
+
+            const __m128 p2 = _mm_mul_ps(x0, x0), p3 = _mm_mul_ps(p2, x0);
+            x1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p3, k1), _mm_mul_ps(p2, k0)), x1);
+            x2 = _mm_sqrt_ps(_mm_andnot_ps(sign, _mm_add_ps(x2, _mm_rcp_ps(x1))));
+        }
+        _mm_store_ps(a + half, _mm_add_ps(x0, _mm_add_ps(x1, x2)));
+    }
+}
+
+// Every variant covers the whole buffer per iteration, 8 floats per call for
+// avx/sseStress and 16 for avx512, so scores compare across ISA levels
+struct AvxWorkload final : Workload {
+    using Kernel = void (*)(float*, float*, float*);
+    pcg32 gen;
+    std::uniform_real_distribution<float> dist;
+    const Kernel kernel;
+    const int width; // floats per kernel call
+    alignas(64) float n1[AVX_BUFFER_SIZE], n2[AVX_BUFFER_SIZE], n3[AVX_BUFFER_SIZE];
+
+    AvxWorkload(unsigned long iters, float lower, float upper, int tid, Kernel k, int w)
+        : gen(42u + tid, 54u + tid), dist(lower, upper), kernel(k), width(w) { iterations = iters; }
+
+    void run(unsigned long iters) override {
+        for (unsigned long i = 0; i < iters; ++i) {
+            for (int j = 0; j < AVX_BUFFER_SIZE; ++j) {
+                n1[j] = dist(gen);
+                n2[j] = dist(gen);
+                n3[j] = dist(gen);
+            }
+
+            for (int offset = 0; offset < AVX_BUFFER_SIZE; offset += width) {
+                kernel(n1+offset, n2+offset, n3+offset);
+            }
+        }
+    }
+};
+
+// flops.asm's contract on SSE2 for CPUs without FMA: 12 accumulators, each
+// step a multiply and a dependent add per lane. With -march=native GCC would
+// fuse the pair into an FMA, so contraction is switched off for these two.
+__attribute__((optimize("fp-contract=off"))) void flopsSsePs(void* acc, const void* coef, unsigned long steps) {
+    float* a = static_cast<float*>(acc);
+    const __m128 m = _mm_set1_ps(static_cast<const float*>(coef)[0]);
+    const __m128 c = _mm_set1_ps(static_cast<const float*>(coef)[1]);
+    __m128 x[12];
+    for (int i = 0; i < 12; ++i) x[i] = _mm_load_ps(a + 4 * i);
+    for (unsigned long s = 0; s < steps; ++s) {
+#pragma GCC unroll 12
+        for (__m128& v : x) v = _mm_add_ps(_mm_mul_ps(v, m), c);
+    }
+    for (int i = 0; i < 12; ++i) _mm_store_ps(a + 4 * i, x[i]);
+}
+
+__attribute__((optimize("fp-contract=off"))) void flopsSsePd(void* acc, const void* coef, unsigned long steps) {
+    double* a = static_cast<double*>(acc);
+    const __m128d m = _mm_set1_pd(static_cast<const double*>(coef)[0]);
+    const __m128d c = _mm_set1_pd(static_cast<const double*>(coef)[1]);
+    __m128d x[12];
+    for (int i = 0; i < 12; ++i) x[i] = _mm_load_pd(a + 2 * i);
+    for (unsigned long s = 0; s < steps; ++s) {
+#pragma GCC unroll 12
+        for (__m128d& v : x) v = _mm_add_pd(_mm_mul_pd(v, m), c);
+    }
+    for (int i = 0; i < 12; ++i) _mm_store_pd(a + 2 * i, x[i]);
+}
+
+// Peak FLOPS: throughput-bound where the avx test is latency-bound. The
+// accumulators are seeded in setup(), so the timed region is nothing but
+// the kernel's multiply-adds; one iteration is STEPS steps of it and counts
+// for its FLOPs, which is what the score is in.
+struct FlopsWorkload final : Workload {
+    using Kernel = void (*)(void*, const void*, unsigned long);
+    static constexpr unsigned long STEPS = 1024;
+    const Kernel kernel;
+    const bool fp64;
+    const unsigned tid;
+    alignas(64) unsigned char acc[24 * 64]; // 24 zmm, the most any variant keeps
+    alignas(16) unsigned char coef[16];     // {m, a}: acc = acc * m + a
+
+    FlopsWorkload(unsigned long iters, Kernel k, bool double_precision, double flops_per_step, unsigned t)
+        : kernel(k), fp64(double_precision), tid(t) {
+        iterations = iters;
+        work_per_iteration = flops_per_step * STEPS;
+    }
+
+    bool setup() override {
+        pcg32 gen(42u + tid, 54u + tid);
+        std::uniform_real_distribution<double> dist(0.5, 1.5);
+        // 1 - m stays well above FP32 epsilon, so every value converges on a / (1 - m) = 1
+        constexpr double m = 0.999, a = 0.001;
+        if (fp64) {
+            double* v = reinterpret_cast<double*>(acc);
+            for (size_t i = 0; i < sizeof(acc) / sizeof(double); ++i) v[i] = dist(gen);
+            const double c[] = {m, a};
+            std::memcpy(coef, c, sizeof(c));
+        } else {
+            float* v = reinterpret_cast<float*>(acc);
+            for (size_t i = 0; i < sizeof(acc) / sizeof(float); ++i) v[i] = static_cast<float>(dist(gen));
+            const float c[] = {static_cast<float>(m), static_cast<float>(a)};
+            std::memcpy(coef, c, sizeof(c));
+        }
+        return true;
+    }
+
+    void run(unsigned long iters) override { kernel(acc, coef, iters * STEPS); }
+};
+
+// Memory bandwidth after STREAM (McCalpin): its Copy, Scale, Add and Triad
+// plus a pure read and a pure write, over three arrays of doubles shared by
+// every thread of the run
+enum StreamOp { STREAM_READ = 1, STREAM_WRITE, STREAM_COPY, STREAM_SCALE, STREAM_ADD, STREAM_TRIAD };
+constexpr const char* STREAM_OPS[] = {"Read", "Write", "Copy", "Scale", "Add", "Triad"};
+// Arrays each op counts per element. As in STREAM, the read a plain store's
+// write-allocate adds is not counted, which is why streaming stores score higher.
+constexpr int STREAM_WORDS[] = {1, 1, 2, 2, 3, 3};
+constexpr double STREAM_SCALAR = 3.0;
+
+using StreamKernel = void (*)(double*, const double*, const double*, double, unsigned long);
+using StreamKernels = std::array<std::array<StreamKernel, 2>, 6>; // [op - 1][streaming stores]
+
+// stream.asm's contract on SSE2, for the 128-bit variant
+template<int Op, bool Nt>
+void streamSse(double* dst, const double* x, const double* y, double s, unsigned long bytes) {
+    const __m128d k = _mm_set1_pd(s);
+    const size_t n = bytes / sizeof(double);
+    if constexpr (Op == STREAM_READ) {
+        __m128d sum[4] = {};
+        for (size_t i = 0; i < n; i += 8) {
+#pragma GCC unroll 4
+            for (size_t j = 0; j < 4; ++j) sum[j] = _mm_add_pd(sum[j], _mm_load_pd(x + i + 2 * j));
+        }
+        _mm_store_pd(dst, _mm_add_pd(_mm_add_pd(sum[0], sum[1]), _mm_add_pd(sum[2], sum[3])));
+    } else {
+        for (size_t i = 0; i < n; i += 2) {
+            __m128d v;
+            if constexpr (Op == STREAM_WRITE) {
+                v = k;
+            } else if constexpr (Op == STREAM_COPY) {
+                v = _mm_load_pd(x + i);
+            } else if constexpr (Op == STREAM_SCALE) {
+                v = _mm_mul_pd(k, _mm_load_pd(x + i));
+            } else if constexpr (Op == STREAM_ADD) {
+                v = _mm_add_pd(_mm_load_pd(x + i), _mm_load_pd(y + i));
+            } else {
+                v = _mm_add_pd(_mm_load_pd(x + i), _mm_mul_pd(k, _mm_load_pd(y + i)));
+            }
+            if constexpr (Nt) {
+                _mm_stream_pd(dst + i, v);
+            } else {
+                _mm_store_pd(dst + i, v);
+            }
+        }
+        if constexpr (Nt) _mm_sfence();
+    }
+}
+
+template<int Op>
+constexpr std::array<StreamKernel, 2> streamSseOp = {streamSse<Op, false>, streamSse<Op, Op != STREAM_READ>};
+
+const StreamKernels STREAM_128 = {streamSseOp<STREAM_READ>, streamSseOp<STREAM_WRITE>, streamSseOp<STREAM_COPY>,
+                                  streamSseOp<STREAM_SCALE>, streamSseOp<STREAM_ADD>, streamSseOp<STREAM_TRIAD>};
+const StreamKernels STREAM_256 = {{{streamRead256, streamRead256}, {streamWrite256, streamWrite256Nt},
+                                   {streamCopy256, streamCopy256Nt}, {streamScale256, streamScale256Nt},
+                                   {streamAdd256, streamAdd256Nt}, {streamTriad256, streamTriad256Nt}}};
+const StreamKernels STREAM_512 = {{{streamRead512, streamRead512}, {streamWrite512, streamWrite512Nt},
+                                   {streamCopy512, streamCopy512Nt}, {streamScale512, streamScale512Nt},
+                                   {streamAdd512, streamAdd512Nt}, {streamTriad512, streamTriad512Nt}}};
+
+// The run's three arrays. The first thread to ask maps them and the others
+// get the same ones; nothing is touched here, so every page is placed by the
+// thread that first writes it. Unmapped when the last thread lets go.
+struct StreamArrays {
+    const size_t bytes; // per array
+    double* a;
+    double* b;
+    double* c;
+
+    explicit StreamArrays(size_t n)
+        : bytes(n), a(static_cast<double*>(allocate_huge_buffer(n))), b(static_cast<double*>(allocate_huge_buffer(n))),
+          c(static_cast<double*>(allocate_huge_buffer(n))) {}
+
+    ~StreamArrays() {
+        for (double* array : {a, b, c}) {
+            if (array) free_buffer(array, bytes);
+        }
+    }
+
+    StreamArrays(const StreamArrays&) = delete;
+    StreamArrays& operator=(const StreamArrays&) = delete;
+
+    bool ok() const { return a && b && c; }
+
+    static std::shared_ptr<StreamArrays> shared(size_t bytes) {
+        static std::mutex lock;
+        static std::weak_ptr<StreamArrays> current;
+        const std::lock_guard guard(lock);
+        std::shared_ptr<StreamArrays> arrays = current.lock();
+        if (!arrays || arrays->bytes != bytes) {
+            arrays = std::make_shared<StreamArrays>(bytes);
+            current = arrays;
+        }
+        return arrays;
+    }
+};
+
+// One thread's slice of the shared arrays, split as STREAM's OpenMP static
+// schedule does. setup() first-touches it from the CPU the worker is pinned
+// to, so on a NUMA box its pages sit on that node; slices are whole huge
+// pages when the arrays are large enough, so no page is shared by two
+// threads. One iteration is one pass over the slice; teardown() checks the
+// results the way STREAM's checkSTREAMresults does.
+struct StreamWorkload final : Workload {
+    static constexpr size_t PAGE = 4096, HUGE_PAGE = 2 << 20;
+    const StreamKernel kernel;
+    const int op;
+    const size_t bytes;
+    const unsigned tid, threads;
+    std::shared_ptr<StreamArrays> arrays;
+    double* dst = nullptr;
+    const double* x = nullptr;
+    const double* y = nullptr;
+    size_t length = 0; // bytes of each array this thread works on
+    unsigned long passes = 0;
+    alignas(64) double sink[8] = {};
+
+    StreamWorkload(unsigned long iters, StreamKernel k, int stream_op, size_t array_bytes, const WorkerSlot& s)
+        : kernel(k), op(stream_op), bytes(array_bytes), tid(s.tid), threads(s.threads) { iterations = iters; }
+
+    bool setup() override {
+        arrays = StreamArrays::shared(bytes);
+        if (!arrays->ok()) {
+            std::cerr << "Failed to allocate the STREAM arrays for thread " << tid << std::endl;
+            return false;
+        }
+        const size_t grain = bytes / threads >= HUGE_PAGE ? HUGE_PAGE : PAGE;
+        const size_t begin = bytes / threads * tid / grain * grain;
+        const size_t end = tid + 1 == threads ? bytes : bytes / threads * (tid + 1) / grain * grain;
+        length = end - begin;
+        if (length == 0) return false;
+        double* a = arrays->a + begin / sizeof(double);
+        double* b = arrays->b + begin / sizeof(double);
+        double* c = arrays->c + begin / sizeof(double);
+        // STREAM's starting values, written from this thread: the first touch
+        std::fill_n(a, length / sizeof(double), 1.0);
+        std::fill_n(b, length / sizeof(double), 2.0);
+        std::fill_n(c, length / sizeof(double), 0.5);
+        switch (op) {
+            case STREAM_READ: dst = sink; x = a; break;
+            case STREAM_WRITE: dst = a; break;
+            case STREAM_COPY: dst = c; x = a; break;
+            case STREAM_SCALE: dst = b; x = c; break;
+            case STREAM_ADD: dst = c; x = a; y = b; break;
+            default: dst = a; x = b; y = c; break;
+        }
+        work_per_iteration = static_cast<double>(length) * STREAM_WORDS[op - 1];
+        return true;
+    }
+
+    void run(unsigned long iters) override {
+        for (unsigned long i = 0; i < iters; ++i) kernel(dst, x, y, STREAM_SCALAR, length);
+        passes += iters;
+    }
+
+    // Sources never change, so every pass leaves the same value in dst; a
+    // slice that reads back wrong fails the test
+    void teardown() override {
+        for (size_t i = 0; op != STREAM_READ && passes && i < length / sizeof(double); ++i) {
+            const double want = op == STREAM_WRITE   ? STREAM_SCALAR
+                                : op == STREAM_COPY  ? x[i]
+                                : op == STREAM_SCALE ? STREAM_SCALAR * x[i]
+                                : op == STREAM_ADD   ? x[i] + y[i]
+                                                     : x[i] + STREAM_SCALAR * y[i];
+            if (dst[i] != want) {
+                std::cerr << "STREAM " << STREAM_OPS[op - 1] << ": thread " << tid << " read back " << dst[i]
+                          << " at element " << i << ", expected " << want << std::endl;
+                ++errors;
+                break;
+            }
+        }
+        arrays.reset();
+    }
+};
+
+struct DiskWriteWorkload final : Workload {
+    const std::string filename;
+
+    DiskWriteWorkload(unsigned long iters, unsigned id)
+        : filename("/tmp/writeTestThread" + std::to_string(id) + ".bin") { iterations = iters; }
+
+    void run(unsigned long iters) override {
+        for (unsigned long i = 0; i < iters; ++i) {
+            diskWrite(filename.c_str());
+        }
+    }
+
+    void teardown() override { std::remove(filename.c_str()); }
+};
+
+struct RenderWorkload final : Workload {
+    const int tid;
+    alignas(16) float pixel_output = 0;
+
+    // Each thread renders its slice of the frame: pixels * sample multiplier
+    RenderWorkload(int width, int height, int sample_multiplier, int tid, int nthreads) : tid(tid) {
+        const int total_pixels = width * height;
+        const int pixels_per_thread = total_pixels / nthreads;
+        const int start_pixel = tid * pixels_per_thread;
+        const int end_pixel = (tid == nthreads - 1) ?
+                       total_pixels : start_pixel + pixels_per_thread;
+        iterations = static_cast<unsigned long>(end_pixel - start_pixel) * sample_multiplier;
+    }
+
+    void run(unsigned long iters) override {
+        renderPixel(static_cast<int>(iters), tid, &pixel_output);
+    }
+};
+
+struct BranchWorkload final : Workload {
+    const int pattern_type;
+
+    BranchWorkload(unsigned long iters, int pattern) : pattern_type(pattern) { iterations = iters; }
+    void run(unsigned long iters) override { branchTorture(iters, pattern_type); }
+};
+
+// One cache level per run so each level gets its own synchronized window
+struct CacheWorkload final : Workload {
+    static constexpr size_t L1_SIZE = 32 * 1024;      // 32KB
+    static constexpr size_t L2_SIZE = 512 * 1024;     // 512KB
+    static constexpr size_t L3_SIZE = 8 * 1024 * 1024; // 8MB
+    static constexpr size_t MEM_SIZE = 64 * 1024 * 1024; // 64MB
+    static constexpr size_t level_sizes[] = {L1_SIZE, L2_SIZE, L3_SIZE, MEM_SIZE};
+
+    const int level;
+    void* buffer = nullptr;
+
+    CacheWorkload(unsigned long iters, int level) : level(level) { iterations = iters; }
+
+    bool setup() override {
+        buffer = aligned_alloc(64, level_sizes[level]);
+        if (!buffer) return false;
+        std::memset(buffer, 0, level_sizes[level]);
+        return true;
+    }
+
+    void run(unsigned long iters) override {
+        switch (level) {
+            case 0: cacheL1Test(iters, buffer); break;
+            case 1: cacheL2Test(iters, buffer); break;
+            case 2: cacheL3Test(iters, buffer); break;
+            default: memoryLatencyTest(iters, buffer, MEM_SIZE); break;
+        }
+    }
+
+    void teardown() override { free(buffer); }
+};
+
+// A cyclic chain of pointers with one node per cache line, for pointerChase.
+// Pages are visited in random order, and the lines of each page in a random
+// order of their own, so neither the stride prefetchers nor the next-line
+// prefetcher can guess the next node; as every page is finished before the
+// next one starts, a load misses the TLB once per 64 at most and the curve
+// shows the caches and DRAM rather than page walks. Shared by every thread
+// of the run, each starting at its own point of the cycle.
+struct ChaseChain {
+    static constexpr size_t LINE = 64, PAGE = 4096, HUGE_PAGE = 2 << 20;
+    const size_t bytes;
+    const unsigned threads;
+    const size_t mapped; // whole huge pages, so a MAP_HUGETLB mapping unmaps cleanly
+    void* base;
+    std::vector<void*> starts; // one per thread, evenly spaced along the cycle
+
+    ChaseChain(size_t n, unsigned t)
+        : bytes(n), threads(t), mapped((n + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE),
+          base(allocate_huge_buffer(mapped)) {
+        if (base) build();
+    }
+
+    ~ChaseChain() {
+        if (base) free_buffer(base, mapped);
+    }
+
+    ChaseChain(const ChaseChain&) = delete;
+    ChaseChain& operator=(const ChaseChain&) = delete;
+
+    bool ok() const { return base != nullptr; }
+
+    static std::shared_ptr<ChaseChain> shared(size_t bytes, unsigned threads) {
+        static std::mutex lock;
+        static std::weak_ptr<ChaseChain> current;
+        const std::lock_guard guard(lock);
+        std::shared_ptr<ChaseChain> chain = current.lock();
+        if (!chain || chain->bytes != bytes || chain->threads != threads) {
+            chain = std::make_shared<ChaseChain>(bytes, threads);
+            current = chain;
+        }
+        return chain;
+    }
+
+private:
+    void build() {
+        constexpr size_t per_page = PAGE / LINE;
+        const size_t lines = bytes / LINE;
+        std::vector<uint32_t> pages((lines + per_page - 1) / per_page);
+        std::vector<uint32_t> order(per_page);
+        std::iota(pages.begin(), pages.end(), 0u);
+        std::iota(order.begin(), order.end(), 0u);
+        pcg32 gen(0x5eed, bytes);
+        std::ranges::shuffle(pages, gen);
+        void** first = nullptr;
+        void** prev = nullptr;
+        size_t position = 0;
+        for (uint32_t page : pages) {
+            std::ranges::shuffle(order, gen);
+            for (uint32_t line : order) {
+                const size_t index = page * per_page + line;
+                if (index >= lines) continue; // the last page may be partial
+                void** node = reinterpret_cast<void**>(static_cast<char*>(base) + index * LINE);
+                if (prev) {
+                    *prev = node;
+                } else {
+                    first = node;
+                }
+                // more threads than lines share a start
+                while (starts.size() < threads && position == lines * starts.size() / threads) starts.push_back(node);
+                prev = node;
+                ++position;
+            }
+        }
+        *prev = first;
+    }
+};
+
+// Load-to-use latency at one working-set size. One iteration is LOADS
+// dependent loads, so the score is loads per second and the cost ns/load.
+struct ChaseWorkload final : Workload {
+    static constexpr unsigned long STEPS = 64, LOADS = STEPS * 16; // pointerChase does 16 per step
+    const size_t bytes;
+    const unsigned tid, threads;
+    std::shared_ptr<ChaseChain> chain;
+    void* node = nullptr;
+
+    ChaseWorkload(unsigned long iters, size_t working_set, const WorkerSlot& s)
+        : bytes(working_set), tid(s.tid), threads(s.threads) {
+        iterations = iters;
+        work_per_iteration = LOADS;
+    }
+
+    bool setup() override {
+        chain = ChaseChain::shared(bytes, threads);
+        if (!chain->ok()) {
+            std::cerr << "Failed to allocate the pointer chain for thread " << tid << std::endl;
+            return false;
+        }
+        // One lap (up to 4M loads) pulls the chain into whatever level holds it
+        const size_t lap = std::min<size_t>(bytes / ChaseChain::LINE, 1 << 22);
+        node = pointerChase(chain->starts[tid], std::max<size_t>(1, lap / 16));
+        return true;
+    }
+
+    void run(unsigned long iters) override { node = pointerChase(node, iters * STEPS); }
+
+    void teardown() override { chain.reset(); }
+};
+
+constexpr double WIDE = std::numeric_limits<double>::max();
+
+// Range the random inputs are drawn from
+TestParam lowerParam(std::string key, double fallback, bool integer) {
+    return {.name = "lower", .key = std::move(key), .fallback = fallback, .prompt = "Lower bound?: ",
+            .integer = integer, .min = integer ? 0 : -WIDE};
+}
+
+TestParam upperParam(std::string key, double fallback, bool integer) {
+    return {.name = "upper", .key = std::move(key), .fallback = fallback, .prompt = "Upper bound?: ",
+            .integer = integer, .min = integer ? 0 : -WIDE};
+}
+
+std::unique_ptr<Workload> makeAvx(const TestValues& v, const WorkerSlot& s, AvxWorkload::Kernel kernel, int width = 8) {
+    return std::make_unique<AvxWorkload>(v.count("iterations"), static_cast<float>(v.get("lower")),
+                                         static_cast<float>(v.get("upper")), s.tid, kernel, width);
+}
+
+// Elements in one vector of a flops variant
+double flopsLanes(const std::string& variant, bool fp64) {
+    return (variant == "avx512" ? 64.0 : variant == "avx2-fma" ? 32.0 : 16.0) / (fp64 ? 8 : 4);
+}
+
+// FLOPs one pipe retires per cycle with a flops variant: a fused multiply-add
+// on every lane, or one multiply or add per lane without FMA
+double flopsPerPipe(const std::string& variant, bool fp64) {
+    const double lanes = flopsLanes(variant, fp64);
+    return variant == "sse" ? lanes : 2 * lanes;
+}
+
+std::unique_ptr<Workload> makeFlops(const TestValues& v, const WorkerSlot& s, const std::string& variant,
+                                    FlopsWorkload::Kernel fp32, FlopsWorkload::Kernel fp64, double accumulators) {
+    // Every kernel does a multiply and an add per lane of each accumulator per
+    // step, fused or not; the pipe rate only matters to the peak model
+    const bool dp = v.get("precision") > 32;
+    return std::make_unique<FlopsWorkload>(v.count("iterations"), dp ? fp64 : fp32, dp,
+                                           2 * flopsLanes(variant, dp) * accumulators, s.tid);
+}
+
+// Bytes per array: array_mb, or else STREAM's rule of at least four times
+// every last-level cache together, in whole huge pages
+size_t streamBytes(const TestValues& v) {
+    const size_t llc = Topology::getInstance().llcBytes();
+    const size_t bytes = v.get("array_mb") > 0 ? static_cast<size_t>(v.get("array_mb") * (1 << 20))
+                         : llc ? 4 * llc : size_t{256} << 20;
+    constexpr size_t HUGE_PAGE = StreamWorkload::HUGE_PAGE;
+    return std::max(HUGE_PAGE, (bytes + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE);
+}
+
+std::unique_ptr<Workload> makeStream(const TestValues& v, const WorkerSlot& s, const StreamKernels& kernels) {
+    const int op = std::clamp(static_cast<int>(v.get("kernel")), 1, 6);
+    return std::make_unique<StreamWorkload>(v.count("iterations"), kernels[op - 1][v.get("nt") > 0], op,
+                                            streamBytes(v), s);
+}
+
+TestParam blocksizeParam() {
+    return {.name = "blocksize", .key = "aes_blocksize", .fallback = 24, .prompt = "Blocksize?: ", .max = 30};
+}
+
+const RegisterTest avx_test({
+    .name = "avx", .title = "AVX Stress Test", .category = "NORMAL TESTS", .menu = '1',
+    .params = {iterationsParam("avx_iterations", 200000), lowerParam("avx_lower", 0.0001, false),
+               upperParam("avx_upper", 1e15, false)},
+    .spinner = "⚡ Running AVX/FMA vector...", .score = "AVX STRESS SCORE", .logs = {"AVX_Stress"},
+    .variants = {{.name = "avx512", .isa = ISA_AVX512F,
+                  .make = [](const TestValues& v, const WorkerSlot& s) { return makeAvx(v, s, avx512, 16); }},
+                 {.name = "avx2-fma", .isa = ISA_AVX | ISA_AVX2 | ISA_FMA,
+                  .make = [](const TestValues& v, const WorkerSlot& s) { return makeAvx(v, s, avx); }},
+                 {.name = "sse", .make = [](const TestValues& v, const WorkerSlot& s) { return makeAvx(v, s, sseStress); }}},
+});
+
+// FMA pipes per core (fma_units) can't be read from CPUID: 2 on Intel cores
+// since Haswell and Zen 2 and later, 1 for 512-bit on parts with a single
+// AVX-512 FMA unit, so it is a parameter of the peak model
+const RegisterTest flops_test({
+    .name = "flops", .title = "Peak FLOPS (FP32/FP64)", .category = "📊 BENCHMARKS",
+    .params = {iterationsParam("flops_iterations", 1000000),
+               {.name = "precision", .key = "flops_precision", .fallback = 32, .prompt = "Precision (32 or 64 bit): ",
+                .min = 32, .max = 64, .full = "32, 64"},
+               {.name = "fma_units", .key = "flops_fma_units", .fallback = 2, .min = 1, .max = 4}},
+    .unit = "FLOPS", .spinner = "🧮 Running peak FLOPS...", .score = "PEAK FLOPS SCORE",
+    .logs = {"Peak_FLOPS_FP32", "Peak_FLOPS_FP64"},
+    .log_name = [](const TestValues& v) { return v.get("precision") > 32 ? "Peak_FLOPS_FP64" : "Peak_FLOPS_FP32"; },
+    .variants = {{.name = "avx512", .isa = ISA_AVX512F, .make = [](const TestValues& v, const WorkerSlot& s) {
+                      return makeFlops(v, s, "avx512", flopsFma512Ps, flopsFma512Pd, 24);
+                  }},
+                 {.name = "avx2-fma", .isa = ISA_AVX | ISA_FMA, .make = [](const TestValues& v, const WorkerSlot& s) {
+                      return makeFlops(v, s, "avx2-fma", flopsFma256Ps, flopsFma256Pd, 12);
+                  }},
+                 {.name = "sse", .make = [](const TestValues& v, const WorkerSlot& s) {
+                      return makeFlops(v, s, "sse", flopsSsePs, flopsSsePd, 12);
+                  }}},
+    .peak_per_cycle = [](const TestValues& v, const KernelVariant& k) {
+        return flopsPerPipe(k.name, v.get("precision") > 32) * v.get("fma_units");
+    },
+});
+
+// GB/s, summed per socket for the capacity model. The full system test runs
+// STREAM's own four kernels with plain stores; --variant all compares widths.
+const RegisterTest stream_test({
+    .name = "stream", .title = "Memory Bandwidth (STREAM)", .category = "📊 BENCHMARKS",
+    .params = {iterationsParam("stream_iterations", 20),
+               {.name = "kernel", .key = "stream_kernel", .fallback = STREAM_TRIAD,
+                .prompt = "Kernel (1=Read, 2=Write, 3=Copy, 4=Scale, 5=Add, 6=Triad): ", .min = 1, .max = 6,
+                .full = "3..6"},
+               {.name = "nt", .key = "stream_nt", .fallback = 0, .prompt = "Streaming stores (0=no, 1=yes): ",
+                .max = 1},
+               {.name = "array_mb", .key = "stream_array_mb", .fallback = 0, .integer = false}},
+    .unit = "B/s", .spinner = "🌊 Running memory bandwidth...", .score = "MEMORY BANDWIDTH SCORE",
+    .logs = {"STREAM_"},
+    .log_name = [](const TestValues& v) {
+        const int op = std::clamp(static_cast<int>(v.get("kernel")), 1, 6);
+        return "STREAM_" + std::string(STREAM_OPS[op - 1]) + (op != STREAM_READ && v.get("nt") > 0 ? "_NT" : "");
+    },
+    .variants = {{.name = "avx512", .isa = ISA_AVX512F,
+                  .make = [](const TestValues& v, const WorkerSlot& s) { return makeStream(v, s, STREAM_512); }},
+                 {.name = "avx", .isa = ISA_AVX,
+                  .make = [](const TestValues& v, const WorkerSlot& s) { return makeStream(v, s, STREAM_256); }},
+                 {.name = "sse", .make = [](const TestValues& v, const WorkerSlot& s) { return makeStream(v, s, STREAM_128); }}},
+    .per_socket = true,
+});
+
+const RegisterTest render_test({
+    .name = "render", .title = "CPU Rendering (Death Mode)", .category = "NORMAL TESTS", .menu = '2',
+    // Duration mode renders pixel-samples until the deadline, frame size is moot
+    .params = {{.name = "resolution", .key = "render_resolution", .fallback = 3,
+                .prompt = "Resolution (1=720p, 2=1080p, 3=4K): ", .min = 1, .max = 3, .sizes = true},
+               {.name = "samples", .key = "render_samples", .fallback = 5, .prompt = "Samples: ", .min = 1,
+                .sizes = true, .scales = true}},
+    .spinner = "🎨 Running CPU ray-tracing...", .score = "RENDER SCORE", .logs = {"CPU_Render"},
+    .variants = {{.name = "x86-64", .make = [](const TestValues& v, const WorkerSlot& s) {
+            static constexpr int widths[] = {1280, 1920, 3840}, heights[] = {720, 1080, 2160};
+            const int res = std::clamp(static_cast<int>(v.get("resolution")), 1, 3) - 1;
+            return std::make_unique<RenderWorkload>(widths[res], heights[res], static_cast<int>(v.get("samples")),
+                                                    s.tid, s.threads);
+        }}},
+});
+
+const RegisterTest mem_test({
+    .name = "mem", .title = "Memory Stress + Rowhammer", .category = "NORMAL TESTS", .menu = '3',
+    .params = {iterationsParam("mem_iterations", 20)},
+    .spinner = "💥 Running memory stress + rowhammer attack...", .score = "MEM STRESS SCORE",
+    .logs = {"Memory_Stress"},
+    .hazard = "rowhammer", .warning = "ONE TIME WARNING, THIS TEST CONTAINS ROWHAMMER ATTACK, PROCEED? (yY/nN): ",
+    .variants = {{.name = "x86-64", .make = [](const TestValues& v, const WorkerSlot& s) {
+            return std::make_unique<MemoryWorkload>(v.count("iterations"), s.tid);
+        }}},
+});
+
+const RegisterTest branch_test({
+    .name = "branch", .title = "Branch Prediction", .category = "REAL-WORLD TESTS", .menu = '5',
+    .params = {iterationsParam("branch_iterations", 5000000000),
+               {.name = "pattern", .key = "branch_pattern", .fallback = 4,
+                .prompt = "Pattern (1=Gaming, 2=Database, 3=Compiler, 4=Mixed): ", .min = 1, .max = 4, .full = "1..4"}},
+    .spinner = "🎯 Running branch prediction...", .score = "BRANCH PREDICTION SCORE", .logs = {"Branch_"},
+    .log_name = [](const TestValues& v) {
+        static constexpr const char* names[] = {"Gaming_AI", "Database_Queries", "Compiler_Parsing", "Mixed_Workload"};
+        return "Branch_" + std::string(names[std::clamp(static_cast<int>(v.get("pattern")), 1, 4) - 1]);
+    },
+    .variants = {{.name = "x86-64", .make = [](const TestValues& v, const WorkerSlot&) {
+            return std::make_unique<BranchWorkload>(v.count("iterations"), static_cast<int>(v.get("pattern")));
+        }}},
+});
+
+// The menu and presets run all four levels in a row (see sift::runCache);
+// level only picks the one a scenario group loads
+const RegisterTest cache_test({
+    .name = "cache", .title = "Cache Hierarchy (L1/L2/L3)", .category = "REAL-WORLD TESTS", .menu = '6',
+    .params = {iterationsParam("cache_iterations", 5000),
+               {.name = "level", .key = "cache_level", .fallback = 3, .max = 3}},
+    .spinner = "🏗️ Running cache hierarchy tests...", .score = "CACHE HIERARCHY SCORES",
+    .logs = {"L1_Cache", "L2_Cache", "L3_Cache", "Memory_Latency"},
+    .log_name = [](const TestValues& v) {
+        static constexpr const char* names[] = {"L1_Cache", "L2_Cache", "L3_Cache", "Memory_Latency"};
+        return std::string(names[std::clamp(static_cast<int>(v.get("level")), 0, 3)]);
+    },
+    .variants = {{.name = "x86-64", .make = [](const TestValues& v, const WorkerSlot&) {
+            return std::make_unique<CacheWorkload>(v.count("iterations"), std::clamp(static_cast<int>(v.get("level")), 0, 3));
+        }}},
+});
+
+// The menu, presets and "sift run" sweep the working set from 4 KB up to
+// max_mb (see sift::runLatency); size_kb picks the one point a scenario
+// group loads, 0 the largest
+const RegisterTest latency_test({
+    .name = "latency", .title = "Memory Latency Curve", .category = "📊 BENCHMARKS",
+    .params = {iterationsParam("latency_iterations", 5000),
+               {.name = "size_kb", .key = "latency_size_kb", .fallback = 0},
+               {.name = "max_mb", .key = "latency_max_mb", .fallback = 2048, .min = 1}},
+    .unit = "loads/s", .spinner = "🔗 Running pointer chase...", .score = "MEMORY LATENCY CURVE",
+    .logs = {"Pointer_Chase"},
+    .variants = {{.name = "x86-64", .make = [](const TestValues& v, const WorkerSlot& s) {
+            const double kb = v.get("size_kb") > 0 ? v.get("size_kb") : v.get("max_mb") * 1024;
+            const size_t bytes = std::max<size_t>(ChaseChain::PAGE, static_cast<size_t>(kb * 1024) / 64 * 64);
+            return std::make_unique<ChaseWorkload>(v.count("iterations"), bytes, s);
+        }}},
+});
+
+const RegisterTest collatz_test({
+    .name = "3np1", .title = "3n+1 Collatz Conjecture", .category = "REAL-WORLD TESTS", .menu = '7',
+    .params = {iterationsParam("3np1_iterations", 20000000), lowerParam("3np1_lower", 1, true),
+               upperParam("3np1_upper", 1e15, true)},
+    .spinner = "🔥 Running 3n+1 Collatz test...", .score = "3n+1 STRESS SCORE", .logs = {"3n+1_Collatz"},
+    .variants = {{.name = "x86-64", .make = [](const TestValues& v, const WorkerSlot& s) {
+            return std::make_unique<CollatzWorkload>(v.count("iterations"), v.count("lower"), v.count("upper"), s.tid);
+        }}},
+});
+
+const RegisterTest primes_test({
+    .name = "primes", .title = "Prime Factorization", .category = "REAL-WORLD TESTS", .menu = '8',
+    .params = {iterationsParam("primes_iterations", 3), lowerParam("primes_lower", 1, true),
+               upperParam("primes_upper", 1e15, true)},
+    .spinner = "🔢 Running prime factorization ...", .score = "PRIMES STRESS SCORE", .logs = {"Primes_Stress"},
+    .variants = {{.name = "x86-64", .make = [](const TestValues& v, const WorkerSlot& s) {
+            return std::make_unique<PrimesWorkload>(v.count("iterations"), v.count("lower"), v.count("upper"), s.tid);
+        }}},
+});
+
+const RegisterTest aesenc_test({
+    .name = "aesenc", .title = "AES Encryption", .category = "🛡️ SECURITY TESTS", .menu = '9',
+    .params = {iterationsParam("aes_iterations", 20), blocksizeParam()},
+    .spinner = "🔒 Running AES encryption...", .score = "AESENC STRESS SCORE", .logs = {"AES_Encrypt"},
+    .variants = {{.name = "aes-ni", .isa = ISA_AVX | ISA_AES,
+                  .make = [](const TestValues& v, const WorkerSlot&) {
+                      return std::make_unique<AesWorkload>(v.count("iterations"), static_cast<int>(v.get("blocksize")), false);
+                  }}},
+});
+
+const RegisterTest aesdec_test({
+    .name = "aesdec", .title = "AES Decryption", .category = "🛡️ SECURITY TESTS", .menu = 'A',
+    .params = {iterationsParam("aes_iterations", 20), blocksizeParam()},
+    .spinner = "🔓 Running AES decryption ...", .score = "AESDEC STRESS SCORE", .logs = {"AES_Decrypt"},
+    .variants = {{.name = "aes-ni", .isa = ISA_AVX | ISA_AES,
+                  .make = [](const TestValues& v, const WorkerSlot&) {
+                      return std::make_unique<AesWorkload>(v.count("iterations"), static_cast<int>(v.get("blocksize")), true);
+                  }}},
+});
+
+const RegisterTest sha_test({
+    .name = "sha", .title = "SHA-256 Hashing", .category = "🛡️ SECURITY TESTS", .menu = 'B',
+    .params = {iterationsParam("sha_iterations", 100000000)},
+    .spinner = "🔐 Running SHA-256 hashing...", .score = "SHA STRESS SCORE", .logs = {"SHA256_Hash"},
+    .variants = {{.name = "sha-ni", .isa = ISA_SHA,
+                  .make = [](const TestValues& v, const WorkerSlot&) {
+                      return std::make_unique<Sha256Workload>(v.count("iterations"));
+                  }},
+                 {.name = "scalar", .make = [](const TestValues& v, const WorkerSlot&) {
+                      return std::make_unique<Sha256ScalarWorkload>(v.count("iterations"));
+                  }}},
+});
+
+const RegisterTest disk_test({
+    .name = "disk", .title = "Disk Write Stress", .category = "💾 I/O TESTS", .menu = 'C',
+    .params = {iterationsParam("disk_iterations", 20)},
+    .spinner = "💾 Running disk write...", .score = "DISK STRESS SCORE", .logs = {"Disk_Write"},
+    .variants = {{.name = "x86-64", .make = [](const TestValues& v, const WorkerSlot& s) {
+            return std::make_unique<DiskWriteWorkload>(v.count("iterations"), s.id);
+        }}},
+});
+
+} // namespace
@@ -1,4 +1,8 @@
+#include "cancel.hpp"
+#include "registry.hpp"
+#include "workerpool.hpp"
 #include <iostream>
+#include <iomanip>
 #include <vector>
 #include <thread>
 #include <chrono>
@@ -15,10 +19,10 @@ private:
     std::atomic<bool> running{false};
     std::atomic<uint64_t> total_operations{0};
     std::atomic<uint64_t> total_bytes_processed{0};
-    std::vector<std::thread> worker_threads;
     
+public:
     // Generate pseudo-random but compressible data
-    std::vector<uint8_t> generate_mixed_data(size_t size, double entropy = 0.7) {
+    static std::vector<uint8_t> generate_mixed_data(size_t size, double entropy = 0.7) {
         std::vector<uint8_t> data(size);
         std::random_device rd;
         std::mt19937 gen(rd());
@@ -81,7 +85,7 @@ private:
     }
     
     // DEFLATE compression (zlib)
-    bool deflate_compress_decompress(const std::vector<uint8_t>& input) {
+    static bool deflate_compress_decompress(const std::vector<uint8_t>& input) {
         // Compression
         uLongf compressed_size = compressBound(input.size());
         std::vector<uint8_t> compressed(compressed_size);
@@ -104,6 +108,7 @@ private:
                (std::memcmp(decompressed.data(), input.data(), input.size()) == 0);
     }
     
+private:
     // Multi-pass compression worker
     void compression_worker(const int worker_id, const size_t data_size, const int algorithm_mix) {
         std::cout << "Thread " << worker_id << " starting compression...\n";
@@ -111,7 +116,7 @@ private:
         uint64_t local_ops = 0;
         uint64_t local_bytes = 0;
         
-        while (running.load()) {
+        while (running.load() && !Cancellation::requested()) {
             // Generate different data patterns for each iteration
             auto data = generate_mixed_data(data_size, 0.3 + (local_ops % 7) * 0.1);
             
@@ -158,20 +163,21 @@ private:
     }
     
 public:
-    void start(int duration_seconds = 60, 
-                           size_t chunk_size = 1024 * 512) {
+    double start(int duration_seconds = 60, 
+                           size_t chunk_size = 1024 * 512,
+                           unsigned threads = 0) {
         
         if (running.load()) {
             std::cout << "Compression stress already running!\n";
-            return;
+            return 0.0;
         }
         
         running.store(true);
         total_operations.store(0);
         total_bytes_processed.store(0);
         
-        unsigned int num_threads = std::thread::hardware_concurrency();
-        if (num_threads == 0) num_threads = 8;
+        WorkerPool& pool = WorkerPool::getInstance();
+        const unsigned int num_threads = threads ? std::min(threads, pool.size()) : pool.size();
         
         std::cout << "Starting compression stress test:\n";
         std::cout << "- Threads: " << num_threads << "\n";
@@ -179,17 +185,18 @@ public:
         std::cout << "- Duration: " << duration_seconds << " seconds\n";
         std::cout << "- Algorithms: LZMA (level 9) + DEFLATE (max)\n\n";
         
-        // Launch worker threads
-        worker_threads.clear();
-        for (unsigned int i = 0; i < num_threads; ++i) {
-            worker_threads.emplace_back(&CompressNDecompress::compression_worker, 
-                                      this, i, chunk_size, 3);
-        }
+        // Hand the workers to the shared pool; this thread reports progress
+        pool.start(num_threads, [this, chunk_size](unsigned i) {
+            compression_worker(static_cast<int>(i), chunk_size, 3);
+        });
         
-        // Run for a specified duration with progress updates
+        // Run for a specified duration with progress updates; a cancel cuts
+        // the current second short, the workers see it after their chunk
         auto start_time = std::chrono::steady_clock::now();
-        for (int elapsed = 0; elapsed < duration_seconds; ++elapsed) {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+        for (int elapsed = 0; elapsed < duration_seconds && !Cancellation::requested(); ++elapsed) {
+            for (int tick = 0; tick < 10 && !Cancellation::requested(); ++tick) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
             
             auto ops = total_operations.load();
             auto bytes = total_bytes_processed.load();
@@ -201,13 +208,12 @@ public:
                       << mb_per_sec << " MB/s\r" << std::flush;
         }
         
-        std::cout << "\nStopping compression stress...\n";
+        std::cout << (Cancellation::requested() ? "\nInterrupted, stopping compression stress...\n"
+                                                : "\nStopping compression stress...\n");
         running.store(false);
         
         // Wait for all threads to finish
-        for (auto& thread : worker_threads) {
-            thread.join();
-        }
+        pool.wait();
         
         // Final statistics
         auto total_time = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -219,6 +225,7 @@ public:
         std::cout << "Average throughput: " << (total_bytes_processed.load() / (1024.0*1024.0)) / (total_time/1000.0) << " MB/s\n";
         std::cout << "Operations per second: " << (total_operations.load() * 1000.0) / total_time << "\n";
         std::cout << "====================================\n\n";
+        return total_time > 0 ? (total_operations.load() * 1000.0) / total_time : 0.0;
     }
     
     void stop() {
@@ -230,8 +237,47 @@ public:
     }
 };
 
+// One unit of compression_worker's loop, for callers that schedule and time
+// the work themselves (Workload-based runs). Returns false on a failed round trip.
+extern "C" bool lzmaRoundTrip(const unsigned worker_id, const unsigned long op, const size_t chunk_size) {
+    const auto data = CompressNDecompress::generate_mixed_data(chunk_size, 0.3 + (op % 7) * 0.1);
+    return (op + worker_id) % 3 < 2 ? CompressNDecompress::lzma_compress_decompress(data)
+                                    : CompressNDecompress::deflate_compress_decompress(data);
+}
+
 // Usage example
-extern "C" void startLZMA(const int duration) {
+extern "C" double startLZMA(const int duration, const unsigned threads) {
     CompressNDecompress test;
-    test.start(duration, 1024 * 512);
+    return test.start(duration, 1024 * 512, threads);
 }
+
+namespace {
+
+// One round trip per iteration on the shared pool, so LZMA gets trials,
+// statistics and records like every other test. A round trip that fails or
+// decompresses to something else counts as an error and fails the test.
+struct LzmaWorkload final : Workload {
+    static constexpr size_t CHUNK_SIZE = 512 * 1024;
+    const unsigned id;
+    unsigned long ops = 0;
+
+    explicit LzmaWorkload(unsigned id) : id(id) {}
+
+    void run(unsigned long iters) override {
+        for (unsigned long i = 0; i < iters; ++i) {
+            errors += !lzmaRoundTrip(id, ops++, CHUNK_SIZE);
+        }
+    }
+};
+
+// No iteration count: it runs for its duration unless the whole run has one
+const RegisterTest lzma_test({
+    .name = "lzma", .title = "LZMA Compression", .category = "💾 I/O TESTS", .menu = 'D',
+    .params = {{.name = "duration", .key = "lzma_duration", .fallback = 60, .prompt = "Duration (s)?: ", .integer = false,
+                .sizes = true, .scales = true, .seconds = true}},
+    .unit = "ops/s", .spinner = "🗜️ Running LZMA compression...", .score = "LZMA SCORE", .logs = {"LZMA_Compression"},
+    .variants = {{.name = "liblzma",
+                  .make = [](const TestValues&, const WorkerSlot& s) { return std::make_unique<LzmaWorkload>(s.id); }}},
+});
+
+} // namespace
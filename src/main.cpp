@@ -1,66 +1,245 @@
 #include "core.hpp"
-#include "pcg_random.hpp"
-#include "logger.hpp"
+#include "results.hpp"
+#include "cancel.hpp"
+#include "compare.hpp"
 #include "config.hpp"
 #include "menu.hpp"
+#include "registry.hpp"
 #include "spinner.hpp"
+#include "workload.hpp"
+#include "topology.hpp"
+#include "perf.hpp"
+#include "telemetry.hpp"
 #include <iostream>
-#include <random>
 #include <string>
 #include <unordered_map>
 #include <functional>
 #include <thread>
 #include <chrono>
 #include <vector>
-#include <cpuid.h>
+#include <cstring>
+#include <cstdio>
 #include <sched.h>
-#include <sys/mman.h>
 #include <algorithm>
 #include <numeric>
 #include <optional>
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
 
 class sift {
 public:
     void init() {
-        detect_cpu_features();
-        Logger::getInstance().logSystemInfo(cpu_brand, has_avx, has_avx2, has_fma, has_aes, has_sha);
-        
-        while (running) {
-            MenuSystem::showMainMenu(cpu_brand, has_avx, has_avx2, has_fma, has_aes, has_sha);
-
-            switch (MenuSystem::getMenuChoice()) {
-                case '1': initAvx(); break;
-                case '2': initRender(); break;
-                case '3': initMem(); break;
-                case '4': nuclearOption(); break;
-                case '5': initBranch(); break;
-                case '6': initCache(); break;
-                case '7': init3np1(); break;
-                case '8': initPrimes(); break;
-                case '9': initAESENC(); break;
-                case 'A': initAESDEC(); break;
-                case 'B': initSHA256(); break;
-                case 'C': initDiskWrite(); break;
-                case 'D': initLZMA(); break;
-                case 'R': showRecommendations(); break;
-                case 'Q': running = false; break;
-                default:
-                    std::cout << "\nInvalid option! Press Enter to continue...";
-                    std::cin.ignore();
-                    std::cin.get();
-                    break;
+        const CpuFeatures& cpu = CpuFeatures::getInstance();
+        ResultStore::getInstance().logSystemInfo(cpu.brand(), cpu.flags(),
+                                                 Topology::getInstance().describe(placement, num_threads), APP_VERSION);
+        
+        while (running && std::cin) {
+            MenuSystem::showMainMenu(cpu.brand(), cpu.summary(), menuEntries());
+
+            const char choice = MenuSystem::getMenuChoice();
+            if (const TestDescriptor* test = TestRegistry::getInstance().byMenuKey(choice)) {
+                runRegistered(*test);
+            } else {
+                switch (choice) {
+                    case '4': nuclearOption(); break;
+                    case 'R': showRecommendations(); break;
+                    case 'Q': running = false; break;
+                    default:
+                        std::cout << "\nInvalid option! Press Enter to continue...";
+                        std::cin.ignore();
+                        std::cin.get();
+                        break;
+                }
+            }
+            // Back at the menu a signal kills the process, so nothing may be left in the buffer
+            ResultStore::getInstance().flush();
+            if (Cancellation::requested()) {
+                std::cout << "\nInterrupted, partial results saved to " << ResultStore::getInstance().jsonlPath() << "\n";
+                Cancellation::reset();
+            }
+        }
+        ResultStore::getInstance().flush();
+    }
+
+    // Run every test for a fixed wall-clock time instead of a fixed iteration count
+    void setDuration(double seconds) { budget.seconds = seconds; }
+
+    // Lay the pool workers out per policy; the policy also decides how many
+    // of them a test uses (e.g. Physical leaves SMT siblings idle)
+    void setPlacement(Placement p) {
+        const Topology& topo = Topology::getInstance();
+        placement = p;
+        num_threads = std::min(topo.defaultThreads(p), WorkerPool::getInstance().size());
+        WorkerPool::getInstance().setAffinity(topo.order(p));
+    }
+
+    // Repeat every test: warm-up runs are discarded, measured runs feed TrialStats
+    void setTrials(unsigned measured, unsigned warmup) {
+        trial_plan.measured = std::max(1u, measured);
+        trial_plan.warmup = warmup;
+    }
+
+    // How tests are watched while they run: the ImGui window, the headless
+    // sampler alone, or nothing. Defaults to the window only with a display.
+    enum class MonitorMode { Gui, Quiet, Off };
+
+    static std::optional<MonitorMode> parseMonitor(const std::string& name) {
+        if (name == "gui") return MonitorMode::Gui;
+        if (name == "quiet") return MonitorMode::Quiet;
+        if (name == "off") return MonitorMode::Off;
+        return std::nullopt;
+    }
+
+    void setMonitor(MonitorMode mode) { monitor = mode; }
+
+    // Sampler rate in Hz and the CPU it is pinned to (-1: pick one per run)
+    void setTelemetry(double hz, int cpu) {
+        Telemetry::getInstance().setRate(hz);
+        telemetry_cpu = cpu;
+    }
+
+    void setInteractive(bool on) { interactive = on; }
+
+    // Process exit status, most severe first: 128 + signal when interrupted,
+    // 1 when a test failed or hit the temperature ceiling, 2 when one
+    // regressed against the baseline, 3 when one was UNSTABLE across trials
+    int exitCode() const {
+        if (Cancellation::requested()) return 128 + Cancellation::signal();
+        if (failures) return 1;
+        if (regressions) return 2;
+        return unstable ? 3 : 0;
+    }
+
+    // Preset key for "sift run <test> --<param> value", e.g. avx + lower -> avx.lower
+    static std::optional<std::string> paramKey(const std::string& test, const std::string& param) {
+        const TestDescriptor* descriptor = TestRegistry::getInstance().find(PresetSchema::testOf(test));
+        if (!descriptor || !descriptor->param(param)) return std::nullopt;
+        return test + "." + param;
+    }
+
+    // Preset that re-runs the tests of a baseline with their recorded
+    // parameters, for "sift --compare baseline.jsonl" without a preset file
+    static std::unordered_map<std::string, std::string> presetFromBaseline(const Baseline& base) {
+        std::unordered_map<std::string, std::string> config;
+        std::string order;
+        for (const auto& [name, params] : base.tests()) {
+            const TestDescriptor* test = loggedBy(name);
+            if (!test) continue; // scenario groups and unknown tests
+            if (!(" " + order + ",").contains(" " + test->name + ",")) {
+                order += (order.empty() ? "" : ", ") + test->name;
+            }
+            for (const auto& [param, value] : params) {
+                // A test's own duration (lzma) is its parameter, anyone else's the run's
+                if (test->param(param)) {
+                    config.try_emplace(test->name + "." + param, value);
+                } else if (param == "duration" || param == "trials" || param == "warmup_trials") {
+                    config.try_emplace(param, value);
+                }
+            }
+        }
+        config["test_order"] = order;
+        return config;
+    }
+
+    // Test whose records carry this name
+    static const TestDescriptor* loggedBy(const std::string& log_name) {
+        for (const TestDescriptor& test : TestRegistry::getInstance().all()) {
+            if (std::ranges::any_of(test.logs, [&](const std::string& prefix) { return log_name.starts_with(prefix); })) {
+                return &test;
             }
         }
+        return nullptr;
     }
 
     void runPreset(const std::unordered_map<std::string, std::string>& config) {
-        detect_cpu_features();
-        Logger::getInstance().logSystemInfo(cpu_brand, has_avx, has_avx2, has_fma, has_aes, has_sha);
+        // Ctrl-C anywhere in a preset finishes the current chunk and reports what ran
+        const Cancellation::Scope cancellable;
+        budget.seconds = getConfigValue(config, "duration", budget.seconds);
+        setTrials(getConfigValue(config, "trials", trial_plan.measured),
+                  getConfigValue(config, "warmup_trials", trial_plan.warmup));
+        trial_plan.max_cv = getConfigValue(config, "max_cv", trial_plan.max_cv * 100) / 100;
+        if (const auto it = config.find("monitor"); it != config.end()) {
+            if (const auto m = parseMonitor(it->second)) {
+                setMonitor(*m);
+            } else {
+                std::cout << "Unknown monitor '" << it->second << "' (gui, quiet, off), keeping the default\n";
+            }
+        }
+        setTelemetry(getConfigValue(config, "telemetry_hz", Telemetry::getInstance().rate()),
+                     getConfigValue(config, "telemetry_cpu", telemetry_cpu));
+        if (const auto it = config.find("placement"); it != config.end()) {
+            if (const auto p = parsePlacement(it->second)) {
+                setPlacement(*p);
+            } else {
+                std::cout << "Unknown placement '" << it->second << "', keeping " << placementName(placement) << "\n";
+            }
+        }
+        // After placement, which picks its own default count
+        num_threads = std::clamp(getConfigValue(config, "threads", num_threads), 1u, WorkerPool::getInstance().size());
+        for (const TestDescriptor& test : TestRegistry::getInstance().all()) {
+            if (!test.hazard.empty() && getConfigValue(config, test.hazard, std::string("ask")) == "allow") {
+                allowed_hazards.push_back(test.hazard);
+            }
+        }
+        ResultStore& store = ResultStore::getInstance();
+        if (const auto it = config.find("results"); it != config.end()) store.setJsonlPath(it->second);
+        if (const auto it = config.find("results_csv"); it != config.end()) store.setCsvPath(it->second);
+        store.setTimeseries(getConfigValue(config, "timeseries", std::string(store.timeseries() ? "on" : "off")) == "on");
+        ThermalWatch::setCeiling(getConfigValue(config, "max_temp", ThermalWatch::ceiling()));
+        if (const auto it = config.find("compare"); it != config.end()) {
+            compare_settings.alpha = getConfigValue(config, "compare_alpha", compare_settings.alpha);
+            compare_settings.min_change = getConfigValue(config, "compare_min_change", compare_settings.min_change * 100) / 100;
+            std::string error;
+            baseline.emplace();
+            if (!baseline->load(it->second, error)) {
+                std::cout << "Baseline: " << error << ", comparison disabled\n";
+                baseline.reset();
+            } else {
+                baseline_path = it->second;
+            }
+        }
+        CpuFeatures& cpu = CpuFeatures::getInstance();
+        if (const auto it = config.find("disable_isa"); it != config.end()) cpu.disable(parseIsa(it->second).value_or(0));
+        ResultStore::getInstance().logSystemInfo(cpu.brand(), cpu.flags(),
+                                                 Topology::getInstance().describe(placement, num_threads), APP_VERSION);
+
+        std::cout << "SIFT version " << APP_VERSION << " | CPU: " << cpu.brand() << "\n";
+        std::cout << cpu.summary() << "\n";
+        std::cout << "Running preset configuration...\n";
+        std::cout << "Placement: " << Topology::getInstance().describe(placement, num_threads) << "\n";
+        std::cout << "TSC: " << Tsc::getInstance().ghz() << " GHz"
+                  << (Tsc::getInstance().invariant() ? "" : " (not invariant, cycle counts follow P-states)") << "\n";
+        if (budget.timed()) std::cout << "Duration mode: " << budget.seconds << " s per test\n";
+        if (monitor != MonitorMode::Off) {
+            std::cout << "Monitor: " << (monitor == MonitorMode::Gui ? "window" : "headless") << ", sampling at "
+                      << Telemetry::getInstance().rate() << " Hz on CPU " << housekeepingCpu() << "\n";
+        }
+        if (trial_plan.measured > 1 || trial_plan.warmup) {
+            std::cout << "Trials: " << trial_plan.measured << " measured, " << trial_plan.warmup << " warm-up\n";
+        }
+        if (ThermalWatch::ceiling() > 0) {
+            std::cout << "Temperature ceiling: " << ThermalWatch::ceiling() << " C"
+                      << (ThermalSensors::getInstance().hasTemperature() ? "" : " (no package temperature sensor, not enforced)")
+                      << "\n";
+        }
+        if (baseline) {
+            std::cout << "Baseline: " << baseline_path << " (" << baseline->records() << " test records, alpha "
+                      << compare_settings.alpha << ")\n";
+            if (trial_plan.measured < 4) {
+                std::cout << "Baseline: with fewer than 4 trials a change rarely reaches significance, use --trials\n";
+            }
+        }
+        std::cout << "\n";
 
-        std::cout << "SIFT version " << APP_VERSION << " | CPU: " << cpu_brand << "\n";
-        std::cout << "Running preset configuration...\n\n";
+        if (config.contains("scenario")) {
+            runScenario(config);
+        }
 
         auto tests = ConfigParser::getTestOrder(config);
+        if (tests.empty() && config.contains("scenario")) {
+            return;
+        }
         if (tests.empty()) {
             std::cout << "No tests specified in config file.\n";
             return;
@@ -68,128 +247,107 @@ public:
 
         const auto start = std::chrono::high_resolution_clock::now();
 
-        for (const auto& test : tests) {
-            std::cout << "Running test: " << test << "\n";
-
-            if (test == "avx") {
-                auto iter = getConfigValue(config, "avx_iterations", 200000UL);
-                auto lower = getConfigValue(config, "avx_lower", 0.0001f);
-                auto upper = getConfigValue(config, "avx_upper", 1000000000000000.0f);
-                initAvx(iter, lower, upper);
+        const bool sweep = getConfigValue(config, "sweep", std::string("off")) != "off";
+        // "loop = N" runs the whole sequence N times, 0 until interrupted or too hot
+        const unsigned loops = getConfigValue(config, "loop", 1u);
+        bool stop = false;
+        for (unsigned pass = 1; !stop && (loops == 0 || pass <= loops); ++pass) {
+            if (loops != 1) {
+                std::cout << "\n=== Loop " << pass << (loops ? " of " + std::to_string(loops) : "") << " ===\n";
             }
-            else if (test == "3np1") {
-                auto iter = getConfigValue(config, "3np1_iterations", 20000000UL);
-                auto lower = getConfigValue(config, "3np1_lower", 1UL);
-                auto upper = getConfigValue(config, "3np1_upper", 1000000000000000UL);
-                init3np1(iter, lower, upper);
-            }
-            else if (test == "mem") {
-                auto iter = getConfigValue(config, "mem_iterations", 20UL);
-                initMem(iter);
-            }
-            else if (test == "branch") {
-                auto iter = getConfigValue(config, "branch_iterations", 5000000000UL);
-                auto pattern = getConfigValue(config, "branch_pattern", 4);
-                initBranch(iter, pattern);
-            }
-            else if (test == "cache") {
-                auto iter = getConfigValue(config, "cache_iterations", 5000UL);
-                initCache(iter);
+            const size_t reported = last_results.size();
+            for (const auto& test : tests) {
+                ThermalWatch::rearm();
+                if (ThermalWatch::tripped()) {
+                    std::cout << "Temperature ceiling reached, skipping the remaining tests\n";
+                    stop = true;
+                    break;
+                }
+                if (Cancellation::requested()) {
+                    std::cout << "Interrupted, skipping the remaining tests\n";
+                    stop = true;
+                    break;
+                }
+                std::cout << "Running test: " << test << "\n";
+                const EntryScope entry(*this, test, config);
+                if (sweep) {
+                    runSweep(test, config);
+                } else if (!runTest(test, config)) {
+                    std::cout << "Unknown test: " << test << "\n";
+                }
             }
-            else {
-                std::cout << "Unknown test: " << test << "\n";
+            if (loops == 0 && last_results.size() == reported) {
+                std::cout << "Nothing ran in this loop, stopping\n";
+                stop = true;
             }
         }
 
         const auto duration = std::chrono::high_resolution_clock::now() - start;
-        std::cout << "\nPreset complete! Total time: "
+        std::cout << "\nPreset " << (Cancellation::requested() ? "interrupted" : "complete") << "! Total time: "
                   << std::chrono::duration_cast<std::chrono::seconds>(duration).count()
                   << " seconds\n";
+        printComparisonSummary();
+        store.flush();
+        std::cout << "Results: " << store.jsonlPath() << " (run " << store.runId() << ")\n";
     }
 
 private:
     bool running = true;
     std::string op_mode;
-    std::string cpu_brand;
-    bool has_avx = false, has_avx2 = false, has_fma = false, has_aes = false, has_sha = false;
-    const unsigned int num_threads = std::thread::hardware_concurrency();
+    unsigned int num_threads = WorkerPool::getInstance().size();
+    Placement placement = Placement::Linear;
+    Budget budget;
+    TrialPlan trial_plan;
+    // Hazards (rowhammer) allowed by the preset, the command line or a yes at the prompt
+    std::vector<std::string> allowed_hazards;
+    // False for "sift run" and piped input: nothing may wait on stdin or clear the terminal
+    bool interactive = isatty(STDIN_FILENO) != 0;
+    MonitorMode monitor = std::getenv("DISPLAY") || std::getenv("WAYLAND_DISPLAY") ? MonitorMode::Gui : MonitorMode::Quiet;
+    int telemetry_cpu = -1;
+    // Aggregate throughput (sum over threads) of every score the last test reported
+    std::vector<std::pair<std::string, double>> last_results;
+    TestClock last_clock; // of the last reportScores
+    std::optional<Baseline> baseline;
+    std::string baseline_path;
+    Baseline::Settings compare_settings;
+    unsigned compared = 0, regressions = 0, improvements = 0;
+    unsigned failures = 0, unstable = 0; // tests that could not run or reported no work; UNSTABLE verdicts
 
     static constexpr auto APP_VERSION = "0.9.0";
-    static constexpr int AVX_BUFFER_SIZE = 64; // 256 bytes (L1 cache line optimized)
-    static constexpr int COLLATZ_BATCH_SIZE = 10000000;
-
-    const std::unordered_map<std::string, std::function<void()>> command_map = {
-        {"exit", [this]() { running = false; }},
-        {"menu", [this]() { showMenu(); }},
-        {"avx",  [this]() { initAvx(); }},
-        {"3np1", [this]() { init3np1(); }},
-        {"primes", [this]() { initPrimes(); }},
-        {"disk", [this]() { initDiskWrite(); }},
-        {"full", [this]() { nuclearOption(); }},
-        {"mem", [this]() { initMem(); }},
-        {"sha", [this]() { initSHA256(); }},
-        {"lzma", [this]() { initLZMA(); }},
-        {"aesenc", [this]() { initAESENC(); }},
-        {"aesdec", [this]() { initAESDEC(); }},
-        {"render", [this]() { initRender(); }},
-        {"branch", [this]() { initBranch(); }},
-        {"cache", [this]() { initCache(); }},
-        {"rec", [this]() { showRecommendations(); }}
-    };
-
-    void detect_cpu_features() {
-        char brand[0x40] = {0};
-        unsigned int eax, ebx, ecx, edx;
-
-        __get_cpuid(0x80000002, &eax, &ebx, &ecx, &edx);
-        memcpy(brand, &eax, 4); memcpy(brand+4, &ebx, 4);
-        memcpy(brand+8, &ecx, 4); memcpy(brand+12, &edx, 4);
-
-        __get_cpuid(0x80000003, &eax, &ebx, &ecx, &edx);
-        memcpy(brand+16, &eax, 4); memcpy(brand+20, &ebx, 4);
-        memcpy(brand+24, &ecx, 4); memcpy(brand+28, &edx, 4);
-
-        __get_cpuid(0x80000004, &eax, &ebx, &ecx, &edx);
-        memcpy(brand+32, &eax, 4); memcpy(brand+36, &ebx, 4);
-        memcpy(brand+40, &ecx, 4); memcpy(brand+44, &edx, 4);
-
-        __get_cpuid(1, &eax, &ebx, &ecx, &edx);
-        has_aes = ecx & bit_AES;        // Missing AES-NI detection
-        has_sha = false;                // Add SHA-NI detection
 
-        __get_cpuid(7, &eax, &ebx, &ecx, &edx);
-        has_sha = ebx & (1 << 29);      // SHA-NI support
-        cpu_brand = brand;
-
-        __get_cpuid(1, &eax, &ebx, &ecx, &edx);
-        has_avx = ecx & bit_AVX;
-        has_fma = ecx & bit_FMA;
+    // Tests whose report is not one record per run; all others go through
+    // runRegistered's generic path
+    using Driver = std::function<void(const TestDescriptor&, const KernelVariant&, const TestValues&)>;
+    const std::unordered_map<std::string, Driver> drivers = {
+        {"cache", [this](const TestDescriptor& cache, const KernelVariant& kernel, const TestValues& values) {
+            runCache(cache, kernel, values);
+        }},
+        {"latency", [this](const TestDescriptor& latency, const KernelVariant& kernel, const TestValues& values) {
+            runLatency(latency, kernel, values);
+        }},
+    };
 
-        __get_cpuid(7, &eax, &ebx, &ecx, &edx);
-        has_avx2 = ebx & bit_AVX2;
+    // Every registered test under its key, plus the full system test
+    static std::vector<MenuSystem::Entry> menuEntries() {
+        std::vector<MenuSystem::Entry> entries;
+        const unsigned isa = CpuFeatures::getInstance().usable();
+        for (const TestDescriptor& test : TestRegistry::getInstance().all()) {
+            entries.push_back({test.menu, test.title + (test.variant(isa) ? "" : " (n/a)"), test.category});
+        }
+        entries.push_back({'4', "Full System Torture", "NORMAL TESTS"});
+        std::ranges::stable_sort(entries, {}, [](const MenuSystem::Entry& e) { return TestRegistry::MENU_KEYS.find(e.key); });
+        return entries;
     }
 
-    static void showMenu() {
-        std::cout << "\n========= SIFT =========\n"
-                  << "Extreme System Stability Test\n"
-                  << "avx   - AVX/FMA Stress Test\n"
-                  << "3np1  - Collatz Conjecture bruteforce\n"
-                  << "primes  - Prime bruteforce\n"
-                  << "mem   - Extreme memory testing\n"
-                  << "aesenc   - Vector AES Encrypt stressing\n"
-                  << "aesdec   - Vector AES Decrypt stressing\n"
-                  << "sha   - SHA_NI stressing\n"
-                  << "disk   - Disk stressing\n"
-                  << "lzma   - CPU compression and decompression using LZMA\n"
-                  << "render - BRUTAL CPU Ray-tracing (Cinebench killer)\n"
-                  << "branch - Branch Prediction (Real-world patterns)\n"
-                  << "cache  - Cache Hierarchy Tests (L1/L2/L3/Latency)\n"
-                  << "rec    - Show Recommended Iterations for Accurate Results\n"
-                  << "gpu   - GPU stressing with HIP\n"
-                  << "full  - Combined Full System Stress\n"
-                  << "exit  - Exit Program\n\n";
-    }
-    static std::string formatIPS(const double flops) {
+    // Scores in the test's unit; plain iterations keep the GIPS/MIPS spelling
+    static std::string formatIPS(const double flops, const std::string& unit = "ips") {
+        if (unit != "ips") {
+            const char* prefix[] = {"", "k", "M", "G", "T"};
+            double scaled = flops;
+            int p = 0;
+            for (; scaled >= 1000 && p < 4; ++p) scaled /= 1000;
+            return std::to_string(scaled) + " " + prefix[p] + unit;
+        }
         if (flops >= 1e9) {
             return std::to_string(flops / 1e9) + " GIPS";
         }
@@ -202,534 +360,527 @@ private:
         return std::to_string(flops) + " IPS";
     }
 
-    static void initLZMA (std::optional<int> duration_o = std::nullopt){
-        if (!duration_o.has_value()) {
-            std::cout << "Duration (s)?: ";
-            if (!(std::cin >> duration_o.emplace())) return;
+    // " | 123.4 cyc/it | 45.6 ns/it"; cycles are TSC reference cycles. A test
+    // scored in another unit costs per one of it: " | 0.0156 cyc/FLOP | ..."
+    static std::string formatCost(const IterationCost& cost, const std::string& unit = "ips") {
+        char buf[96];
+        if (unit == "ips") {
+            std::snprintf(buf, sizeof(buf), " | %.1f cyc/it | %.1f ns/it", cost.cycles, cost.ns);
+            return buf;
         }
-        spawn_system_monitor();
-        const int duration = duration_o.value();
-        if (duration_o.value() == 0) return;
-        startLZMA(duration);
-        stop_system_monitor();
+        std::string item = unit.ends_with("/s") ? unit.substr(0, unit.size() - 2) : unit;
+        if (item.size() > 1 && (item.ends_with("S") || item.ends_with("s"))) item.pop_back();
+        std::snprintf(buf, sizeof(buf), " | %.3g cyc/%s | %.3g ns/%s", cost.cycles, item.c_str(), cost.ns, item.c_str());
+        return buf;
     }
 
-    void init3np1(std::optional<unsigned long> iterations_o = std::nullopt, std::optional<unsigned long> lower_o = std::nullopt, std::optional<unsigned long> upper_o = std::nullopt) const {
-        if (!iterations_o.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> iterations_o.emplace())) return;
-        }
-        if (!lower_o.has_value()) {
-            std::cout << "Lower bound?: ";
-            if (!(std::cin >> lower_o.emplace())) return;
-        }
-        if (!upper_o.has_value()) {
-            std::cout << "Upper bound?: ";
-            if (!(std::cin >> upper_o.emplace())) return;
-        }
-        const unsigned long iterations = iterations_o.value();
-        const unsigned long lower = lower_o.value();
-        const unsigned long upper = upper_o.value();
-        if (iterations_o.value() == 0) return;
-        Spinner spinner("🔥 Running 3n+1 Collatz test...");
-        // Suppress GUI warnings
-        freopen("/dev/null", "w", stderr);
-        spawn_system_monitor();
-        freopen("/dev/tty", "w", stderr);
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
-        
-        for (int i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = collatzWorker(iterations, lower, upper, i);
-            });
-        }
-        for (auto& t : threads) t.join();
-        spinner.stop();
-
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg   = total / static_cast<double>(scores.size());
-        std::ranges::sort(scores);
-        const double median = scores[scores.size() / 2];
+    // "IPC 2.31 | MPKI br 0.4 L1D 12.1 LLC 0.1 dTLB 0.0 | 3.91 GHz", n/a for refused events
+    static std::string formatCounters(const PerfCounts& c) {
+        auto field = [&](int event, double value, const char* fmt) {
+            char buf[32];
+            if (!c.has(event)) return std::string("n/a");
+            std::snprintf(buf, sizeof(buf), fmt, value);
+            return std::string(buf);
+        };
+        const double ghz = c.effectiveGhz(Tsc::getInstance().ghz());
+        return "IPC " + field(PERF_INSTRUCTIONS, c.ipc(), "%.2f") +
+               " | MPKI br " + field(PERF_BRANCH_MISSES, c.mpki(PERF_BRANCH_MISSES), "%.2f") +
+               " L1D " + field(PERF_L1D_MISSES, c.mpki(PERF_L1D_MISSES), "%.2f") +
+               " LLC " + field(PERF_LLC_MISSES, c.mpki(PERF_LLC_MISSES), "%.2f") +
+               " dTLB " + field(PERF_DTLB_MISSES, c.mpki(PERF_DTLB_MISSES), "%.2f") +
+               " | " + (ghz > 0 ? field(PERF_REF_CYCLES, ghz, "%.2f") + " GHz" : std::string("n/a GHz"));
+    }
 
-        // Log results
-        Logger::getInstance().logTestResult("3n+1_Collatz", scores, avg, median, cpu_brand);
-        
-        system("clear");
-        std::cout << "\n🏆 ====== 3n+1 STRESS SCORE ======\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": "
-                      << formatIPS(scores[i]) << " 🔥\n";
+    static void printCounters(const std::vector<PerfCounts>& counts, const std::string& indent = "") {
+        PerfCounts total;
+        for (const auto& c : counts) total += c;
+        if (!total.any()) {
+            std::cout << indent << "Counters: unavailable (perf_event_paranoid="
+                      << PerfGroup::paranoidLevel() << " or no PMU)\n";
+            return;
         }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << " ⚡\n";
-        std::cout << "Median: " << formatIPS(median) << " ⚡\n";
-        std::cout << "================================\n";
-        std::cout << "\nPress Enter to continue...";
-        std::cin.ignore();
-        std::cin.get();
-        stop_system_monitor();
-
+        std::cout << indent << "Counters (user mode):\n";
+        for (size_t i = 0; i < counts.size(); ++i) {
+            std::cout << indent << "  Thread " << i << ": " << formatCounters(counts[i]) << "\n";
+        }
+        std::cout << indent << "  Total:    " << formatCounters(total) << "\n";
     }
 
-    void initPrimes(std::optional<unsigned long> iterations_o = std::nullopt, std::optional<float> lower_o = std::nullopt, std::optional<float> upper_o = std::nullopt) const {
-        if (!iterations_o.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> iterations_o.emplace())) return;
-        }
-        if (!lower_o.has_value()) {
-            std::cout << "Lower bound?: ";
-            if (!(std::cin >> lower_o.emplace())) return;
-        }
-        if (!upper_o.has_value()) {
-            std::cout << "Upper bound?: ";
-            if (!(std::cin >> upper_o.emplace())) return;
-        }
-        const unsigned long iterations = iterations_o.value();
-        const unsigned long lower = lower_o.value();
-        const unsigned long upper = upper_o.value();
-        if (iterations_o.value() == 0) return;
-        Spinner spinner("🔢 Running prime factorization ...");
-        spawn_system_monitor();
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
-
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = primesWorker(iterations, lower, upper, i);
-            });
+    // "Top-down (amd-zen): Retiring 41.2% | Bad Spec 3.1% | Frontend 9.0% | Backend 46.7% (Memory 40.1% / Core 6.6%)"
+    static std::string formatTopDown(const TopDown& d) {
+        char buf[256];
+        if (!d.valid) return "Top-down: unavailable";
+        const char* memory_note = d.memory_approx ? " est." : "";
+        if (d.frontend_valid) {
+            std::snprintf(buf, sizeof(buf),
+                          "Top-down (%s): Retiring %.1f%% | Bad Spec %.1f%% | Frontend %.1f%% | Backend %.1f%% (Memory%s %.1f%% / Core %.1f%%)",
+                          d.method, d.retiring * 100, d.bad_spec * 100, d.frontend * 100, d.backend * 100,
+                          memory_note, d.memory * 100, d.core * 100);
+        } else {
+            std::snprintf(buf, sizeof(buf),
+                          "Top-down (%s): Retiring %.1f%% | Bad Spec %.1f%% | Frontend+Backend %.1f%% (Memory%s %.1f%% / other %.1f%%)",
+                          d.method, d.retiring * 100, d.bad_spec * 100, d.backend * 100,
+                          memory_note, d.memory * 100, d.core * 100);
         }
-        for (auto& t : threads) t.join();
-        spinner.stop();
+        return buf;
+    }
 
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg   = total / scores.size();
-        std::ranges::sort(scores);
-        const double median = scores[scores.size() / 2];
+    // The sampler's CPU: one the placement leaves idle at this thread count if
+    // there is one, else CPU 0, where the kernel's own housekeeping runs
+    unsigned housekeepingCpu() const {
+        if (telemetry_cpu >= 0) return static_cast<unsigned>(telemetry_cpu);
+        const std::vector<unsigned> order = Topology::getInstance().order(placement);
+        return num_threads < order.size() ? order.back() : 0;
+    }
 
-        // Log results
-        Logger::getInstance().logTestResult("Primes_Stress", scores, avg, median, cpu_brand);
-        
-        std::cout << "\n====== PRIMES STRESS SCORE ======\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": "
-                      << formatIPS(scores[i]) << "\n";
+    void startMonitor() {
+        if (monitor == MonitorMode::Off) return;
+        Telemetry::getInstance().setCpu(static_cast<int>(housekeepingCpu()));
+        if (monitor == MonitorMode::Gui) {
+            spawn_system_monitor();
+        } else {
+            spawn_system_monitor_quiet();
         }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
-        std::cout << "==================================\n";
-        stop_system_monitor();
-        
     }
 
-    void initAvx(std::optional<unsigned long> iterations_o = std::nullopt, std::optional<float> lower_o = std::nullopt, std::optional<float> upper_o = std::nullopt) const {
-        if (!iterations_o.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> iterations_o.emplace())) return;
-        }
-        if (!lower_o.has_value()) {
-            std::cout << "Lower bound?: ";
-            if (!(std::cin >> lower_o.emplace())) return;
-        }
-        if (!upper_o.has_value()) {
-            std::cout << "Upper bound?: ";
-            if (!(std::cin >> upper_o.emplace())) return;
-        }
-        const unsigned long iterations = iterations_o.value();
-        const unsigned long lower = lower_o.value();
-        const unsigned long upper = upper_o.value();
-        if (iterations_o.value() == 0) return;
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
-        Spinner spinner("⚡ Running AVX/FMA vector...");
-        spawn_system_monitor();
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = avxWorker(iterations, lower, upper, i);
-            });
+    void stopMonitor() {
+        if (monitor == MonitorMode::Gui) {
+            stop_system_monitor();
+        } else if (monitor == MonitorMode::Quiet) {
+            stop_system_monitor_quiet();
         }
-        for (auto& t : threads) t.join();
-        spinner.stop();
-
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg   = total / scores.size();
-        std::sort(scores.begin(), scores.end());
-        double median = scores[scores.size() / 2];
+    }
 
-        // Log results
-        Logger::getInstance().logTestResult("AVX_Stress", scores, avg, median, cpu_brand);
-        
-        std::cout << "\n====== AVX STRESS SCORE ======\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": "
-                      << formatIPS(scores[i]) << "\n";
+    // "Clock: 3.42 GHz (counters), 0.95x the 3.60 GHz TSC"
+    static std::string formatClock(const TestClock& clock) {
+        if (clock.ghz <= 0) return "Clock: unavailable (no cycle counters or cpufreq)";
+        char buf[96];
+        int n = std::snprintf(buf, sizeof(buf), "Clock: %.2f GHz (%s)", clock.ghz, clock.source);
+        if (clock.ratio() > 0) {
+            std::snprintf(buf + n, sizeof(buf) - static_cast<size_t>(n), ", %.2fx the %.2f GHz TSC", clock.ratio(),
+                          Tsc::getInstance().ghz());
         }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
-        std::cout << "===============================\n";
-        stop_system_monitor();
-        
+        return buf;
     }
 
-
-    void initMem(std::optional<unsigned long> user_iterations = std::nullopt) const {
-        char status;
-        std::cout << "ONE TIME WARNING, THIS TEST CONTAINS ROWHAMMER ATTACK, PROCEED? (yY/nN): ";
-        std::cin >> status;
-        switch (status) {
-        case 'y': case 'Y': break;
-        default: return;
-        }
-        if (!user_iterations.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> user_iterations.emplace())) return;
-        }
-        if (user_iterations.value() == 0) return;
-        const unsigned long iterations = user_iterations.value();
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
-        Spinner spinner("💥 Running memory stress + rowhammer attack...");
-        spawn_system_monitor();
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = memoryWorker(iterations, i);
-            });
+    // "Peak:   812.3 GFLOPS of 1.02 TFLOPS theoretical (79.6%), 8 cores at 3.20 GHz (counters)"
+    // then per core and per socket
+    static void printPeak(const TestPeak& peak, const std::string& unit, const std::string& indent = "") {
+        if (peak.peak() <= 0) return;
+        char buf[160];
+        std::snprintf(buf, sizeof(buf), " (%.1f%%), %zu core%s at %.2f GHz (%s)", 100 * peak.fraction(), peak.cores,
+                      peak.cores == 1 ? "" : "s", peak.ghz, peak.source);
+        std::cout << indent << "Peak:   " << formatIPS(peak.score, unit) << " of " << formatIPS(peak.peak(), unit)
+                  << " theoretical" << buf << "\n";
+        std::cout << indent << "  per core: " << formatIPS(peak.score / static_cast<double>(peak.cores), unit) << " of "
+                  << formatIPS(peak.per_core, unit) << "\n";
+        for (const TestPeak::Socket& socket : peak.sockets) {
+            const double socket_peak = peak.per_core * static_cast<double>(socket.cores.size());
+            std::snprintf(buf, sizeof(buf), " (%.1f%%)", 100 * socket.score / socket_peak);
+            std::cout << indent << "  socket " << socket.package << ": " << formatIPS(socket.score, unit) << " of "
+                      << formatIPS(socket_peak, unit) << buf << "\n";
         }
-        for (auto& t : threads) t.join();
-        spinner.stop();
-
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg   = total / scores.size();
-        std::sort(scores.begin(), scores.end());
-        const double median = scores[scores.size() / 2];
+    }
 
-        // Log results
-        Logger::getInstance().logTestResult("Memory_Stress", scores, avg, median, cpu_brand);
-        
-        std::cout << "\n====== MEM STRESS SCORE ======\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": "
-                      << formatIPS(scores[i]) << "\n";
+    // "Total:  41.2 GB/s on 16 cores" then one line per socket
+    static void printSockets(const TestPeak& peak, const std::string& unit, const std::string& indent = "") {
+        std::cout << indent << "Total:  " << formatIPS(peak.score, unit) << " on " << peak.cores << " core"
+                  << (peak.cores == 1 ? "" : "s") << "\n";
+        for (const TestPeak::Socket& socket : peak.sockets) {
+            std::cout << indent << "  socket " << socket.package << ": " << formatIPS(socket.score, unit) << " ("
+                      << socket.cores.size() << " core" << (socket.cores.size() == 1 ? "" : "s") << ")\n";
         }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
-        std::cout << "=================================\n";
-        stop_system_monitor();
-        
     }
 
-    void initAESENC(std::optional<unsigned long> iterations_o = std::nullopt, std::optional<unsigned long> blksize_o = std::nullopt) const {
-        if (!iterations_o.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> iterations_o.emplace())) return;
-        }
-        if (!blksize_o.has_value()) {
-            std::cout << "Blocksize?: ";
-            if (!(std::cin >> blksize_o.emplace())) return;
-        }
-        if (iterations_o.value() == 0) return;
-        unsigned long iterations = iterations_o.value();
-        unsigned int block_size = blksize_o.value();
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
-        Spinner spinner("🔒 Running AES encryption...");
-        spawn_system_monitor();
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = aesENCWorker(iterations, i, block_size);
-            });
+    // "Energy: package 142.3 W | core 118.0 W | DRAM n/a | 41.2 nJ/it | 2.43e+07 it/J"
+    static std::string formatEnergy(const EnergyUse& use) {
+        const EnergyCounts& e = use.energy;
+        if (!e.any()) return "Energy: unavailable (no RAPL powercap zones, or energy_uj is root-only)";
+        auto watts = [&](int domain) {
+            char buf[32];
+            if (!e.has(domain)) return std::string("n/a");
+            std::snprintf(buf, sizeof(buf), "%.1f W", e.watts(domain));
+            return std::string(buf);
+        };
+        std::string out = "Energy: package " + watts(ENERGY_PACKAGE) + " | core " + watts(ENERGY_CORE) +
+                          " | DRAM " + watts(ENERGY_DRAM);
+        if (use.valid()) {
+            char buf[96];
+            std::snprintf(buf, sizeof(buf), " | %.4g nJ/it | %.4g it/J",
+                          use.joulesPerIteration() * 1e9, use.iterationsPerJoule());
+            out += buf;
         }
-        for (auto& t : threads) t.join();
-        spinner.stop();
-
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg   = total / scores.size();
-        std::sort(scores.begin(), scores.end());
-        const double median = scores[scores.size() / 2];
+        return out;
+    }
 
-        // Log results
-        Logger::getInstance().logTestResult("AES_Encrypt", scores, avg, median, cpu_brand);
-        
-        std::cout << "\n====== AESENC STRESS SCORE ======\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": "
-                      << formatIPS(scores[i]) << "\n";
+    // "Cores: busy 12-100% (least CPU 5) | 2.10-4.50 GHz (slowest CPU 7) | hottest 92 C (CPU 7)"
+    static void printCoreSpread(const std::vector<ThermalSummary::Core>& cores, const std::string& indent) {
+        if (cores.size() < 2) return;
+        using Core = ThermalSummary::Core;
+        const auto [idle, busy] = std::ranges::minmax_element(cores, {}, &Core::usage);
+        const auto [slow, fast] = std::ranges::minmax_element(cores, {}, &Core::mhz);
+        const auto hot = std::ranges::max_element(cores, {}, &Core::peak_c);
+        char buf[96];
+        std::string line = indent + "Cores:";
+        if (CpuTimes::getInstance().available()) {
+            std::snprintf(buf, sizeof(buf), " busy %.0f-%.0f%% (least CPU %u)", idle->usage, busy->usage, idle->cpu);
+            line += buf;
         }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
-        std::cout << "==================================\n";
-        stop_system_monitor();
-        
+        if (slow->mhz > 0) {
+            std::snprintf(buf, sizeof(buf), " | %.2f-%.2f GHz (slowest CPU %u)", slow->mhz / 1000, fast->mhz / 1000, slow->cpu);
+            line += buf;
+        }
+        if (hot->peak_c > 0) {
+            std::snprintf(buf, sizeof(buf), " | hottest %.0f C (CPU %u)", hot->peak_c, hot->cpu);
+            line += buf;
+        }
+        std::cout << line << "\n";
     }
 
-    void initAESDEC(std::optional<unsigned long> iterations_o = std::nullopt, std::optional<unsigned long> blksize_o = std::nullopt) {
-        if (!iterations_o.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> iterations_o.emplace())) return;
-        }
-        if (!blksize_o.has_value()) {
-            std::cout << "Blocksize?: ";
-            if (!(std::cin >> blksize_o.emplace())) return;
-        }
-        if (iterations_o.value() == 0) return;
-        spawn_system_monitor();
-        unsigned long iterations = iterations_o.value();
-        unsigned int block_size = blksize_o.value();
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
-        Spinner spinner("🔓 Running AES decryption ...");
-        spawn_system_monitor();
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = aesDECWorker(iterations, i, block_size);
-            });
+    // "Thermal: peak 87.0 C (+0.35 C/s) | throttling: 3 core, 1 package | slowest CPU 7 2.10 GHz"
+    // followed by one line per thread a throttle event visibly slowed down
+    void printThermal(const ThermalSummary& th, const std::string& indent = "") const {
+        constexpr size_t MAX_IMPACTS = 8;
+        const ThermalSensors& sensors = ThermalSensors::getInstance();
+        if (!sensors.hasTemperature() && !sensors.hasThrottleCounters() && !sensors.hasFrequency()) {
+            std::cout << indent << "Thermal: unavailable (no throttle counters, package temperature or cpufreq in sysfs)\n";
+            printCoreSpread(th.cores, indent);
+            return;
         }
-        for (auto& t : threads) t.join();
-        spinner.stop();
+        char buf[96];
+        std::string line = indent + "Thermal: ";
+        if (th.has_temperature) {
+            std::snprintf(buf, sizeof(buf), "peak %.1f C (%+.2f C/s)", th.peak_c, th.trend);
+            line += buf;
+        } else {
+            line += "temperature n/a";
+        }
+        if (sensors.hasThrottleCounters()) {
+            line += " | throttling: " + (th.throttled() ? std::to_string(th.core_events) + " core, " +
+                                                              std::to_string(th.package_events) + " package"
+                                                        : std::string("none"));
+        }
+        if (th.min_mhz > 0) {
+            std::snprintf(buf, sizeof(buf), " | slowest CPU %u %.2f GHz", th.min_cpu, th.min_mhz / 1000);
+            line += buf;
+        }
+        std::cout << line << "\n";
+        printCoreSpread(th.cores, indent);
+        if (th.aborted) {
+            std::cout << indent << "Thermal: ABORTED at the " << ThermalWatch::ceiling()
+                      << " C ceiling, remaining trials skipped and the last one is truncated\n";
+        }
+        for (size_t i = 0; i < th.impacts.size() && i < MAX_IMPACTS; ++i) {
+            const ThrottleImpact& im = th.impacts[i];
+            std::snprintf(buf, sizeof(buf), "%s %.1f%% after %s throttling at t=%.1f s",
+                          im.change < 0 ? "lost" : "gained", std::fabs(im.change) * 100,
+                          im.event.package ? "package" : "core", im.event.t);
+            std::cout << indent << "  Thread " << im.thread << " (CPU " << im.event.cpu << ") " << buf;
+            if (trial_plan.measured > 1) std::cout << " in trial " << im.trial + 1;
+            std::cout << "\n";
+        }
+        if (th.impacts.size() > MAX_IMPACTS) {
+            std::cout << indent << "  ... " << th.impacts.size() - MAX_IMPACTS << " more in the results file\n";
+        }
+    }
 
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg   = total / scores.size();
-        std::sort(scores.begin(), scores.end());
-        const double median = scores[scores.size() / 2];
+    // Feeds exitCode(). A thread with no work means its setup failed; a
+    // cancel leaves threads at zero too, but that has its own exit status.
+    // A workload that saw wrong results fails however fast it was.
+    void countOutcome(const std::vector<double>& scores, const TrialStats& stats, const ThermalSummary& thermal,
+                      unsigned long errors = 0) {
+        const bool idle = std::ranges::any_of(scores, [](double s) { return s <= 0; });
+        failures += (idle && !Cancellation::requested()) || thermal.aborted || errors > 0;
+        unstable += stats.kept.size() >= 2 && !stats.stable;
+    }
 
-        // Log results
-        Logger::getInstance().logTestResult("AES_Decrypt", scores, avg, median, cpu_brand);
-        
-        std::cout << "\n====== AESDEC STRESS SCORE ======\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": "
-                      << formatIPS(scores[i]) << "\n";
+    // Only for a cancel; a temperature abort has its own line under Thermal
+    void printTruncated(bool truncated, const TrialStats& stats, const std::string& indent = "") const {
+        if (!truncated || !Cancellation::requested()) return;
+        std::cout << indent << "TRUNCATED: interrupted, " << stats.trials.size() << " of "
+                  << std::max(1u, trial_plan.measured) << " trial(s) ran; scores cover the work done before the stop\n";
+    }
+
+    void printTrialStats(const TrialStats& stats, const std::string& unit, const std::string& indent = "") const {
+        if (stats.trials.size() < 2) return;
+        std::cout << indent << "Trials: " << stats.trials.size();
+        if (trial_plan.warmup) std::cout << " (+" << trial_plan.warmup << " warm-up)";
+        std::cout << ", " << stats.rejected() << " rejected as outliers\n";
+        std::cout << indent << "CV:     " << std::fixed << std::setprecision(2) << stats.cv * 100 << "%\n";
+        std::cout << indent << "95% CI: " << formatIPS(stats.ci_low, unit) << " .. " << formatIPS(stats.ci_high, unit)
+                  << " (+/-" << std::setprecision(2) << stats.relativeError() * 100 << "%)\n";
+        std::cout << indent << "Verdict: " << stats.verdict() << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+    }
+
+    // Judge a fresh record against the baseline, if one is loaded, and log the verdicts
+    std::vector<Comparison> compareToBaseline(const TestRecord& record) {
+        if (!baseline) return {};
+        ResultStore& store = ResultStore::getInstance();
+        auto results = baseline->compare(record, store.cpu(), store.host(), compare_settings);
+        if (results.empty()) return results;
+        // A single regressed thread fails the test; improvements only count per test
+        bool regressed = false, improved = false;
+        for (const auto& c : results) {
+            regressed |= c.verdict == Comparison::Verdict::Regressed;
+            improved |= c.scope == "test" && c.verdict == Comparison::Verdict::Improved;
         }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
-        std::cout << "==================================\n";
-        stop_system_monitor();
-        
+        ++compared;
+        regressions += regressed;
+        improvements += improved && !regressed;
+        store.logComparison(record.test, baseline_path, results);
+        return results;
     }
 
-    void initDiskWrite(std::optional<unsigned long> iterations_o = std::nullopt){
-        if (!iterations_o.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> iterations_o.emplace())) return;
-        }
-        unsigned long iterations = iterations_o.value();
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
-        Spinner spinner("💾 Running disk write...");
-        spawn_system_monitor();
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = diskWriteWorker(iterations, i);
-            });
+    void printComparison(const std::vector<Comparison>& results, const std::string& unit,
+                         const std::string& indent = "") const {
+        if (!baseline) return;
+        if (results.empty()) {
+            std::cout << indent << "Baseline: no matching record (same test, parameters, threads and CPU)\n";
+            return;
         }
-        for (auto& t : threads) t.join();
-        spinner.stop();
+        for (const auto& c : results) {
+            const bool whole = c.scope == "test";
+            // Threads are only listed when something moved
+            if (!whole && (c.verdict == Comparison::Verdict::Unchanged || c.verdict == Comparison::Verdict::Insufficient)) continue;
+            char buf[200];
+            std::snprintf(buf, sizeof(buf), "%+.2f%% (median %s -> %s, n=%zu/%zu, p=%.4f%s)",
+                          c.change * 100, formatIPS(c.baseline_median, unit).c_str(),
+                          formatIPS(c.current_median, unit).c_str(),
+                          c.baseline_n, c.current_n, c.test.p, c.test.exact ? " exact" : "");
+            const char* label = c.verdict == Comparison::Verdict::Regressed ? "REGRESSION"
+                              : c.verdict == Comparison::Verdict::Improved ? "IMPROVEMENT"
+                              : c.verdict == Comparison::Verdict::Unchanged ? "no significant change"
+                              : "too few trials to judge";
+            std::cout << indent << (whole ? "vs baseline: " : "  " + c.scope + ": ") << buf << " " << label << "\n";
+        }
+    }
 
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg   = total / scores.size();
-        std::sort(scores.begin(), scores.end());
-        const double median = scores[scores.size() / 2];
+    void printComparisonSummary() const {
+        if (!baseline) return;
+        std::cout << "\nBaseline comparison (" << baseline_path << "): " << compared << " compared, "
+                  << regressions << " regressed, " << improvements << " improved\n";
+    }
 
-        // Log results
-        Logger::getInstance().logTestResult("Disk_Write", scores, avg, median, cpu_brand);
-        
-        std::cout << "\n====== DISK STRESS SCORE ======\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": "
-                      << formatIPS(scores[i]) << "\n";
-        }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
-        std::cout << "================================\n";
-        stop_system_monitor();
-        
+    // Run settings every record carries next to the test's own parameters
+    ResultStore::Params runParams(ResultStore::Params params) const {
+        params.emplace_back("mode", budget.timed() ? "duration" : "iterations");
+        if (budget.timed()) params.emplace_back("duration", ResultStore::param(budget.seconds));
+        params.emplace_back("trials", ResultStore::param(trial_plan.measured));
+        params.emplace_back("warmup_trials", ResultStore::param(trial_plan.warmup));
+        return params;
     }
 
-    void initSHA256(std::optional<unsigned long> iterations_o = std::nullopt){
-        if (!iterations_o.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> iterations_o.emplace())) return;
-        }
-        const unsigned long iterations = iterations_o.value();
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
-        Spinner spinner("🔐 Running SHA-256 hashing...");
-        spawn_system_monitor();
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = sha256Worker(iterations, i);
-            });
+    void logTimeseries(const std::string& log_name, const std::vector<std::vector<Sample>>& trials) const {
+        ResultStore& store = ResultStore::getInstance();
+        if (!store.timeseries()) return;
+        for (size_t t = 0; t < trials.size(); ++t) {
+            if (trials[t].empty() || !trials[t].front().thermal) continue;
+            std::vector<unsigned> cpus;
+            for (const Sample& s : trials[t]) cpus.push_back(s.cpu);
+            store.logTimeseries(log_name, static_cast<unsigned>(t), *trials[t].front().thermal, cpus,
+                                threadSeries(trials[t]));
         }
-        for (auto& t : threads) t.join();
-        spinner.stop();
-
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg   = total / scores.size();
-        std::ranges::sort(scores);
-        const double median = scores[scores.size() / 2];
+    }
 
-        // Log results
-        Logger::getInstance().logTestResult("SHA256_Hash", scores, avg, median, cpu_brand);
-        
-        std::cout << "\n====== SHA STRESS SCORE ======\n";
+    void reportScores(const std::string& title, const std::string& log_name,
+                      const std::vector<std::vector<Sample>>& trials, const ResultStore::Params& params,
+                      const std::string& unit = "ips", const std::string& variant = "", double peak_per_cycle = 0,
+                      bool per_socket = false) {
+        if (trials.empty()) {
+            std::cout << "\n" << title << ": interrupted before the first measured trial, nothing recorded\n";
+            return;
+        }
+        const std::vector<double> scores = threadRates(trials);
+        const std::vector<IterationCost> costs = threadCosts(trials);
+        const std::vector<PerfCounts> counters = threadCounters(trials);
+        const TopDown topdown = testTopDown(trials);
+        const TrialStats stats = summarize(trialRates(trials), trial_plan.max_cv);
+        const double thread_median = median(scores);
+        last_results.emplace_back(log_name, stats.mean * static_cast<double>(scores.size()));
+
+        const EnergyUse energy = testEnergy(trials);
+        const ThermalSummary thermal = testThermal(trials);
+        last_clock = testClock(trials, thermal);
+        const TestPeak peak = testPeak(scores, trials.front(), peak_per_cycle, last_clock);
+        const unsigned long errors = testErrors(trials);
+        countOutcome(scores, stats, thermal, errors);
+        TestRecord record{log_name, runParams(params), Topology::getInstance().describe(placement, num_threads),
+                                scores, threadTrialRates(trials), costs, counters, topdown, stats, thread_median,
+                                energy, thermal, testTruncated(trials, trial_plan), unit, variant,
+                                last_clock.ghz, last_clock.source, peak.peak(), {}, errors};
+        for (const TestPeak::Socket& socket : peak.sockets) record.sockets.emplace_back(socket.package, socket.score);
+        ResultStore::getInstance().logTestResult(record);
+        logTimeseries(log_name, trials);
+        const auto comparisons = compareToBaseline(record);
+
+        const std::string header = "====== " + title + " ======";
+        std::cout << "\n" << header << "\n";
         for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": "
-                      << formatIPS(scores[i]) << "\n";
+            std::cout << "Thread " << i << ": " << formatIPS(scores[i], unit) << formatCost(costs[i], unit) << "\n";
         }
         std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
-        std::cout << "================================\n";
-        stop_system_monitor();
-        
+        std::cout << "Avg:    " << formatIPS(stats.mean, unit) << formatCost(meanCost(costs), unit) << "\n";
+        std::cout << "Median: " << formatIPS(thread_median, unit) << "\n";
+        printPeak(peak, unit);
+        if (per_socket) printSockets(peak, unit);
+        printTruncated(record.truncated, stats);
+        if (errors) std::cout << "FAILED: " << errors << " iteration(s) produced wrong results\n";
+        printTrialStats(stats, unit);
+        printCounters(counters);
+        std::cout << formatClock(last_clock) << "\n";
+        std::cout << formatTopDown(topdown) << "\n";
+        std::cout << formatEnergy(energy) << "\n";
+        printThermal(thermal);
+        printComparison(comparisons, unit);
+        std::cout << std::string(header.size(), '=') << "\n";
     }
 
-    void initRender(std::optional<int> resolution_o = std::nullopt, std::optional<int> samples_o = std::nullopt) const {
-        if (!resolution_o.has_value()) {
-            std::cout << "Resolution (1=720p, 2=1080p, 3=4K): ";
-            if (!(std::cin >> resolution_o.emplace())) return;
+    // The kernel variant a test runs with here (`chosen` if the preset named
+    // one), nothing when the CPU or the user rules it out; says why, and
+    // counts a test that was asked for but could not run as a failure
+    const KernelVariant* kernelFor(const TestDescriptor& test, const KernelVariant* chosen = nullptr) {
+        const CpuFeatures& cpu = CpuFeatures::getInstance();
+        const KernelVariant* kernel = chosen ? chosen : test.variant(cpu.usable());
+        if (chosen && !cpu.has(chosen->isa)) {
+            std::cout << "Skipping " << test.name << " (" << chosen->name << "): this CPU lacks "
+                      << cpu.missing(chosen->isa) << "\n";
+            ++failures;
+            return nullptr;
         }
-        if (!samples_o.has_value()) {
-            std::cout << "Samples: ";
-            if (!(std::cin >> samples_o.emplace())) return;
+        if (!kernel) {
+            std::cout << "Skipping " << test.name << ": this CPU lacks " << cpu.missing(test.variants.back().isa) << "\n";
+            ++failures;
+            return nullptr;
         }
-        int width = 0, height = 0;
-
-        switch (resolution_o.value()) {
-            case 1: width = 1280; height = 720; break;
-            case 2: width = 1920; height = 1080; break;
-            case 3: width = 3840; height = 2160; break;
-            default: break;
+        if (!chosen && kernel != &test.variants.front()) {
+            std::cout << test.name << ": using the " << kernel->name << " kernel, " << test.variants.front().name
+                      << " needs " << cpu.missing(test.variants.front().isa) << "\n";
         }
-        
-        std::cout << "\nCPU TRACER TEST\n";
-        std::cout << "Resolution: " << width << "x" << height << "\n";
-        std::cout << "Samples per pixel: " << (64 * samples_o.value()) << "\n";
-        
-        Spinner spinner("🎨 Running CPU ray-tracing...");
-        spawn_system_monitor();
-        
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
-        
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = renderWorker(width, height, samples_o.value(), i);
-            });
+        if (test.hazard.empty() || std::ranges::find(allowed_hazards, test.hazard) != allowed_hazards.end()) return kernel;
+        if (!interactive) {
+            std::cout << "Skipping " << test.name << ": it contains a " << test.hazard << " attack, allow it with --allow-"
+                      << test.hazard << " (" << test.hazard << " = allow)\n";
+            ++failures;
+            return nullptr;
         }
-        
-        for (auto& t : threads) t.join();
-        spinner.stop();
-        
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg = total / scores.size();
-        std::ranges::sort(scores);
-        const double median = scores[scores.size() / 2];
-        
-        // Log results
-        Logger::getInstance().logTestResult("CPU_Render", scores, avg, median, cpu_brand);
-        
-        std::cout << "\n========== RENDER SCORE ==========\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": " << formatIPS(scores[i]) << "\n";
+        char status = 'n';
+        std::cout << test.warning;
+        std::cin >> status;
+        if (status != 'y' && status != 'Y') return nullptr;
+        allowed_hazards.push_back(test.hazard);
+        return kernel;
+    }
+
+    // Asks for every parameter that has a prompt; false when input ran out or was out of range
+    bool promptValues(const TestDescriptor& test, TestValues& values) const {
+        for (const TestParam& p : test.params) {
+            double value = p.fallback;
+            if (p.sizes && budget.timed()) {
+                value = 0; // the duration sizes the run
+            } else if (!p.prompt.empty()) {
+                std::cout << p.prompt;
+                if (!(std::cin >> value)) return false;
+                if (value < p.min || value > p.max) {
+                    std::cout << p.name << " must be within " << TestValues::text(p.min) << ".." << TestValues::text(p.max) << "\n";
+                    return false;
+                }
+            }
+            values.set(p.name, value);
         }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
-        std::cout << "===================================\n";
-        
-        stop_system_monitor();
+        return true;
     }
 
-    void initBranch(std::optional<unsigned long> iterations_o = std::nullopt, std::optional<int> pattern_o = std::nullopt) {
-        if (!iterations_o.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> iterations_o.emplace())) return;
+    // One registered test: asks for its parameters unless given, runs it on
+    // num_threads pool workers and reports it
+    void runRegistered(const TestDescriptor& test, std::optional<TestValues> given = std::nullopt,
+                       const KernelVariant* chosen = nullptr) {
+        const KernelVariant* kernel = kernelFor(test, chosen);
+        if (!kernel) return;
+        TestValues values;
+        if (given) {
+            values = *given;
+        } else if (!promptValues(test, values)) {
+            return;
         }
-        if (!pattern_o.has_value()) {
-            std::cout << "Pattern (1=Gaming, 2=Database, 3=Compiler, 4=Mixed): ";
-            if (!(std::cin >> pattern_o.emplace())) return;
+        if (!budget.timed() && std::ranges::any_of(test.params, [&](const TestParam& p) {
+                return p.sizes && values.get(p.name) == 0;
+            })) {
+            return;
         }
-        
-        const char* pattern_names[] = {"", "Gaming AI", "Database Queries", "Compiler Parsing", "Mixed Workload"};
-        std::cout << "\n🎯 BRANCH PREDICTION : " << pattern_names[pattern_o.value()] << "\n\n";
-        
-        Spinner spinner("🎯 Running branch prediction...");
-        spawn_system_monitor();
-        
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
-        
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = branchWorker(iterations_o.value(), pattern_o.value(), i);
-            });
+        if (const auto driver = drivers.find(test.name); driver != drivers.end()) {
+            driver->second(test, *kernel, values);
+            return;
         }
-        
-        for (auto& t : threads) t.join();
-        spinner.stop();
-        
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg = total / scores.size();
-        std::ranges::sort(scores);
-        const double median = scores[scores.size() / 2];
-        
-        // Log results
-        const char* pattern_names_log[] = {"", "Gaming_AI", "Database_Queries", "Compiler_Parsing", "Mixed_Workload"};
-        std::string test_name = "Branch_" + std::string(pattern_names_log[pattern_o.value()]);
-        Logger::getInstance().logTestResult(test_name, scores, avg, median, cpu_brand);
-        
-        std::cout << "\n==== BRANCH PREDICTION SCORE ====\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": " << formatIPS(scores[i]) << "\n";
+        // A test without an iteration count (lzma) runs for its own duration unless the run has one
+        const Budget run_budget = budget;
+        ResultStore::Params params;
+        for (const TestParam& p : test.params) {
+            if (!p.seconds) {
+                params.emplace_back(p.name, TestValues::text(values.get(p.name)));
+            } else if (!budget.timed()) {
+                budget.seconds = values.get(p.name);
+            }
         }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
-        std::cout << "===================================\n";
-        
-        stop_system_monitor();
+        Spinner spinner(test.spinner);
+        startMonitor();
+        const auto trials = runTrials(num_threads, [&](unsigned i) {
+            return kernel->make(values, {i, num_threads, i});
+        }, budget, trial_plan);
+        spinner.stop();
+
+        reportScores(test.score, test.logName(values), trials, params, test.unit, kernel->name,
+                     test.peak_per_cycle ? test.peak_per_cycle(values, *kernel) : 0, test.per_socket);
+        stopMonitor();
+        budget = run_budget;
     }
 
-    void initCache(std::optional<unsigned long> iterations_o = std::nullopt) {
-        if (!iterations_o.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> iterations_o.emplace())) return;
-        }
-        
+    // All four levels back to back in one report; a level's record is what a
+    // scenario group with that cache level would log
+    void runCache(const TestDescriptor& cache, const KernelVariant& kernel, const TestValues& values) {
         std::cout << "\n🏗️ CACHE HIERARCHY TESTS\n\n";
         
-        Spinner spinner("🏗️ Running cache hierarchy tests...");
-        spawn_system_monitor();
+        Spinner spinner(cache.spinner);
+        startMonitor();
         
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
         std::vector<std::array<double, 4>> scores(num_threads); // L1, L2, L3, Latency
-        
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                auto result = cacheWorker(iterations_o.value(), i);
-                scores[i] = result;
-            });
+        std::vector<std::array<IterationCost, 4>> costs(num_threads);
+        std::array<std::vector<PerfCounts>, 4> counters;
+        std::array<TopDown, 4> topdown;
+        std::array<TrialStats, 4> stats;
+        std::array<std::vector<std::vector<double>>, 4> thread_trials;
+        std::array<EnergyUse, 4> energy;
+        std::array<ThermalSummary, 4> thermal;
+        std::array<TestClock, 4> clocks;
+        std::array<bool, 4> truncated{};
+        int levels = 0; // fewer than 4 when interrupted
+        const Budget level_budget{budget.seconds / 4}; // duration covers all four levels
+        const char* log_names[] = {"L1_Cache", "L2_Cache", "L3_Cache", "Memory_Latency"};
+        for (int level = 0; level < 4; ++level) {
+            TestValues level_values = values;
+            level_values.set("level", level);
+            const auto trials = runTrials(num_threads, [&](unsigned i) {
+                return kernel.make(level_values, {i, num_threads, i});
+            }, level_budget, trial_plan);
+            if (trials.empty()) break;
+            levels = level + 1;
+            truncated[level] = testTruncated(trials, trial_plan);
+            const auto rates = threadRates(trials);
+            const auto level_costs = threadCosts(trials);
+            for (size_t i = 0; i < rates.size(); ++i) {
+                scores[i][level] = rates[i];
+                costs[i][level] = level_costs[i];
+            }
+            stats[level] = summarize(trialRates(trials), trial_plan.max_cv);
+            thread_trials[level] = threadTrialRates(trials);
+            energy[level] = testEnergy(trials);
+            thermal[level] = testThermal(trials);
+            clocks[level] = testClock(trials, thermal[level]);
+            logTimeseries(log_names[level], trials);
+            counters[level] = threadCounters(trials);
+            topdown[level] = testTopDown(trials);
+            if (Cancellation::requested()) break;
         }
-        
-        for (auto& t : threads) t.join();
         spinner.stop();
         
         // Calculate averages for each test
@@ -742,440 +893,904 @@ private:
         
         const char* test_names[] = {"L1 Cache", "L2 Cache", "L3 Cache", "Memory Latency"};
         
-        // Log cache results
-        Logger::getInstance().logCacheResult(scores, cpu_brand);
+        for (int test = 0; test < levels; ++test) last_results.emplace_back(log_names[test], totals[test]);
+
+        std::array<std::vector<Comparison>, 4> comparisons;
+        for (int test = 0; test < levels; ++test) {
+            TestRecord record{log_names[test],
+                              runParams({{"iterations", TestValues::text(values.get("iterations"))},
+                                         {"level", ResultStore::param(test)}}),
+                              Topology::getInstance().describe(placement, num_threads),
+                              {}, thread_trials[test], {}, counters[test], topdown[test], stats[test], 0,
+                              energy[test], thermal[test], truncated[test], cache.unit, kernel.name,
+                              clocks[test].ghz, clocks[test].source};
+            for (size_t i = 0; i < scores.size(); ++i) {
+                record.scores.push_back(scores[i][test]);
+                record.costs.push_back(costs[i][test]);
+            }
+            record.thread_median = median(record.scores);
+            countOutcome(record.scores, stats[test], thermal[test]);
+            ResultStore::getInstance().logTestResult(record);
+            comparisons[test] = compareToBaseline(record);
+        }
         
+        if (levels < 4) {
+            std::cout << "\nCache tests interrupted, " << levels << " of 4 levels measured\n";
+        }
         std::cout << "\n===== CACHE HIERARCHY SCORES =====\n";
-        for (int test = 0; test < 4; ++test) {
+        for (int test = 0; test < levels; ++test) {
             std::cout << test_names[test] << ":\n";
             for (size_t i = 0; i < scores.size(); ++i) {
-                std::cout << "  Thread " << i << ": " << formatIPS(scores[i][test]) << "\n";
+                std::cout << "  Thread " << i << ": " << formatIPS(scores[i][test], cache.unit)
+                          << formatCost(costs[i][test], cache.unit) << "\n";
             }
-            std::cout << "  Average: " << formatIPS(totals[test] / scores.size()) << "\n\n";
+            std::cout << "  Average: " << formatIPS(totals[test] / scores.size(), cache.unit) << "\n";
+            printTruncated(truncated[test], stats[test], "  ");
+            printTrialStats(stats[test], cache.unit, "  ");
+            printCounters(counters[test], "  ");
+            std::cout << "  " << formatClock(clocks[test]) << "\n";
+            std::cout << "  " << formatTopDown(topdown[test]) << "\n";
+            std::cout << "  " << formatEnergy(energy[test]) << "\n";
+            printThermal(thermal[test], "  ");
+            printComparison(comparisons[test], cache.unit, "  ");
+            std::cout << "\n";
         }
         std::cout << "===================================\n";
         
-        stop_system_monitor();
+        stopMonitor();
     }
 
-    static void showRecommendations() {
-        std::cout << "\n======= RECOMMENDED ITERATIONS =======\n";
-        std::cout << "For accurate and consistent results:\n\n";
-        
-        std::cout << "🔥 TESTS (Maximum CPU Stress):\n";
-        std::cout << "  avx     : 200,000 iterations\n";
-        std::cout << "  render  : Resolution 3 (4K), 5 samples\n";
-        std::cout << "  mem     : 20 iterations\n";
-        std::cout << "\n";
-        
-        std::cout << "🎮 REAL-WORLD TESTS (Application Performance):\n";
-        std::cout << "  branch  : 5,000,000,000 iterations\n";
-        std::cout << "  3np1    : 20,000,000 iterations\n";
-        std::cout << "  primes  : 3 iterations\n";
-        std::cout << "  cache   : 5,000 iterations\n";
-        std::cout << "\n";
-        
-        std::cout << "🛡️ SECURITY TESTS (Crypto Performance):\n";
-        std::cout << "  aesenc  : 20 iterations, blocksize 24\n";
-        std::cout << "  aesdec  : 20 iterations, blocksize 24\n";
-        std::cout << "  sha     : 100,000,000 iterations\n";
-        std::cout << "\n";
-        
-        std::cout << "💾 I/O TESTS (System Integration):\n";
-        std::cout << "  disk    : 20 iterations\n";
-        std::cout << "  lzma    : 60 seconds\n";
-        std::cout << "\n";
-        
-        std::cout << "⚡ BOUNDS (for tests that need them):\n";
-        std::cout << "  AVX     : Lower 0.0001, Upper 1000000000000000\n";
-        std::cout << "  3n+1    : Lower 1, Upper 1000000000000000\n";
-        std::cout << "  Primes  : Lower 1, Upper 1000000000000000\n";
-        std::cout << "\n";
-        
-        std::cout << "💡 NOTES:\n";
-        std::cout << "  - These values provide ~30-60 second test duration\n";
-        std::cout << "  - Adjust based on your CPU speed if needed\n";
-        std::cout << "  - Use 'full' command with intensity 1 for all tests\n";
-        std::cout << "=======================================\n\n";
+    // "48 KB", "1.5 MB", "2 GB"
+    static std::string formatBytes(double bytes) {
+        const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+        int u = 0;
+        for (; bytes >= 1024 && u < 4; ++u) bytes /= 1024;
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.4g %s", bytes, units[u]);
+        return buf;
     }
 
-    void nuclearOption() {
-        unsigned long intensity = 1;
-        std::cout << "Intensity (1 = default): ";
-        std::cin >> intensity;
-        std::cout << "Launching full stress test...\n";
-        unsigned long nuke_iterations_avx = 200000 * intensity;
-        unsigned long nuke_iterations_3np1 = 20000000 * intensity;
-        unsigned long nuke_iterations_primes = 3 * intensity;
-        unsigned long nuke_iterations_aes = 20 * intensity;
-        unsigned long nuke_iterations_disk = 20 * intensity;
-        unsigned long nuke_iterations_mem = 20 * intensity;
-        unsigned long nuke_iterations_sha = 100000000 * intensity;
-        unsigned long nuke_duration_lzma = 60 * intensity;
-        unsigned long nuke_resolution_render = 3;
-        unsigned long nuke_samples_render = 5 * intensity;
-        unsigned long nuke_iterations_branch = 5000000000 * intensity;
-        unsigned long nuke_iterations_cache = 5000 * intensity;
-        constexpr unsigned long lower_avx = 0.0001, upper_avx = 1000000000000000;
-        constexpr unsigned long lower = 1, upper = 1000000000000000;
-        constexpr int block_size = 24;
-        const auto start = std::chrono::high_resolution_clock::now();
-        spawn_system_monitor();
-        initMem(nuke_iterations_mem);
-        initAvx(nuke_iterations_avx, lower_avx, upper_avx);
-        init3np1(nuke_iterations_3np1, lower, upper);
-        initPrimes(nuke_iterations_primes, lower, upper);
-        initAESENC(nuke_iterations_aes, block_size);
-        initAESDEC(nuke_iterations_aes, block_size);
-        initDiskWrite(nuke_iterations_disk);
-        initSHA256(nuke_iterations_sha);
-        initLZMA(nuke_duration_lzma);
-        initRender(nuke_resolution_render, nuke_samples_render);
-        initBranch(nuke_iterations_branch, 1);
-        initBranch(nuke_iterations_branch, 2);
-        initBranch(nuke_iterations_branch, 3);
-        initBranch(nuke_iterations_branch, 4);
-        initCache(nuke_iterations_cache);
-        const auto duration = std::chrono::high_resolution_clock::now() - start;
-        std::cout << "Full test complete! Time: "
-                  << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()
-                  << " ms\n";
-        stop_system_monitor();
-    }
+    // Working sets from 4 KB up to max_mb, two per octave (4, 6, 8, 12 KB...),
+    // one record per size and a table whose plateaus are the cache levels.
+    // Cycles are core cycles at the measured clock, TSC ticks without one.
+    void runLatency(const TestDescriptor& latency, const KernelVariant& kernel, const TestValues& values) {
+        std::vector<double> sizes_kb;
+        if (values.get("size_kb") > 0) {
+            sizes_kb.push_back(values.get("size_kb"));
+        } else {
+            const double max_kb = values.get("max_mb") * 1024;
+            for (double kb = 4; kb <= max_kb; kb *= 2) {
+                sizes_kb.push_back(kb);
+                if (kb * 1.5 <= max_kb) sizes_kb.push_back(kb * 1.5);
+            }
+        }
+        std::cout << "\n🔗 MEMORY LATENCY CURVE\n\n";
+
+        Spinner spinner(latency.spinner);
+        startMonitor();
+        struct Point {
+            double bytes;
+            IterationCost cost; // per load, over every thread
+            TestClock clock;
+            TrialStats stats;
+            bool truncated;
+            std::vector<Comparison> comparisons;
+        };
+        std::vector<Point> points;
+        const Budget point_budget{budget.seconds / static_cast<double>(sizes_kb.size())}; // duration covers the sweep
+        for (double kb : sizes_kb) {
+            TestValues point_values = values;
+            point_values.set("size_kb", kb);
+            const auto trials = runTrials(num_threads, [&](unsigned i) {
+                return kernel.make(point_values, {i, num_threads, i});
+            }, point_budget, trial_plan);
+            if (trials.empty()) break;
+            const std::vector<double> scores = threadRates(trials);
+            const TrialStats stats = summarize(trialRates(trials), trial_plan.max_cv);
+            const ThermalSummary thermal = testThermal(trials);
+            const TestClock clock = testClock(trials, thermal);
+            const TestRecord record{latency.logName(point_values),
+                                    runParams({{"iterations", TestValues::text(values.get("iterations"))},
+                                               {"size_kb", TestValues::text(kb)}}),
+                                    Topology::getInstance().describe(placement, num_threads), scores,
+                                    threadTrialRates(trials), threadCosts(trials), threadCounters(trials),
+                                    testTopDown(trials), stats, median(scores), testEnergy(trials), thermal,
+                                    testTruncated(trials, trial_plan), latency.unit, kernel.name, clock.ghz,
+                                    clock.source};
+            countOutcome(record.scores, stats, thermal);
+            ResultStore::getInstance().logTestResult(record);
+            logTimeseries(record.test, trials);
+            last_results.emplace_back(record.test + " " + formatBytes(kb * 1024),
+                                      stats.mean * static_cast<double>(scores.size()));
+            points.push_back({kb * 1024, meanCost(record.costs), clock, stats, record.truncated,
+                              compareToBaseline(record)});
+            if (Cancellation::requested()) break;
+        }
+        spinner.stop();
+
+        const auto cycles = [](const Point& p) { return p.clock.ghz > 0 ? p.cost.ns * p.clock.ghz : p.cost.cycles; };
+        const std::vector<Topology::Cache>& caches = Topology::getInstance().caches();
+        // Innermost level that holds the working set
+        const auto level = [&](double bytes) -> std::string {
+            for (const Topology::Cache& c : caches) {
+                if (bytes <= static_cast<double>(c.bytes)) return "L" + std::to_string(c.level);
+            }
+            return caches.empty() ? "" : "DRAM";
+        };
 
-    static void pinThread(int core) {
-        cpu_set_t cpuset;
-        CPU_ZERO(&cpuset);
-        int target_core = core % std::thread::hardware_concurrency();
-        CPU_SET(target_core, &cpuset);
-        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+        if (points.size() < sizes_kb.size()) {
+            std::cout << "\nLatency sweep interrupted, " << points.size() << " of " << sizes_kb.size() << " sizes measured\n";
+        }
+        std::cout << "\n===== " << latency.score << " =====\n";
+        if (!caches.empty()) {
+            std::cout << "Caches:";
+            for (const Topology::Cache& c : caches) {
+                std::cout << " L" << c.level << " " << formatBytes(static_cast<double>(c.bytes))
+                          << (&c == &caches.back() ? "\n" : " |");
+            }
+        }
+        std::cout << "Working set    ns/load   cyc/load\n";
+        for (const Point& p : points) {
+            char buf[96];
+            std::snprintf(buf, sizeof(buf), "%11s %10.2f %10.1f   %s%s", formatBytes(p.bytes).c_str(), p.cost.ns, cycles(p),
+                          level(p.bytes).c_str(), p.stats.stable || p.stats.kept.size() < 2 ? "" : " (unstable)");
+            std::cout << buf << "\n";
+            printTruncated(p.truncated, p.stats, "  ");
+            printComparison(p.comparisons, latency.unit, "  ");
+        }
+        // A level's plateau: the sizes well inside it, a factor of two away
+        // from both its own capacity and the one below
+        if (!caches.empty() && !points.empty()) {
+            std::string plateaus;
+            double below = 0;
+            for (size_t i = 0; i <= caches.size(); ++i) {
+                const double above = i < caches.size() ? static_cast<double>(caches[i].bytes) / 2 : HUGE_VAL;
+                std::vector<double> ns, cyc;
+                for (const Point& p : points) {
+                    if (p.bytes <= 2 * below || p.bytes > above) continue;
+                    ns.push_back(p.cost.ns);
+                    cyc.push_back(cycles(p));
+                }
+                if (!ns.empty()) {
+                    char buf[64];
+                    std::snprintf(buf, sizeof(buf), "%s %.1f ns (%.0f cyc)",
+                                  i < caches.size() ? ("L" + std::to_string(caches[i].level)).c_str() : "DRAM",
+                                  median(ns), median(cyc));
+                    plateaus += (plateaus.empty() ? " " : " | ") + std::string(buf);
+                }
+                below = i < caches.size() ? static_cast<double>(caches[i].bytes) : below;
+            }
+            if (!plateaus.empty()) std::cout << "Plateaus:" << plateaus << "\n";
+        }
+        if (!points.empty()) {
+            std::cout << formatClock(points.front().clock)
+                      << (points.front().clock.ghz > 0 ? "" : "; cyc/load is in TSC ticks") << "\n";
+        }
+        std::cout << std::string(latency.score.size() + 12, '=') << "\n";
+
+        stopMonitor();
     }
-    static void* allocate_huge_buffer(size_t size) {
-    #ifdef __linux__
-        void* ptr = mmap(nullptr, size, PROT_READ|PROT_WRITE,
-                        MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
-        if (ptr != MAP_FAILED) return ptr;
-    #endif
-        return aligned_alloc(1 << 21, size); // Fallback to 2MB aligned
+
+    // A key of one preset entry: its own section ([branch.gaming]), then the
+    // section of its test ([branch])
+    static std::optional<std::string> entryValue(const std::unordered_map<std::string, std::string>& config,
+                                                 const std::string& entry, const std::string& key) {
+        if (const auto it = config.find(entry + "." + key); it != config.end()) return it->second;
+        const std::string test = PresetSchema::testOf(entry);
+        if (test == entry) return std::nullopt;
+        if (const auto it = config.find(test + "." + key); it != config.end()) return it->second;
+        return std::nullopt;
     }
 
-    static void free_buffer(void* buf, size_t size) {
-    #ifdef __linux__
-        munmap(buf, size);
-    #else
-        free(buf);
-    #endif
+    // Every parameter set of a test. `lookup` gives a parameter's setting if
+    // there is one; a list or range in it ("1, 2, 4", "1..4") multiplies the sets.
+    static std::vector<TestValues> expandValues(const TestDescriptor& test,
+                                                const std::function<std::optional<std::string>(const TestParam&)>& lookup) {
+        std::vector<TestValues> sets(1);
+        for (const TestParam& p : test.params) {
+            std::vector<double> choices;
+            if (const auto setting = lookup(p)) {
+                for (const std::string& v : PresetSchema::values(*setting)) choices.push_back(std::strtod(v.c_str(), nullptr));
+            }
+            if (choices.empty()) choices.push_back(p.fallback);
+            std::vector<TestValues> expanded;
+            for (const TestValues& set : sets) {
+                for (double choice : choices) {
+                    expanded.push_back(set);
+                    expanded.back().set(p.name, choice);
+                }
+            }
+            sets = std::move(expanded);
+        }
+        return sets;
     }
 
-    static double memoryWorker(unsigned long iterations, const int thread_id) {
-        pinThread(thread_id);
-        const auto start = std::chrono::high_resolution_clock::now();
-        constexpr size_t size = 1 << 30; // 1GB
-        constexpr size_t buffer_size = size;
+    // Parameter sets of one preset entry: its section, the flat key, then the recommended value
+    static std::vector<TestValues> presetValues(const TestDescriptor& test, const std::string& entry,
+                                                const std::unordered_map<std::string, std::string>& config) {
+        return expandValues(test, [&](const TestParam& p) -> std::optional<std::string> {
+            if (auto value = entryValue(config, entry, p.name)) return value;
+            if (const auto it = config.find(p.key); it != config.end()) return it->second;
+            return std::nullopt;
+        });
+    }
 
-        // Allocate buffer once outside the loop
-        void* buffer = allocate_huge_buffer(size);
-        if (!buffer) {
-            std::cerr << "Failed to allocate memory buffer for thread " << thread_id << std::endl;
-            return 0.0;
+    // Kernel variants of one preset entry, best first. Without a `variant`
+    // key (or with "best") it is the one kernelFor picks, given as nullptr;
+    // "all" is every variant this CPU runs, and a list names them. A global
+    // list may name variants other tests have, those are passed over.
+    static std::vector<const KernelVariant*> entryVariants(const TestDescriptor& test, const std::string& entry,
+                                                           const std::unordered_map<std::string, std::string>& config) {
+        auto value = entryValue(config, entry, "variant");
+        if (!value) {
+            if (const auto it = config.find("variant"); it != config.end()) value = it->second;
         }
-
-        // Run the stress tests
-        for (unsigned long i = 0; i < iterations; ++i) {
-            floodL1L2(buffer, &iterations, buffer_size);
-            floodMemory(buffer, &iterations, buffer_size);
-            floodNt(buffer, &iterations, buffer_size);
-            rowhammerAttack(buffer, &iterations, buffer_size);
+        if (!value) return {nullptr};
+        const auto names = PresetSchema::values(*value);
+        std::vector<const KernelVariant*> out;
+        for (const KernelVariant& v : test.variants) {
+            const bool all = std::ranges::find(names, "all") != names.end() && CpuFeatures::getInstance().has(v.isa);
+            if (all || std::ranges::find(names, v.name) != names.end()) out.push_back(&v);
         }
-        free_buffer(buffer, size);
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return iterations / elapsed.count();
-
+        if (out.empty()) out.push_back(nullptr);
+        return out;
     }
 
-    static double sha256Worker(unsigned long iterations, const int thread_id) {
-        pinThread(thread_id);
-        const auto start = std::chrono::high_resolution_clock::now();
-        sha256(iterations);
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return iterations / elapsed.count();
-
+    // Variants of one parameter set side by side, so the clock each ISA level
+    // runs at sits next to what it scored; the last (most portable) variant
+    // is the reference the downclock is measured against
+    void printVariantSummary(const std::string& entry, const std::vector<std::pair<std::string, double>>& scores,
+                             const std::vector<TestClock>& clocks, const std::string& unit) const {
+        const size_t base = scores.size() - 1;
+        std::cout << "\nKernel variants of " << entry << ":\n";
+        for (size_t i = 0; i < scores.size(); ++i) {
+            std::cout << "  " << std::left << std::setw(10) << scores[i].first << std::right << " "
+                      << formatIPS(scores[i].second, unit) << " | ";
+            if (clocks[i].ghz > 0) {
+                std::cout << std::fixed << std::setprecision(2) << clocks[i].ghz << " GHz";
+                if (clocks[i].ratio() > 0) std::cout << " (" << clocks[i].ratio() << "x TSC)";
+                if (i != base && clocks[base].ghz > 0) {
+                    std::cout << std::showpos << std::setprecision(1) << " " << 100 * (clocks[i].ghz / clocks[base].ghz - 1)
+                              << "% vs " << scores[base].first << std::noshowpos;
+                }
+                std::cout.unsetf(std::ios::floatfield);
+            } else {
+                std::cout << "clock n/a";
+            }
+            std::cout << "\n";
+        }
     }
 
-    static double aesENCWorker(const long iterations, int tid, const int block_size) {
-        pinThread(tid);
-        const auto start = std::chrono::high_resolution_clock::now();
-        // Allocate aligned buffers
-        alignas(16) uint8_t key[32] = {0x01}; // All-zero key (worst-case)
-        alignas(16) uint8_t expanded_key[240]; // AES-256 expanded key
-        alignas(16) uint8_t plaintext[16] = {0};
-        alignas(16) uint8_t ciphertext[16];
-        const size_t BLOCKS = 1 << block_size;
-        auto buffer = std::make_unique<uint8_t[]>(BLOCKS * 16);
-        pcg32 gen(std::random_device{}());
-        std::uniform_int_distribution<uint8_t> dist(0, 255);
-        for (auto& v : key) v = dist(gen);
-        for (long i = 0; i < iterations; i++){
-            // Key expansion (stress FPU)
-            aes256Keygen(expanded_key, key);
-            // Encrypt individual blocks (stress latency)
-            for (size_t i = 0; i < BLOCKS; i++) {
-                aes128EncryptBlock(ciphertext, plaintext, key);
-                asm volatile("" : : "r"(ciphertext) : "memory");
+    // One preset entry: every swept combination of its parameters and each
+    // chosen kernel variant, `repeat` times each
+    bool runTest(const std::string& entry, const std::unordered_map<std::string, std::string>& config) {
+        const TestDescriptor* test = TestRegistry::getInstance().find(PresetSchema::testOf(entry));
+        if (!test) return false;
+        const auto sets = presetValues(*test, entry, config);
+        const auto variants = entryVariants(*test, entry, config);
+        const auto repeat_value = entryValue(config, entry, "repeat");
+        const unsigned repeat = std::max(1u, repeat_value ? parseValue(*repeat_value, 1u)
+                                                          : getConfigValue(config, "repeat", 1u));
+        for (const TestValues& values : sets) {
+            for (unsigned r = 1; r <= repeat; ++r) {
+                std::vector<std::pair<std::string, double>> variant_scores;
+                std::vector<TestClock> variant_clocks;
+                for (const KernelVariant* variant : variants) {
+                    if (Cancellation::requested() || ThermalWatch::tripped()) return true;
+                    if (sets.size() > 1 || repeat > 1 || variants.size() > 1) {
+                        std::cout << "\n--- " << entry;
+                        if (sets.size() > 1) {
+                            for (const auto& [name, value] : values.all()) std::cout << " " << name << "=" << TestValues::text(value);
+                        }
+                        if (variants.size() > 1) std::cout << " variant=" << variant->name;
+                        if (repeat > 1) std::cout << " (repeat " << r << " of " << repeat << ")";
+                        std::cout << " ---\n";
+                    }
+                    const size_t reported = last_results.size();
+                    runRegistered(*test, values, variant);
+                    if (variant && last_results.size() > reported) {
+                        variant_scores.emplace_back(variant->name, last_results.back().second);
+                        variant_clocks.push_back(last_clock);
+                    }
+                }
+                if (variant_scores.size() > 1) printVariantSummary(entry, variant_scores, variant_clocks, test->unit);
             }
-            // XTS mode (stress throughput)
-            uint8_t tweak[16] = {0};
-            aesXtsEncrypt(buffer.get(), buffer.get(), expanded_key, tweak, BLOCKS);
         }
-
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return iterations / elapsed.count();
+        return true;
     }
 
-    static double aesDECWorker(const long iterations, int tid, const int block_size) {
-        pinThread(tid);
-        const auto start = std::chrono::high_resolution_clock::now();
-        // Allocate aligned buffers
-        alignas(16) uint8_t key[32] = {0x01}; // All-zero key (worst-case)
-        alignas(16) uint8_t expanded_key[240]; // AES-256 expanded key
-        alignas(16) uint8_t ciphertext[16] = {0};
-        alignas(16) uint8_t plaintext[16];
-        const size_t BLOCKS = 1 << block_size;
-        auto buffer = std::make_unique<uint8_t[]>(BLOCKS * 16);
-        pcg32 gen(std::random_device{}());
-        std::uniform_int_distribution<uint8_t> dist(0, 255);
-        for (auto& v : key) v = dist(gen);
-
-        for (long i = 0; i < iterations; i++){
-            // Key expansion (stress FPU)
-            aes256Keygen(expanded_key, key);
-            // Decrypt individual blocks (stress latency)
-            for (size_t i = 0; i < BLOCKS; i++) {
-                aes128DecryptBlock(plaintext, ciphertext, key);
-                asm volatile("" : : "r"(plaintext) : "memory");
+    // Run settings of one preset entry ([avx] threads = 4, placement, duration,
+    // trials) on top of the preset's own, put back when the entry is done
+    class EntryScope {
+    public:
+        EntryScope(sift& app, const std::string& entry, const std::unordered_map<std::string, std::string>& config)
+            : app_(app), threads_(app.num_threads), placement_(app.placement), budget_(app.budget),
+              plan_(app.trial_plan) {
+            if (const auto value = entryValue(config, entry, "placement")) {
+                if (const auto p = parsePlacement(*value)) app.setPlacement(*p);
+            }
+            if (const auto value = entryValue(config, entry, "threads")) {
+                app.num_threads = std::clamp(parseValue(*value, threads_), 1u, WorkerPool::getInstance().size());
+            }
+            if (const auto value = entryValue(config, entry, "duration")) {
+                app.budget.seconds = parseValue(*value, budget_.seconds);
+            }
+            const auto trials = entryValue(config, entry, "trials");
+            const auto warmup = entryValue(config, entry, "warmup_trials");
+            if (trials || warmup) {
+                app.setTrials(trials ? parseValue(*trials, plan_.measured) : plan_.measured,
+                              warmup ? parseValue(*warmup, plan_.warmup) : plan_.warmup);
             }
-            // XTS mode decryption (stress throughput)
-            uint8_t tweak[16] = {0};
-            aesXtsDecrypt(buffer.get(), buffer.get(), expanded_key, tweak, BLOCKS);
         }
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return iterations / elapsed.count();
-    }
 
-    static double collatzWorker(unsigned long iterations, unsigned long lower, unsigned long upper, int tid) {
-        pinThread(tid);
-        pcg32 gen(42u + tid, 54u + tid);
-        std::uniform_int_distribution<unsigned long> dist(lower, upper);
+        ~EntryScope() {
+            if (app_.placement != placement_) app_.setPlacement(placement_);
+            app_.num_threads = threads_;
+            app_.budget = budget_;
+            app_.trial_plan = plan_;
+        }
 
-        const auto start = std::chrono::high_resolution_clock::now();
+        EntryScope(const EntryScope&) = delete;
+        EntryScope& operator=(const EntryScope&) = delete;
 
-        for (unsigned long i = 0; i < iterations; ) {
-            const unsigned long batch = std::min(static_cast<unsigned long>(COLLATZ_BATCH_SIZE), iterations - i);
+    private:
+        sift& app_;
+        const unsigned threads_;
+        const Placement placement_;
+        const Budget budget_;
+        const TrialPlan plan_;
+    };
 
-            for (unsigned long j = 0; j < batch; ++j) {
-                unsigned long steps = 0;
-                p3np1E(dist(gen), &steps);
+    // CPUs for one scenario group, taken from `free` (which is updated):
+    //   l3:N / node:N / cpus:LIST - that domain or list, minus CPUs already taken
+    //   N                         - the next N free CPUs in placement order
+    //   rest                      - every CPU still free
+    static std::vector<unsigned> claimCpus(const std::string& spec, std::vector<unsigned>& free) {
+        const Topology& topo = Topology::getInstance();
+        std::vector<unsigned> wanted;
+        const auto colon = spec.find(':');
+        const std::string kind = spec.substr(0, colon);
+        const std::string arg = colon == std::string::npos ? "" : spec.substr(colon + 1);
+        try {
+            if (kind == "rest") {
+                wanted = free;
+            } else if (kind == "l3") {
+                wanted = topo.l3Domain(std::stoul(arg));
+            } else if (kind == "node") {
+                wanted = topo.nodeCpus(std::stoul(arg));
+            } else if (kind == "cpus") {
+                wanted = Topology::parseList(arg);
+            } else {
+                const size_t count = std::min<size_t>(std::stoul(kind), free.size());
+                wanted.assign(free.begin(), free.begin() + static_cast<long>(count));
+            }
+        } catch (...) {
+            return {};
+        }
+        std::vector<unsigned> claimed;
+        for (unsigned cpu : wanted) {
+            if (const auto it = std::ranges::find(free, cpu); it != free.end()) {
+                claimed.push_back(cpu);
+                free.erase(it);
             }
-            i += batch;
         }
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return iterations / elapsed.count();  // Standard: iterations/second
+        return claimed;
     }
 
-    static double primesWorker(unsigned long iterations, unsigned long lower, unsigned long upper, int tid) {
-        pinThread(tid);
-        pcg32 gen(42u + tid, 54u + tid);
-        std::uniform_int_distribution<unsigned long> dist(lower, upper);
+    // Run several tests at the same time on disjoint CPU sets, e.g.
+    //   scenario = avx@l3:0, mem@l3:1, disk@2, lzma@rest
+    // All groups leave one start barrier together and run to a shared deadline,
+    // so the FPU, memory controller, crypto units and disk are loaded at once.
+    void runScenario(const std::unordered_map<std::string, std::string>& config) {
+        struct Group {
+            std::string test, spec;
+            std::vector<unsigned> cpus;
+            WorkloadFactory make;
+            unsigned offset = 0;
+            std::string unit;
+            std::string variant;
+        };
+
+        std::vector<unsigned> free = Topology::getInstance().order(placement);
+        std::vector<Group> groups;
+        std::vector<unsigned> layout;
+        std::stringstream ss(config.contains("scenario") ? config.at("scenario") : std::string());
+        std::string entry;
+        while (std::getline(ss, entry, ',')) {
+            std::erase_if(entry, ::isspace);
+            if (entry.empty()) continue;
+            const auto at = entry.find('@');
+            Group g;
+            g.test = entry.substr(0, at);
+            g.spec = at == std::string::npos ? "rest" : entry.substr(at + 1);
+            g.cpus = claimCpus(g.spec, free);
+            if (g.cpus.empty()) {
+                std::cout << "Scenario: no free CPUs for " << entry << ", skipping\n";
+                continue;
+            }
+            const TestDescriptor* test = TestRegistry::getInstance().find(g.test);
+            const KernelVariant* kernel = test ? kernelFor(*test) : nullptr;
+            if (!kernel) {
+                if (!test) std::cout << "Scenario: unknown test " << g.test << ", skipping\n";
+                free.insert(free.end(), g.cpus.begin(), g.cpus.end());
+                continue;
+            }
+            // A group runs one parameter set, the first if the preset sweeps
+            const TestValues values = presetValues(*test, g.test, config).front();
+            const unsigned threads = static_cast<unsigned>(g.cpus.size());
+            const unsigned offset = g.offset = static_cast<unsigned>(layout.size());
+            g.make = [kernel, values, threads, offset](unsigned i) { return kernel->make(values, {i, threads, offset + i}); };
+            g.unit = test->unit;
+            g.variant = kernel->name;
+            layout.insert(layout.end(), g.cpus.begin(), g.cpus.end());
+            groups.push_back(std::move(g));
+        }
+        if (groups.empty()) {
+            std::cout << "Scenario: nothing to run\n";
+            return;
+        }
+        if (layout.size() > WorkerPool::getInstance().size()) {
+            std::cout << "Scenario: more CPUs requested than pool workers, skipping\n";
+            return;
+        }
 
-        unsigned long total_steps = 0;
-        const auto start = std::chrono::high_resolution_clock::now();
+        // Groups finish at different times in iteration mode, which would defeat
+        // the point; scenarios always run to a common deadline.
+        const Budget scenario_budget{budget.timed() ? budget.seconds
+                                                    : getConfigValue(config, "scenario_duration", 60.0)};
 
-        for (unsigned long i = 0; i < iterations; ) {
-            const unsigned long batch = std::min(static_cast<unsigned long>(COLLATZ_BATCH_SIZE), iterations - i);
-            unsigned long batch_steps = 0;
+        std::cout << "\n🔀 CONCURRENT SCENARIO (" << scenario_budget.seconds << " s)\n";
+        for (const auto& g : groups) {
+            std::cout << "  " << g.test << " @ " << g.spec << ": CPUs ";
+            for (size_t i = 0; i < g.cpus.size(); ++i) std::cout << (i ? "," : "") << g.cpus[i];
+            std::cout << "\n";
+        }
 
-            for (unsigned long j = 0; j < batch; ++j) {
-                unsigned long steps = 0;
-                primes(dist(gen), &steps);
-                batch_steps += steps;
+        WorkerPool::getInstance().setAffinity(layout);
+        Spinner spinner("🔀 Running concurrent scenario...");
+        startMonitor();
+        const auto trials = runTrials(static_cast<unsigned>(layout.size()), [&groups](unsigned tid) {
+            for (const auto& g : groups) {
+                if (tid < g.offset + g.cpus.size()) return g.make(tid - g.offset);
             }
+            return std::unique_ptr<Workload>();
+        }, scenario_budget, trial_plan);
+        spinner.stop();
+        stopMonitor();
+        WorkerPool::getInstance().setAffinity(Topology::getInstance().order(placement));
+        if (trials.empty()) {
+            std::cout << "Scenario interrupted before the first measured trial, nothing recorded\n";
+            return;
+        }
 
-            total_steps += batch_steps;
-            i += batch;
+        for (const auto& g : groups) {
+            std::vector<std::vector<Sample>> group_trials;
+            for (const auto& trial : trials) {
+                group_trials.emplace_back(trial.begin() + g.offset, trial.begin() + g.offset + g.cpus.size());
+            }
+            reportScores("SCENARIO: " + g.test + " @ " + g.spec, "Scenario_" + g.test, group_trials,
+                         {{"group", g.spec}, {"scenario_duration", ResultStore::param(scenario_budget.seconds)}}, g.unit, g.variant);
         }
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return iterations / elapsed.count();  // it/s
     }
 
-    static double avxWorker(const unsigned long iterations, const float lower, const float upper, int tid) {
-        pinThread(tid);
-        pcg32 gen(42u + tid, 54u + tid);
-        std::uniform_real_distribution<float> dist(lower, upper);
-
-        alignas(32) float n1[AVX_BUFFER_SIZE], n2[AVX_BUFFER_SIZE], n3[AVX_BUFFER_SIZE];
-
-        const auto start = std::chrono::high_resolution_clock::now();
-
-        for (unsigned long i = 0; i < iterations; ++i) {
-            for (int j = 0; j < AVX_BUFFER_SIZE; ++j) {
-                n1[j] = dist(gen);
-                n2[j] = dist(gen);
-                n3[j] = dist(gen);
+    // Run one test at increasing thread counts under the current placement.
+    // "sweep = all" steps through every count, anything else doubles (1, 2, 4 ... N).
+    void runSweep(const std::string& test, const std::unordered_map<std::string, std::string>& config) {
+        const unsigned max_threads = num_threads;
+        const bool every = getConfigValue(config, "sweep", std::string("pow2")) == "all";
+        std::vector<unsigned> steps;
+        for (unsigned n = 1; n < max_threads; n = every ? n + 1 : n * 2) steps.push_back(n);
+        steps.push_back(max_threads);
+
+        // points[score name][step] = aggregate throughput
+        std::vector<std::pair<std::string, std::vector<double>>> points;
+        for (size_t step = 0; step < steps.size(); ++step) {
+            if (Cancellation::requested()) {
+                // Points not reached would read as zero throughput
+                steps.resize(step);
+                for (auto& [name, values] : points) values.resize(step);
+                break;
             }
-
-            for (int offset = 0; offset < AVX_BUFFER_SIZE; offset += 8) {
-                avx(n1+offset, n2+offset, n3+offset);
+            num_threads = steps[step];
+            std::cout << "\n--- " << test << " @ " << num_threads << " thread(s) ---\n";
+            // Only this step's scores; earlier ones stay for runPreset's "nothing ran" check
+            const size_t before = last_results.size();
+            if (!runTest(test, config)) {
+                std::cout << "Unknown test: " << test << "\n";
+                num_threads = max_threads;
+                return;
+            }
+            const std::vector<std::pair<std::string, double>> step_results(last_results.begin() + before,
+                                                                           last_results.end());
+            for (const auto& [name, value] : step_results) {
+                auto it = std::ranges::find(points, name, &std::pair<std::string, std::vector<double>>::first);
+                if (it == points.end()) {
+                    points.emplace_back(name, std::vector<double>(steps.size(), 0.0));
+                    it = points.end() - 1;
+                }
+                it->second[step] = value;
             }
         }
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return iterations / elapsed.count();  // Standard: iterations/second
-    }
-    static double diskWriteWorker(unsigned long iterations, int tid){
-        pinThread(tid);
-        const auto start = std::chrono::high_resolution_clock::now();
-        std::string filename = "/tmp/writeTestThread" + std::to_string(tid) + ".bin";
-        for (int i = 0; i < iterations; ++i) {
-            diskWrite(filename.c_str());
+        num_threads = max_threads;
+        if (steps.empty()) return;
+
+        const std::string layout = placementName(placement);
+        const std::string unit = TestRegistry::getInstance().find(PresetSchema::testOf(test))->unit;
+        for (const auto& [name, values] : points) {
+            reportSweep(name, steps, values, layout, unit);
         }
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return iterations / elapsed.count();  // Standard: iterations/second
     }
 
-    static double renderWorker(int width, int height, int sample_multiplier, int tid) {
-        pinThread(tid);
-        const auto start = std::chrono::high_resolution_clock::now();
-        
-        // Create scene data (16 spheres)
-        alignas(16) float scene[64]; // 16 spheres * 4 floats (x,y,z,radius)
-        pcg32 gen(42u + tid, 54u + tid);
-        std::uniform_real_distribution<float> pos_dist(-10.0f, 10.0f);
-        std::uniform_real_distribution<float> rad_dist(0.5f, 2.0f);
-        
-        for (int i = 0; i < 16; ++i) {
-            scene[i*4 + 0] = pos_dist(gen);     // x
-            scene[i*4 + 1] = pos_dist(gen);     // y  
-            scene[i*4 + 2] = pos_dist(gen);     // z
-            scene[i*4 + 3] = rad_dist(gen);     // radius
+    // Scaling flattens once adding threads buys less than half of the ideal
+    // linear gain (measured against the 1-thread throughput).
+    void reportSweep(const std::string& name, const std::vector<unsigned>& steps,
+                     const std::vector<double>& throughput, const std::string& layout,
+                     const std::string& unit) const {
+        const double base = throughput.front();
+        std::optional<unsigned> knee;
+        for (size_t i = 1; i < steps.size() && base > 0 && !knee; ++i) {
+            const double gain = (throughput[i] - throughput[i - 1]) / (base * (steps[i] - steps[i - 1]));
+            if (gain < 0.5) knee = steps[i - 1];
         }
-        
-        // Calculate pixels per thread
-        const int total_pixels = width * height;
-        const int pixels_per_thread = total_pixels / std::thread::hardware_concurrency();
-        const int start_pixel = tid * pixels_per_thread;
-        const int end_pixel = (tid == std::thread::hardware_concurrency() - 1) ?
-                       total_pixels : start_pixel + pixels_per_thread;
-        
-        alignas(16) float pixel_output;
-        long pixels_rendered = 0;
 
-        double total_iterations = (end_pixel - start_pixel) * sample_multiplier;
-        renderPixel(total_iterations, tid, &pixel_output);
-        pixels_rendered = total_iterations;
-        
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return pixels_rendered / elapsed.count(); // Pixels per second
+        const std::string header = "====== SCALING: " + name + " (" + layout + ") ======";
+        std::cout << "\n" << header << "\n";
+        std::cout << "Threads  Throughput          Speedup  Efficiency\n";
+        for (size_t i = 0; i < steps.size(); ++i) {
+            const double speedup = base > 0 ? throughput[i] / base : 0.0;
+            std::cout << std::left << std::setw(9) << steps[i] << std::setw(20) << formatIPS(throughput[i], unit)
+                      << std::right << std::fixed << std::setprecision(2) << std::setw(6) << speedup << "x"
+                      << std::setw(11) << std::setprecision(1) << speedup / steps[i] * 100 << "%\n";
+        }
+        std::cout.unsetf(std::ios::floatfield);
+        if (knee) {
+            std::cout << "Scaling flattens after " << *knee << " thread(s)\n";
+        } else {
+            std::cout << "Scaling holds up to " << steps.back() << " thread(s)\n";
+        }
+        std::cout << std::string(header.size(), '=') << "\n";
+
+        ResultStore::getInstance().logSweepResult(name, layout, steps, throughput, knee.value_or(0));
     }
 
-    static double branchWorker(unsigned long iterations, int pattern_type, int tid) {
-        pinThread(tid);
-        const auto start = std::chrono::high_resolution_clock::now();
+    static void showRecommendations() {
+        std::cout << "\n======= RECOMMENDED ITERATIONS =======\n";
+        std::cout << "For accurate and consistent results:\n";
 
-        branchTorture(iterations, pattern_type);
-        
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return iterations / elapsed.count();
+        std::string category;
+        for (const TestDescriptor& test : TestRegistry::getInstance().all()) {
+            if (test.category != category) {
+                category = test.category;
+                std::cout << "\n" << category << ":\n";
+            }
+            std::string line;
+            for (const TestParam& p : test.params) {
+                if (p.prompt.empty()) continue;
+                line += (line.empty() ? "" : ", ") + p.name + " " + TestValues::text(p.fallback);
+            }
+            std::cout << "  " << std::left << std::setw(8) << test.name << ": " << line << "\n";
+        }
+        std::cout << "\n";
+
+        std::cout << "💡 NOTES:\n";
+        std::cout << "  - These values provide ~30-60 second test duration\n";
+        std::cout << "  - Adjust based on your CPU speed if needed\n";
+        std::cout << "  - Use 'full' command with intensity 1 for all tests\n";
+        std::cout << "  - Or skip iteration counts: ./sift --duration 30 runs every\n";
+        std::cout << "    test for 30 s with self-calibrated kernel chunks\n";
+        std::cout << "=======================================\n\n";
     }
 
-    static std::array<double, 4> cacheWorker(unsigned long iterations, int tid) {
-        pinThread(tid);
-        
-        // Allocate buffers for different cache levels
-        constexpr size_t L1_SIZE = 32 * 1024;      // 32KB
-        constexpr size_t L2_SIZE = 512 * 1024;     // 512KB  
-        constexpr size_t L3_SIZE = 8 * 1024 * 1024; // 8MB
-        constexpr size_t MEM_SIZE = 64 * 1024 * 1024; // 64MB
-        
-        void* l1_buffer = aligned_alloc(64, L1_SIZE);
-        void* l2_buffer = aligned_alloc(64, L2_SIZE);
-        void* l3_buffer = aligned_alloc(64, L3_SIZE);
-        void* mem_buffer = aligned_alloc(64, MEM_SIZE);
-        
-        std::array<double, 4> results{};
-        
-        // L1 Cache Test
-        auto start = std::chrono::high_resolution_clock::now();
-        cacheL1Test(iterations, l1_buffer);
-        auto end = std::chrono::high_resolution_clock::now();
-        auto elapsed = std::chrono::duration<double>(end - start);
-        results[0] = iterations / elapsed.count();
-        
-        // L2 Cache Test
-        start = std::chrono::high_resolution_clock::now();
-        cacheL2Test(iterations, l2_buffer);
-        end = std::chrono::high_resolution_clock::now();
-        elapsed = std::chrono::duration<double>(end - start);
-        results[1] = iterations / elapsed.count();
-        
-        // L3 Cache Test
-        start = std::chrono::high_resolution_clock::now();
-        cacheL3Test(iterations, l3_buffer);
-        end = std::chrono::high_resolution_clock::now();
-        elapsed = std::chrono::duration<double>(end - start);
-        results[2] = iterations / elapsed.count();
-        
-        // Memory Latency Test
-        start = std::chrono::high_resolution_clock::now();
-        memoryLatencyTest(iterations, mem_buffer, MEM_SIZE);
-        end = std::chrono::high_resolution_clock::now();
-        elapsed = std::chrono::duration<double>(end - start);
-        results[3] = iterations / elapsed.count();
-        
-        // Cleanup
-        free(l1_buffer);
-        free(l2_buffer);
-        free(l3_buffer);
-        free(mem_buffer);
-        
-        return results;
+    // Every registered test in menu order with its recommended values, the
+    // scaling ones times `intensity`
+    void nuclearOption() {
+        unsigned long intensity = 1;
+        std::cout << "Intensity (1 = default): ";
+        std::cin >> intensity;
+        std::cout << "Launching full stress test...\n";
+        const auto start = std::chrono::high_resolution_clock::now();
+        const Cancellation::Scope cancellable; // also covers the gaps between tests
+        startMonitor();
+        for (const TestDescriptor& test : TestRegistry::getInstance().all()) {
+            const auto sets = expandValues(test, [&](const TestParam& p) -> std::optional<std::string> {
+                if (!p.full.empty()) return p.full;
+                return TestValues::text(p.scales ? p.fallback * static_cast<double>(intensity) : p.fallback);
+            });
+            for (const TestValues& values : sets) {
+                if (Cancellation::requested()) break;
+                runRegistered(test, values);
+            }
+            if (Cancellation::requested()) {
+                std::cout << "Interrupted, skipping the remaining tests\n";
+                break;
+            }
+        }
+        const auto duration = std::chrono::high_resolution_clock::now() - start;
+        std::cout << "Full test complete! Time: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()
+                  << " ms\n";
+        stopMonitor();
     }
+
     template<typename T>
-    T getConfigValue(const std::unordered_map<std::string, std::string>& config, const std::string& key, T default_value) {
+    static T getConfigValue(const std::unordered_map<std::string, std::string>& config, const std::string& key, T default_value) {
         const auto it = config.find(key);
         if (it == config.end()) return default_value;
-        
-        std::stringstream ss(it->second);
+        return parseValue(it->second, default_value);
+    }
+
+    // A setting's text as T, default_value when it doesn't read as one;
+    // global keys and per-entry overrides both go through here
+    template<typename T>
+    static T parseValue(const std::string& text, T default_value) {
+        std::stringstream ss(text);
         T value;
         ss >> value;
         return ss.fail() ? default_value : value;
     }
 };
 
+static void printRunUsage(std::ostream& out) {
+    std::string tests, params, hazards;
+    for (const TestDescriptor& test : TestRegistry::getInstance().all()) {
+        tests += " " + test.name;
+        for (const TestParam& p : test.params) {
+            // A test's own time budget is --duration
+            if (!p.seconds && !params.contains("--" + p.name + " ")) params += "  --" + p.name + " " + (p.integer ? "N" : "X");
+        }
+        if (!test.hazard.empty() && !hazards.contains(test.hazard)) hazards += "  --allow-" + test.hazard;
+    }
+    out << "Usage: sift run <test>[,<test>...] [options]\n"
+           "Tests:" << tests << "\n"
+           "Test parameters (only for tests that take them; \"1,2,4\" or \"1..4\" sweeps):\n"
+        << params << "\n"
+           "Run options:\n"
+           "  --duration S  --trials N  --warmup N  --threads N  --placement P\n"
+           "  --disable-isa avx512f,sha   run the fallback kernels instead\n"
+           "  --variant all|NAME,...      run these kernel variants back to back (avx512,avx2-fma,sse)\n"
+        << hazards << "  --max-temp C  --monitor gui|quiet|off  --compare FILE\n"
+           "  --set key=value   any preset key, test.param for one test (avx.iterations=5)\n"
+           "Output:\n"
+           "  --format text|json|csv  --output FILE (default: stdout)\n"
+           "  --results FILE  --csv FILE  --timeseries\n"
+           "Exit status: 0 ok, 1 failed, 2 regressed, 3 unstable, 128+N interrupted by signal N\n";
+}
+
 int main(const int argc, char* argv[]) {
-    if (argc == 2) {
-        // Config file mode
-        std::string config_file = argv[1];
-        std::unordered_map<std::string, std::string> config;
-        
-        if (!ConfigParser::loadConfig(config_file, config)) {
-            std::cerr << "Error: Could not load config file: " << config_file << std::endl;
+    Cancellation::install();
+    sift app;
+    std::string config_file;
+    unsigned long trials = 1, warmup = 0;
+    std::string sweep_test, sweep_steps = "pow2", scenario;
+    std::optional<std::string> results_path, csv_path, compare_path, max_temp, monitor, telemetry_hz;
+    bool timeseries = false;
+    // "sift run <tests> [flags]": a preset built from argv that never prompts
+    std::string run_tests, format = "text", output = "-";
+    std::vector<std::pair<std::string, std::string>> run_params, settings; // --<param> value, --set key=value
+    int first = 1;
+    if (argc > 1 && std::string(argv[1]) == "run") {
+        if (argc < 3 || argv[2][0] == '-') {
+            printRunUsage(argc > 2 && std::string(argv[2]) == "--help" ? std::cout : std::cerr);
+            return argc > 2 && std::string(argv[2]) == "--help" ? 0 : 1;
+        }
+        run_tests = argv[2];
+        first = 3;
+    }
+    // A run setting's flag takes what its preset key does; false after printing why not
+    const auto valid = [](const std::string& flag, const std::string& key, const std::string& value) {
+        const auto error = PresetSchema::check(key, value);
+        if (!error) return true;
+        std::cerr << "Error: " << flag << error->substr(key.size()) << "\n";
+        printRunUsage(std::cerr);
+        return false;
+    };
+    for (int i = first; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--duration" && i + 1 < argc) {
+            if (!valid(arg, "duration", argv[++i])) return 1;
+            app.setDuration(std::stod(argv[i]));
+        } else if (arg == "--placement" && i + 1 < argc) {
+            const auto p = parsePlacement(argv[++i]);
+            if (!p) {
+                std::cerr << "Error: unknown placement '" << argv[i]
+                          << "' (linear, physical, smt, spread-l3, pack-ccx, pack-node)" << std::endl;
+                return 1;
+            }
+            app.setPlacement(*p);
+        } else if (arg == "--scenario" && i + 1 < argc) {
+            scenario = argv[++i];
+        } else if (arg == "--sweep" && i + 1 < argc) {
+            sweep_test = argv[++i];
+        } else if (arg == "--sweep-steps" && i + 1 < argc) {
+            sweep_steps = argv[++i];
+        } else if (arg == "--trials" && i + 1 < argc) {
+            if (!valid(arg, "trials", argv[++i])) return 1;
+            trials = std::stoul(argv[i]);
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            if (!valid(arg, "warmup_trials", argv[++i])) return 1;
+            warmup = std::stoul(argv[i]);
+        } else if (arg == "--results" && i + 1 < argc) {
+            results_path = argv[++i];
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (arg == "--compare" && i + 1 < argc) {
+            compare_path = argv[++i];
+        } else if (arg == "--timeseries") {
+            ResultStore::getInstance().setTimeseries(true);
+            timeseries = true;
+        } else if (arg == "--monitor" && i + 1 < argc) {
+            const auto m = sift::parseMonitor(argv[++i]);
+            if (!m) {
+                std::cerr << "Error: unknown monitor '" << argv[i] << "' (gui, quiet, off)" << std::endl;
+                return 1;
+            }
+            app.setMonitor(*m);
+            monitor = argv[i];
+        } else if (arg == "--telemetry-hz" && i + 1 < argc) {
+            if (!valid(arg, "telemetry_hz", argv[++i])) return 1;
+            telemetry_hz = argv[i];
+            Telemetry::getInstance().setRate(std::stod(*telemetry_hz));
+        } else if (arg == "--disable-isa" && i + 1 < argc) {
+            const auto mask = parseIsa(argv[++i]);
+            if (!mask) {
+                std::cerr << "Error: --disable-isa: unknown instruction set in '" << argv[i] << "'" << std::endl;
+                return 1;
+            }
+            CpuFeatures::getInstance().disable(*mask);
+        } else if (arg == "--max-temp" && i + 1 < argc) {
+            if (!valid(arg, "max_temp", argv[++i])) return 1;
+            max_temp = argv[i];
+            ThermalWatch::setCeiling(std::stod(*max_temp));
+        } else if (arg == "--variant" && i + 1 < argc) {
+            if (const auto error = PresetSchema::check("variant", argv[++i])) {
+                std::cerr << "Error: --" << *error << std::endl;
+                return 1;
+            }
+            settings.emplace_back("variant", argv[i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            if (!valid(arg, "threads", argv[++i])) return 1;
+            settings.emplace_back("threads", argv[i]);
+        } else if (arg.starts_with("--allow-")) {
+            settings.emplace_back(arg.substr(8), "allow");
+        } else if (arg == "--set" && i + 1 < argc) {
+            const std::string kv = argv[++i];
+            const auto eq = kv.find('=');
+            if (eq == std::string::npos || eq == 0) {
+                std::cerr << "Error: --set expects key=value, got '" << kv << "'" << std::endl;
+                return 1;
+            }
+            if (const auto error = PresetSchema::check(kv.substr(0, eq), kv.substr(eq + 1))) {
+                std::cerr << "Error: --set " << *error << std::endl;
+                return 1;
+            }
+            settings.emplace_back(kv.substr(0, eq), kv.substr(eq + 1));
+        } else if (arg == "--format" && i + 1 < argc) {
+            format = argv[++i];
+            if (format != "text" && format != "json" && format != "csv") {
+                std::cerr << "Error: unknown format '" << format << "' (text, json, csv)" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg == "--help") {
+            printRunUsage(std::cout);
+            return 0;
+        } else if (!run_tests.empty() && arg.starts_with("--") && i + 1 < argc) {
+            run_params.emplace_back(arg.substr(2), argv[++i]);
+        } else if (!run_tests.empty()) {
+            std::cerr << "Error: unexpected argument '" << arg << "'\n";
+            printRunUsage(std::cerr);
             return 1;
+        } else {
+            config_file = arg;
         }
-        
-        std::cout << "Loading preset: " << config_file << std::endl;
-        sift().runPreset(config);
+    }
+
+    std::unordered_map<std::string, std::string> run_config;
+    if (!run_tests.empty()) {
+        run_config["test_order"] = run_tests;
+        const auto tests = ConfigParser::getTestOrder(run_config);
+        for (const auto& test : tests) {
+            if (const auto error = PresetSchema::checkTest(test)) {
+                std::cerr << "Error: " << *error << "\n";
+                printRunUsage(std::cerr);
+                return 1;
+            }
+        }
+        // A parameter goes to every listed test that takes it; at least one has to
+        for (const auto& [name, value] : run_params) {
+            bool used = false;
+            for (const auto& test : tests) {
+                if (const auto key = sift::paramKey(test, name)) {
+                    if (const auto error = PresetSchema::check(*key, value)) {
+                        std::cerr << "Error: --" << name << ": " << *error << std::endl;
+                        return 1;
+                    }
+                    run_config[*key] = value;
+                    used = true;
+                }
+            }
+            if (!used) {
+                std::cerr << "Error: no test in '" << run_tests << "' takes --" << name << std::endl;
+                return 1;
+            }
+        }
+        app.setInteractive(false);
+    }
+    app.setTrials(trials, warmup);
+    if (results_path) ResultStore::getInstance().setJsonlPath(*results_path);
+    if (csv_path) ResultStore::getInstance().setCsvPath(*csv_path);
+
+    if (!config_file.empty() || !sweep_test.empty() || !scenario.empty() || compare_path || !run_tests.empty()) {
+        // Config file mode; --sweep runs a one-test preset, with the file's parameters if given,
+        // and "sift run" one made from its arguments
+        std::unordered_map<std::string, std::string> config = run_config;
+        
+        std::string error;
+        if (!config_file.empty() && !ConfigParser::loadConfig(config_file, config, error)) {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+        if (compare_path && config_file.empty() && sweep_test.empty() && scenario.empty()) {
+            // Nothing else to run: repeat what the baseline ran
+            Baseline base;
+            if (!base.load(*compare_path, error)) {
+                std::cerr << "Error: " << error << std::endl;
+                return 1;
+            }
+            config = sift::presetFromBaseline(base);
+        }
+        if (compare_path) config["compare"] = *compare_path;
+        if (!sweep_test.empty()) {
+            config["test_order"] = sweep_test;
+            config["sweep"] = sweep_steps;
+        }
+        if (!scenario.empty()) {
+            config["scenario"] = scenario;
+            if (config_file.empty()) config.erase("test_order");
+        }
+        // Command line output paths win over the preset's
+        if (results_path) config["results"] = *results_path;
+        if (csv_path) config["results_csv"] = *csv_path;
+        if (max_temp) config["max_temp"] = *max_temp;
+        if (monitor) config["monitor"] = *monitor;
+        if (telemetry_hz) config["telemetry_hz"] = *telemetry_hz;
+        if (timeseries) config["timeseries"] = "on";
+        for (const auto& [key, value] : settings) config[key] = value;
+
+        // Machine-readable formats take stdout (or --output) to themselves;
+        // the human report then goes to stderr, or stays on stdout next to a file
+        ResultStore& store = ResultStore::getInstance();
+        std::streambuf* const stdout_buf = std::cout.rdbuf();
+        std::ostream stdout_stream(stdout_buf);
+        std::ofstream output_file;
+        if (output != "-") {
+            output_file.open(output);
+            if (!output_file.is_open()) {
+                std::cerr << "Error: cannot write " << output << std::endl;
+                return 1;
+            }
+        }
+        std::ostream& out = output_file.is_open() ? output_file : stdout_stream;
+        if (format == "text" && output_file.is_open()) {
+            std::cout.rdbuf(output_file.rdbuf());
+        } else if (format != "text") {
+            store.setMirror(&out, format == "csv");
+            if (!output_file.is_open()) std::cout.rdbuf(std::cerr.rdbuf());
+        }
+        // Spinner frames only make sense on a terminal
+        Spinner::setAnimated(isatty(std::cout.rdbuf() == stdout_buf ? STDOUT_FILENO : STDERR_FILENO) &&
+                             (format != "text" || !output_file.is_open()));
+
+        if (!config_file.empty()) std::cout << "Loading preset: " << config_file << std::endl;
+        app.runPreset(config);
+        store.flush();
+        store.setMirror(nullptr);
+        std::cout.rdbuf(stdout_buf);
+        return app.exitCode();
     } else {
         // Interactive mode
-        sift().init();
+        app.init();
     }
     return 0;
 }
@@ -129,7 +129,7 @@ private:
         const int duration = duration_o.value();
         if (duration_o.value() == 0) return;
 
-        startLZMA(duration);
+        startLZMA(duration, 0);
 
     }
 
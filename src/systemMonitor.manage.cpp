@@ -7,11 +7,14 @@
 #include <filesystem>
 #include <memory>
 #include <array>
+#include <algorithm>
 
 #include "imgui/imgui.h"
 #include "imgui/backends/imgui_impl_glfw.h"
 #include "imgui/backends/imgui_impl_opengl3.h"
 #include <GLFW/glfw3.h>
+#include "rapl.hpp"
+#include "telemetry.hpp"
 
 namespace esst {
 
@@ -23,22 +26,51 @@ struct Metrics {
     float ram_gb_total{0};
     int cpu_freq{0};
     int base_freq{0};
+    float package_watts{0};
     bool thermal_throttling{false};
 };
 
+// Structure of arrays: one ring per metric, and for the per-core metrics one
+// MAX_SAMPLES x cores block each, sample-major, so a heatmap column is one
+// contiguous run and the plots can take the scalar arrays as they are.
 struct History {
     static constexpr size_t MAX_SAMPLES = 120;
     std::array<float, MAX_SAMPLES> cpu_temp{};
     std::array<float, MAX_SAMPLES> cpu_usage{};
     std::array<float, MAX_SAMPLES> memory_usage{};
     std::array<int, MAX_SAMPLES> cpu_freq{};
+    std::array<float, MAX_SAMPLES> package_watts{};
     size_t index{0};
 
-    void push(float cpu_t, float cpu_u, float mem_u, int freq) {
+    size_t cores{0};
+    std::vector<float> core_usage; // [sample * cores + core]
+    std::vector<float> core_mhz;
+    std::vector<float> core_temp;
+    std::vector<float> core_rate;
+    size_t core_index{0};
+
+    void resize_cores(size_t n) {
+        cores = n;
+        core_usage.assign(MAX_SAMPLES * n, 0.0f);
+        core_mhz.assign(MAX_SAMPLES * n, 0.0f);
+        core_temp.assign(MAX_SAMPLES * n, 0.0f);
+        core_rate.assign(MAX_SAMPLES * n, 0.0f);
+        core_index = 0;
+    }
+
+    // Next per-core row to fill, one pointer per metric
+    std::array<float*, CoreRing::METRICS> next_core_row() {
+        const size_t at = core_index * cores;
+        core_index = (core_index + 1) % MAX_SAMPLES;
+        return {core_usage.data() + at, core_mhz.data() + at, core_temp.data() + at, core_rate.data() + at};
+    }
+
+    void push(float cpu_t, float cpu_u, float mem_u, int freq, float watts) {
         cpu_temp[index] = cpu_t;
         cpu_usage[index] = cpu_u;
         memory_usage[index] = mem_u;
         cpu_freq[index] = freq;
+        package_watts[index] = watts;
         index = (index + 1) % MAX_SAMPLES;
     }
 };
@@ -48,8 +80,10 @@ class Monitor {
     bool running_{false};
     Metrics metrics_;
     History history_;
-    std::string cpu_sensor_;
     std::string gpu_sensor_;
+    uint64_t seen_{0};       // ring samples already shown
+    uint64_t seen_cores_{0}; // per-core rows already in history_
+    int heatmap_metric_{CoreRing::USAGE};
 
     void setup_theme() {
         ImGuiIO& io = ImGui::GetIO();
@@ -142,91 +176,6 @@ class Monitor {
         style.TabRounding       = 4;
     }
 
-    std::string find_sensor(const std::string& pattern) {
-        try {
-            for (const auto& entry : std::filesystem::directory_iterator("/sys/class/hwmon")) {
-                auto name_path = entry.path() / "name";
-                std::ifstream file(name_path);
-                std::string name;
-                if (file >> name && name.find(pattern) != std::string::npos) {
-                    for (const auto& temp_file : std::filesystem::directory_iterator(entry.path())) {
-                        if (temp_file.path().filename().string().contains("temp1_input")) {
-                            return temp_file.path();
-                        }
-                    }
-                }
-            }
-        } catch (...) {}
-        return {};
-    }
-
-    float read_temp(const std::string& path) {
-        if (path.empty()) return 0;
-        std::ifstream file(path);
-        int temp;
-        return file >> temp ? temp / 1000.0f : 0;
-    }
-
-    float read_cpu_usage() {
-        static long last_idle{0}, last_total{0};
-        std::ifstream file("/proc/stat");
-        std::string line;
-        std::getline(file, line);
-
-        long user, nice, system, idle, iowait, irq, softirq, steal;
-        sscanf(line.c_str(), "cpu %ld %ld %ld %ld %ld %ld %ld %ld",
-               &user, &nice, &system, &idle, &iowait, &irq, &softirq, &steal);
-
-        long total = user + nice + system + idle + iowait + irq + softirq + steal;
-        long diff_total = total - last_total;
-        long diff_idle = idle - last_idle;
-
-        last_total = total;
-        last_idle = idle;
-
-        return diff_total > 0 ? 100.0f * (diff_total - diff_idle) / diff_total : 0;
-    }
-
-    void read_memory_info() {
-        std::ifstream file("/proc/meminfo");
-        std::string line;
-        long mem_total{0}, mem_available{0};
-
-        while (std::getline(file, line)) {
-            if (line.starts_with("MemTotal:")) {
-                sscanf(line.c_str(), "MemTotal: %ld", &mem_total);
-            } else if (line.starts_with("MemAvailable:")) {
-                sscanf(line.c_str(), "MemAvailable: %ld", &mem_available);
-            }
-        }
-
-        metrics_.ram_gb_total = mem_total / 1024.0f / 1024.0f;
-        metrics_.ram_gb_used = (mem_total - mem_available) / 1024.0f / 1024.0f;
-        metrics_.memory_usage = mem_total > 0 ? 100.0f * (mem_total - mem_available) / mem_total : 0;
-    }
-
-    int read_cpu_frequency() {
-        // Try scaling frequency first (more accurate)
-        std::ifstream file("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq");
-        if (file.is_open()) {
-            int freq_khz;
-            file >> freq_khz;
-            return freq_khz / 1000;
-        }
-        
-        // Fallback to /proc/cpuinfo
-        std::ifstream proc_file("/proc/cpuinfo");
-        std::string line;
-        while (std::getline(proc_file, line)) {
-            if (line.starts_with("cpu MHz")) {
-                float freq;
-                sscanf(line.c_str(), "cpu MHz : %f", &freq);
-                return static_cast<int>(freq);
-            }
-        }
-        return metrics_.base_freq; // Return base freq if can't read
-    }
-
     void get_base_frequency() {
         std::ifstream file("/sys/devices/system/cpu/cpu0/cpufreq/base_frequency");
         if (file.is_open()) {
@@ -238,15 +187,89 @@ class Monitor {
         }
     }
 
+    // The sampler thread does all the reading; a frame only picks up the
+    // newest ring entry and adds it to the plots when it is a new one
     void update_metrics() {
-        metrics_.cpu_temp = read_temp(cpu_sensor_);
-        metrics_.cpu_usage = read_cpu_usage();
-        read_memory_info();
-        metrics_.cpu_freq = read_cpu_frequency();
-        // Disable thermal throttling detection for now
-        metrics_.thermal_throttling = false;
-
-        history_.push(metrics_.cpu_temp, metrics_.cpu_usage, metrics_.memory_usage, metrics_.cpu_freq);
+        const Telemetry::Ring& ring = Telemetry::getInstance().ring();
+        const uint64_t count = ring.count();
+        if (count == seen_) return;
+        const auto sample = ring.latest();
+        if (!sample) return;
+        seen_ = count;
+
+        metrics_.cpu_temp = sample->cpu_temp;
+        metrics_.cpu_usage = sample->cpu_usage;
+        metrics_.memory_usage = sample->memory_usage;
+        metrics_.ram_gb_used = sample->ram_gb_used;
+        metrics_.ram_gb_total = sample->ram_gb_total;
+        metrics_.cpu_freq = sample->cpu_mhz ? sample->cpu_mhz : metrics_.base_freq;
+        metrics_.package_watts = sample->package_watts;
+        metrics_.thermal_throttling = sample->throttling;
+
+        history_.push(metrics_.cpu_temp, metrics_.cpu_usage, metrics_.memory_usage, metrics_.cpu_freq,
+                      metrics_.package_watts);
+
+        // Catch up on per-core rows; anything older than the history is skipped
+        const CoreRing& cores = Telemetry::getInstance().cores();
+        if (history_.cores != cores.width()) history_.resize_cores(cores.width());
+        const uint64_t rows = cores.count();
+        seen_cores_ = std::max(seen_cores_, rows - std::min<uint64_t>(rows, History::MAX_SAMPLES));
+        for (; seen_cores_ < rows; ++seen_cores_) {
+            const size_t before = history_.core_index;
+            if (!cores.read(seen_cores_, history_.next_core_row())) history_.core_index = before;
+        }
+    }
+
+    // Rows are CPUs in slot order, columns are samples, oldest on the left
+    void render_heatmap() {
+        if (history_.cores == 0) return;
+        ImGui::TextDisabled("PER-CORE");
+        ImGui::SameLine();
+        ImGui::RadioButton("USAGE", &heatmap_metric_, CoreRing::USAGE);
+        ImGui::SameLine();
+        ImGui::RadioButton("FREQ", &heatmap_metric_, CoreRing::MHZ);
+        ImGui::SameLine();
+        ImGui::RadioButton("TEMP", &heatmap_metric_, CoreRing::TEMP);
+        ImGui::SameLine();
+        ImGui::RadioButton("RATE", &heatmap_metric_, CoreRing::RATE);
+
+        const std::vector<float>& data = heatmap_metric_ == CoreRing::USAGE ? history_.core_usage
+                                       : heatmap_metric_ == CoreRing::MHZ ? history_.core_mhz
+                                       : heatmap_metric_ == CoreRing::TEMP ? history_.core_temp
+                                       : history_.core_rate;
+        float lo = 0, hi = 100; // usage
+        if (heatmap_metric_ == CoreRing::MHZ || heatmap_metric_ == CoreRing::RATE) {
+            hi = std::max(1.0f, *std::ranges::max_element(data));
+        } else if (heatmap_metric_ == CoreRing::TEMP) {
+            lo = 30;
+        }
+
+        const size_t cores = history_.cores;
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        const float width = ImGui::GetContentRegionAvail().x;
+        const float height = std::clamp(static_cast<float>(cores) * 3.0f, 60.0f, 192.0f);
+        const float cell_w = width / History::MAX_SAMPLES;
+        const float cell_h = height / static_cast<float>(cores);
+        ImDrawList* draw = ImGui::GetWindowDrawList();
+        for (size_t k = 0; k < History::MAX_SAMPLES; ++k) {
+            const float* column = data.data() + ((history_.core_index + k) % History::MAX_SAMPLES) * cores;
+            const float x = origin.x + static_cast<float>(k) * cell_w;
+            for (size_t c = 0; c < cores; ++c) {
+                const float t = std::clamp((column[c] - lo) / (hi - lo), 0.0f, 1.0f);
+                const float y = origin.y + static_cast<float>(c) * cell_h;
+                // blue (cold / idle) to red (hot / busy)
+                draw->AddRectFilled({x, y}, {x + cell_w + 0.5f, y + cell_h + 0.5f}, ImColor::HSV((1.0f - t) * 0.66f, 0.85f, 0.9f));
+            }
+        }
+        ImGui::Dummy({width, height});
+        if (ImGui::IsItemHovered()) {
+            const ImVec2 mouse = ImGui::GetIO().MousePos;
+            const size_t c = std::min(cores - 1, static_cast<size_t>((mouse.y - origin.y) / cell_h));
+            const size_t k = std::min(History::MAX_SAMPLES - 1, static_cast<size_t>((mouse.x - origin.x) / cell_w));
+            const float v = data[((history_.core_index + k) % History::MAX_SAMPLES) * cores + c];
+            const char* units[] = {"%", "MHz", "C", "it/s"};
+            ImGui::SetTooltip("CPU %u: %.1f %s", ThermalSensors::getInstance().cpus()[c], v, units[heatmap_metric_]);
+        }
     }
 
     void render_ui() {
@@ -269,6 +292,11 @@ class Monitor {
             ImGui::Text("%.0f°C", metrics_.cpu_temp);
             ImGui::Text("%.1f%%", metrics_.cpu_usage);
             ImGui::Text("%d MHz", metrics_.cpu_freq);
+            if (Rapl::getInstance().available()) {
+                ImGui::Text("%.1f W", metrics_.package_watts);
+            } else {
+                ImGui::TextDisabled("-- W");
+            }
 
             ImGui::TableNextColumn();
             ImGui::TextDisabled("MEMORY");
@@ -305,9 +333,16 @@ class Monitor {
         ImGui::PlotLines("CPU USAGE (%)", history_.cpu_usage.data(), History::MAX_SAMPLES,
                         history_.index, nullptr, 0, 100, {0, 80});
 
+        if (Rapl::getInstance().available()) {
+            ImGui::PlotLines("PACKAGE POWER (W)", history_.package_watts.data(), History::MAX_SAMPLES,
+                            history_.index, nullptr, 0, FLT_MAX, {0, 80});
+        }
+
         ImGui::PlotHistogram("MEMORY (%)", history_.memory_usage.data(), History::MAX_SAMPLES,
                             history_.index, nullptr, 0, 100, {0, 80});
 
+        render_heatmap();
+
         ImGui::Spacing();
         if (ImGui::Button("DISCONNECT NEXUS", {180, 30})) {
             running_ = false;
@@ -323,7 +358,7 @@ public:
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
 
-        window_ = glfwCreateWindow(480, 400, "NEXUS", nullptr, nullptr);
+        window_ = glfwCreateWindow(480, 700, "NEXUS", nullptr, nullptr);
         if (!window_) {
             glfwTerminate();
             return false;
@@ -340,7 +375,6 @@ public:
         ImGui_ImplGlfw_InitForOpenGL(window_, true);
         ImGui_ImplOpenGL3_Init("#version 330");
 
-        cpu_sensor_ = find_sensor("coretemp");
         get_base_frequency();
 
         return true;
@@ -349,9 +383,12 @@ public:
     void run() {
         if (!init()) return;
         running_ = true;
+        Telemetry::getInstance().start();
 
         while (running_ && !glfwWindowShouldClose(window_)) {
-            glfwPollEvents();
+            // Redraw on input or once per sampler interval at most; the old
+            // 15 ms busy redraw kept a core occupied during benchmarks
+            glfwWaitEventsTimeout(1.0 / Telemetry::getInstance().rate());
             update_metrics();
 
             ImGui_ImplOpenGL3_NewFrame();
@@ -371,10 +408,9 @@ public:
             glClear(GL_COLOR_BUFFER_BIT);
             ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
             glfwSwapBuffers(window_);
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(15)); // 10 FPS - smoother numbers
         }
 
+        Telemetry::getInstance().stop();
         cleanup();
     }
 
@@ -0,0 +1,11 @@
+#include "telemetry.hpp"
+
+// Headless counterpart of spawn_system_monitor(): the sampler thread alone,
+// no window. Safe to combine with the GUI monitor, which reads the same ring.
+extern "C" void spawn_system_monitor_quiet() {
+    Telemetry::getInstance().start();
+}
+
+extern "C" void stop_system_monitor_quiet() {
+    Telemetry::getInstance().stop();
+}